@@ -0,0 +1,808 @@
+document.addEventListener("DOMContentLoaded", () => {
+  const pwField = document.getElementById("PW");
+  const toggleBtn = document.getElementById("togglePW");
+  const eyeOpen = document.getElementById("eyeOpen");
+  const eyeClosed = document.getElementById("eyeClosed");
+
+  toggleBtn.addEventListener("click", () => {
+const isPassword = pwField.type === "password";
+pwField.type = isPassword ? "text" : "password";
+eyeOpen.style.display = isPassword ? "none" : "block";
+eyeClosed.style.display = isPassword ? "block" : "none";
+  });
+});
+
+
+
+let systemState = {
+  sensors: {
+    temperature: { current: null, previous: null, trend: 'stable' },
+    humidity: { current: null, previous: null, trend: 'stable' },
+    light: { current: null, previous: null, trend: 'stable' }
+  },
+  automation: {
+    temperature: false,
+    humidity: false,
+    light: false,
+    irrigation: false
+  },
+  thresholds: {
+    tempMin: 18,
+    tempMax: 28,
+    humidity: 70,
+    light: 1000
+  },
+  connection: {
+    status: 'connecting',
+    lastUpdate: null,
+    retryCount: 0
+  },
+  system: {
+    uptime: 0,
+    dataPoints: 0,
+    startTime: Date.now()
+  },
+  availableNetworks: [],
+  scanInProgress: false
+};
+
+let scanRetryCount = 0;
+const maxScanRetries = 3;
+const scanRetryDelay = 5000;
+
+function autoRetryScan() {
+  if (scanRetryCount < maxScanRetries && systemState.availableNetworks.length === 0 && !systemState.scanInProgress) {
+    scanRetryCount++;
+    console.log(`Auto-retrying scan (attempt ${scanRetryCount}/${maxScanRetries})`);
+    
+    showMessage(`Retrying network scan (${scanRetryCount}/${maxScanRetries})...`, "warning", "connectionMessage");
+    
+    setTimeout(() => {
+      if (!systemState.scanInProgress) {
+        scanWiFiNetworks();
+      }
+    }, scanRetryDelay);
+  } else if (scanRetryCount >= maxScanRetries) {
+    console.log('Max scan retries reached. Stopping auto-retry.');
+    showMessage("Unable to scan networks after multiple attempts. Please try manual scan.", "error", "connectionMessage");
+    
+    setTimeout(() => {
+      scanRetryCount = 0;
+      console.log('Scan retry count reset. Auto-retry available again.');
+    }, 30000);
+  }
+}
+
+function resetScanRetryCount() {
+  if (scanRetryCount > 0) {
+    console.log(`Scan successful! Reset retry count from ${scanRetryCount} to 0`);
+    scanRetryCount = 0;
+  }
+}
+
+document.addEventListener('DOMContentLoaded', function() {
+  console.log('Dashboard initializing...');
+  updateSystemStatus('connecting', 'Initializing system...');
+  
+  loadStoredSettings();
+  
+  // One request per refresh for sensors, WiFi status and system stats;
+  // system info is re-rendered every second from the last snapshot
+  setInterval(updateSnapshot, 3000);
+  setInterval(updateSystemInfo, 1000);
+  
+  updateSnapshot();
+  updateSystemInfo();
+  
+  setTimeout(() => {
+    scanWiFiNetworks();
+    setTimeout(() => {
+      autoRetryScan();
+    }, 10000);
+  }, 3000);
+});
+
+function scanWiFiNetworks() {
+  const scanBtn = document.getElementById('scanBtn');
+  const select = document.getElementById('wifiNetworkSelect');
+  
+  if (systemState.scanInProgress) {
+    console.log('Scan already in progress');
+    return;
+  }
+  
+  systemState.scanInProgress = true;
+  scanBtn.disabled = true;
+  scanBtn.innerHTML = '<div class="loading"></div> Starting Scan...';
+  
+  select.innerHTML = '<option value="">Starting network scan...</option>';
+  showMessage("Starting WiFi network scan...", "info", "connectionMessage");
+  
+  console.log('Starting async network scan...');
+  
+  fetch('/api/wifi/scan')
+    .then(response => {
+      console.log('Scan start response status:', response.status);
+      if (response.status === 202) {
+        scanBtn.innerHTML = '<div class="loading"></div> Scanning...';
+        select.innerHTML = '<option value="">Scanning for networks...</option>';
+        showMessage("Scanning in progress, please wait...", "info", "connectionMessage");
+        
+        pollScanResults();
+      } else if (response.status === 429) {
+        throw new Error('Please wait before scanning again');
+      } else if (!response.ok) {
+        throw new Error(`HTTP error! status: ${response.status}`);
+      } else {
+        return response.json();
+      }
+    })
+    .then(data => {
+      if (data) {
+        processScanResults(data);
+      }
+    })
+    .catch(error => {
+      console.error('Error starting WiFi scan:', error);
+      handleScanError(error.message);
+    });
+}
+
+function handleScanError(errorMessage) {
+  systemState.scanInProgress = false;
+  const scanBtn = document.getElementById('scanBtn');
+  const select = document.getElementById('wifiNetworkSelect');
+  
+  scanBtn.disabled = false;
+  scanBtn.innerHTML = ' Scan Networks';
+  
+  select.innerHTML = '<option value="">Error starting scan - Click to retry...</option>';
+  showMessage("Scan error: " + errorMessage, "error", "connectionMessage");
+  
+  setTimeout(() => {
+    autoRetryScan();
+  }, 3000);
+}
+
+function pollScanResults() {
+  const maxAttempts = 25;
+  let attempts = 0;
+  
+  const checkResults = () => {
+    attempts++;
+    console.log(`Checking scan results, attempt ${attempts}/${maxAttempts}`);
+    
+    fetch('/api/wifi/scan/results')
+      .then(response => {
+        if (response.status === 202) {
+          if (attempts < maxAttempts) {
+            setTimeout(checkResults, 1000);
+          } else {
+            throw new Error('Scan timeout - taking too long (watchdog protection)');
+          }
+        } else if (response.ok) {
+          return response.json();
+        } else {
+          throw new Error(`HTTP error! status: ${response.status}`);
+        }
+      })
+      .then(data => {
+        if (data) {
+          processScanResults(data);
+        }
+      })
+      .catch(error => {
+        console.error('Error getting scan results:', error);
+        handleScanError(error.message);
+      });
+  };
+  
+  setTimeout(checkResults, 2000);
+}
+
+function processScanResults(data) {
+  const scanBtn = document.getElementById('scanBtn');
+  const select = document.getElementById('wifiNetworkSelect');
+  
+  systemState.scanInProgress = false;
+  scanBtn.disabled = false;
+  scanBtn.innerHTML = ' Scan Networks';
+  
+  console.log('Processing scan results:', data);
+  
+  if (data.status === 'success' && data.networks && Array.isArray(data.networks)) {
+    systemState.availableNetworks = data.networks;
+    updateNetworkDropdown();
+    
+    const networkCount = data.networks.length;
+    document.getElementById('networkCount').textContent = networkCount;
+    showMessage(`Found ${networkCount} network(s)`, "success", "connectionMessage");
+    console.log(`Successfully found ${networkCount} networks`);
+    
+    resetScanRetryCount();
+    
+  } else if (data.status === 'success' && data.count === 0) {
+    console.log('No networks found');
+    systemState.availableNetworks = [];
+    updateNetworkDropdown();
+    showMessage("No networks found in range", "warning", "connectionMessage");
+    
+    setTimeout(() => {
+      autoRetryScan();
+    }, 3000);
+    
+  } else if (data.status === 'error') {
+    console.log('Scan failed with error:', data);
+    systemState.availableNetworks = [];
+    updateNetworkDropdown();
+    const errorMsg = data.message || "Scan failed - possible watchdog timeout";
+    showMessage(errorMsg, "error", "connectionMessage");
+    
+    setTimeout(() => {
+      autoRetryScan();
+    }, 3000);
+    
+  } else {
+    console.log('Invalid scan response:', data);
+    systemState.availableNetworks = [];
+    updateNetworkDropdown();
+    showMessage("Invalid scan response received", "error", "connectionMessage");
+    
+    setTimeout(() => {
+      autoRetryScan();
+    }, 3000);
+  }
+}
+
+function updateNetworkDropdown() {
+  const select = document.getElementById('wifiNetworkSelect');
+  
+  console.log('Updating network dropdown with', systemState.availableNetworks.length, 'networks');
+  
+  select.innerHTML = '';
+  
+  const defaultOption = document.createElement('option');
+  defaultOption.value = '';
+  defaultOption.textContent = 'Select a network...';
+  select.appendChild(defaultOption);
+  
+  if (systemState.availableNetworks.length === 0) {
+    const noNetworkOption = document.createElement('option');
+    noNetworkOption.value = '';
+    noNetworkOption.textContent = 'No networks found - Click scan to refresh';
+    noNetworkOption.disabled = true;
+    select.appendChild(noNetworkOption);
+    return;
+  }
+  
+  const sortedNetworks = [...systemState.availableNetworks].sort((a, b) => b.rssi - a.rssi);
+  
+  sortedNetworks.forEach((network, index) => {
+    if (network.ssid && network.ssid.trim() !== '') {
+      const option = document.createElement('option');
+      option.value = network.ssid;
+      
+      const signalStrength = getSignalStrengthText(network.rssi);
+      const securityIcon = network.encryption === 'Open' ? '' : '';
+      
+  
+
+    const ssidWidth = 20;
+    const rssiWidth = 5;
+
+    const ssidPadded = network.ssid.padEnd(ssidWidth, ' ');
+    const rssiPadded = String(signalStrength).padStart(rssiWidth, ' ');
+
+    option.textContent = `${ssidPadded} ${securityIcon} (${rssiPadded})`;
+      
+
+      option.dataset.rssi = network.rssi;
+      option.dataset.encryption = network.encryption;
+      option.dataset.encrypted = network.encrypted;
+      
+      select.appendChild(option);
+      
+      console.log(`Added network ${index + 1}: ${network.ssid} (${signalStrength}, ${network.encryption})`);
+    }
+  });
+  
+  console.log(`Dropdown updated with ${select.options.length - 1} networks`);
+}
+
+function getSignalStrengthText(rssi) {
+  if (rssi >= -50) return 'Excellent';
+  if (rssi >= -60) return 'Very Good';
+  if (rssi >= -70) return 'Good';
+  if (rssi >= -80) return 'Fair';
+  return 'Weak';
+}
+
+function connectToWiFi() {
+  const selectedNetwork = document.getElementById("wifiNetworkSelect").value.trim();
+  const password = document.getElementById("PW").value.trim();
+  const connectBtn = document.getElementById("connectBtn");
+  
+  if (!selectedNetwork) {
+    showMessage("Please select a WiFi network from the dropdown", "error", "connectionMessage");
+    return;
+  }
+  
+  console.log('Attempting to connect to:', selectedNetwork);
+  
+  const selectedOption = document.getElementById("wifiNetworkSelect").selectedOptions[0];
+  const isOpenNetwork = selectedOption && selectedOption.dataset.encrypted === 'false';
+  
+  console.log('Network is open:', isOpenNetwork);
+  
+  if (!isOpenNetwork && !password) {
+    showMessage("Please enter the WiFi password", "error", "connectionMessage");
+    return;
+  }
+  
+  connectBtn.disabled = true;
+  connectBtn.innerHTML = '<div class="loading"></div> Connecting...';
+  showMessage(`Connecting to ${selectedNetwork}...`, "info", "connectionMessage");
+  updateSystemStatus('connecting', `Connecting to ${selectedNetwork}...`);
+  
+  const data = { 
+    ssid: selectedNetwork, 
+    password: isOpenNetwork ? "" : password 
+  };
+  
+  console.log('Sending connection request:', { ssid: selectedNetwork, password: isOpenNetwork ? "[OPEN]" : "[HIDDEN]" });
+  
+  fetch('/api/wifi/connect', {
+    method: 'POST',
+    headers: { 'Content-Type': 'application/json' },
+    body: JSON.stringify(data)
+  })
+  .then(response => {
+    console.log('Connection response status:', response.status);
+    if (!response.ok) {
+      throw new Error(`HTTP error! status: ${response.status}`);
+    }
+    return response.json();
+  })
+  .then(result => {
+    console.log('Connection result:', result);
+    showMessage(result.message, "info", "connectionMessage");
+    
+    setTimeout(() => {
+      updateSnapshot();
+      connectBtn.disabled = false;
+      connectBtn.textContent = "Connect Network";
+    }, 15000);
+  })
+  .catch(error => {
+    console.error('Error connecting to WiFi:', error);
+    showMessage("Error connecting to WiFi: " + error.message, "error", "connectionMessage");
+    connectBtn.disabled = false;
+    connectBtn.textContent = "Connect Network";
+    updateSystemStatus('offline', 'Connection failed');
+  });
+}
+
+function disconnectWiFi() {
+  const disconnectBtn = document.getElementById("disconnectBtn");
+  
+  disconnectBtn.disabled = true;
+  disconnectBtn.innerHTML = '<div class="loading"></div> Disconnecting...';
+  updateSystemStatus('connecting', 'Disconnecting...');
+  
+  fetch('/api/wifi/disconnect', { method: 'POST' })
+    .then(response => {
+      if (!response.ok) {
+        throw new Error(`HTTP error! status: ${response.status}`);
+      }
+      return response.json();
+    })
+    .then(result => {
+      console.log('Disconnect result:', result);
+      showMessage(result.message, "info", "connectionMessage");
+      updateSnapshot();
+      disconnectBtn.disabled = false;
+      disconnectBtn.textContent = "Disconnect";
+    })
+    .catch(error => {
+      console.error('Error disconnecting from WiFi:', error);
+      showMessage("Error disconnecting from WiFi: " + error.message, "error", "connectionMessage");
+      disconnectBtn.disabled = false;
+      disconnectBtn.textContent = "Disconnect";
+    });
+}
+
+// Sensors, AP/STA status and system stats come from /api/snapshot,
+// revalidated with its ETag; 304 = nothing changed since the last refresh
+let snapshotEtag = null;
+let lastSensorSeq = 0;
+let systemSnapshot = null;
+
+function updateSnapshot() {
+  const headers = snapshotEtag ? { 'If-None-Match': snapshotEtag } : {};
+  fetch('/api/snapshot', { cache: 'no-store', headers })
+.then(response => {
+  if (response.status === 304) return null;
+  if (!response.ok) {
+    throw new Error(`HTTP error! status: ${response.status}`);
+  }
+  snapshotEtag = response.headers.get('ETag');
+  return response.json();
+})
+.then(data => {
+  systemState.connection.lastUpdate = new Date();
+  systemState.connection.retryCount = 0;
+  if (!data) return;
+  systemSnapshot = Object.assign({ receivedAt: Date.now() }, data.system);
+  renderWiFiStatus(data);
+  renderSensors(data.sensors);
+})
+.catch(error => {
+  console.error("Error fetching snapshot:", error);
+  systemState.connection.retryCount++;
+  if (systemState.connection.retryCount > 3) {
+    updateSystemStatus('offline', 'Connection lost');
+  }
+  document.getElementById('wifiStatusDisplay').innerHTML = `
+    <div class="status-item">
+      <span class="status-label">Status</span>
+      <span class="status-value">
+        <div class="status-indicator status-disconnected"></div>
+        Error fetching status (Retry ${systemState.connection.retryCount})
+      </span>
+    </div>
+  `;
+});
+}
+
+function renderSensors(latest) {
+  if (latest.seq === lastSensorSeq) return;
+  systemState.system.dataPoints += lastSensorSeq && latest.seq > lastSensorSeq ? latest.seq - lastSensorSeq : 1;
+  lastSensorSeq = latest.seq;
+
+  const temp = systemState.sensors.temperature;
+  const humidity = systemState.sensors.humidity;
+  const light = systemState.sensors.light;
+
+  // Shift previous values
+  temp.previous = temp.current;
+  humidity.previous = humidity.current;
+  light.previous = light.current;
+
+  // Assign new values from ESP32 API
+  temp.current = latest.temperature;
+  humidity.current = latest.humidity;
+  light.current = latest.light;
+
+  // Trend calculation
+  temp.trend = calculateTrend(temp.previous, temp.current);
+  humidity.trend = calculateTrend(humidity.previous, humidity.current);
+  light.trend = calculateTrend(light.previous, light.current);
+
+  updateSensorDisplays();
+  checkThresholds();
+}
+
+function calculateTrend(previous, current) {
+  if (previous === null) return 'stable';
+  const diff = current - previous;
+  if (Math.abs(diff) < 0.5) return 'stable';
+  return diff > 0 ? 'rising' : 'falling';
+}
+
+function updateSensorDisplays() {
+  const temp = systemState.sensors.temperature;
+  const humidity = systemState.sensors.humidity;
+  const light = systemState.sensors.light;
+  
+  document.getElementById("temperatureValue").textContent = `${temp.current.toFixed(1)}°C`;
+  document.getElementById("humidityValue").textContent = `${humidity.current.toFixed(0)}%`;
+  document.getElementById("lightValue").textContent = `${light.current.toFixed(0)} lx`;
+  
+  document.getElementById("tempTrend").innerHTML = getTrendIcon(temp.trend);
+  document.getElementById("humidityTrend").innerHTML = getTrendIcon(humidity.trend);
+  document.getElementById("lightTrend").innerHTML = getTrendIcon(light.trend);
+  
+  updateSystemStatus('online', 'All systems operational');
+}
+
+function getTrendIcon(trend) {
+  switch(trend) {
+    case 'rising': return '<span style="color: var(--accent-orange);">↗ Rising</span>';
+    case 'falling': return '<span style="color: var(--accent-blue);">↘ Falling</span>';
+    default: return '<span style="color: var(--text-secondary);">→ Stable</span>';
+  }
+}
+
+function checkThresholds() {
+  const alerts = [];
+  const temp = systemState.sensors.temperature.current;
+  const humidity = systemState.sensors.humidity.current;
+  const light = systemState.sensors.light.current;
+  
+  if (temp < systemState.thresholds.tempMin || temp > systemState.thresholds.tempMax) {
+    alerts.push(`Temperature ${temp.toFixed(1)}°C is outside optimal range`);
+  }
+  
+  if (humidity > systemState.thresholds.humidity) {
+    alerts.push(`Humidity ${humidity.toFixed(0)}% exceeds threshold`);
+  }
+  
+  if (light < systemState.thresholds.light) {
+    alerts.push(`Light level ${light.toFixed(0)} lx below threshold`);
+  }
+  
+  if (alerts.length > 0 && systemState.automation.temperature) {
+    console.log('Auto-adjusting climate control...');
+  }
+}
+
+function updateSystemStatus(status, message) {
+  const statusElement = document.getElementById('systemStatus');
+  let statusClass = status;
+  let icon = '';
+  
+  switch(status) {
+    case 'online':
+      icon = '🟢';
+      break;
+    case 'offline':
+      icon = '🔴';
+      break;
+    case 'connecting':
+      icon = '🟡';
+      break;
+    default:
+      icon = '⚪';
+  }
+  
+  statusElement.innerHTML = `
+    <div class="status-chip ${statusClass}">
+      ${status === 'connecting' ? '<div class="loading"></div>' : icon}
+      ${message}
+    </div>
+  `;
+}
+
+function updateSystemInfo() {
+  // Device uptime, extrapolated between snapshots (uptime does not change
+  // the snapshot's ETag, so a 304 leaves the last value here)
+  const now = Date.now();
+  const uptime = systemSnapshot
+    ? systemSnapshot.uptime_s + Math.floor((now - systemSnapshot.receivedAt) / 1000)
+    : Math.floor((now - systemState.system.startTime) / 1000);
+  const hours = Math.floor(uptime / 3600);
+  const minutes = Math.floor((uptime % 3600) / 60);
+  const seconds = uptime % 60;
+  
+  document.getElementById('uptime').textContent = `${hours}h ${minutes}m ${seconds}s`;
+  document.getElementById('memory').textContent = systemSnapshot
+    ? `${Math.round(100 * (systemSnapshot.heap_size - systemSnapshot.free_heap) / systemSnapshot.heap_size)}%`
+    : '--';
+  document.getElementById('lastUpdate').textContent = 
+    systemState.connection.lastUpdate ? systemState.connection.lastUpdate.toLocaleTimeString() : '--';
+  
+  if (document.getElementById('networkCount').textContent === '--') {
+    document.getElementById('networkCount').textContent = systemState.availableNetworks.length;
+  }
+}
+
+function renderWiFiStatus(data) {
+  const statusDisplay = document.getElementById('wifiStatusDisplay');
+  let statusHTML = '';
+  
+  statusHTML += `
+    <div class="status-item">
+      <span class="status-label">Access Point</span>
+      <span class="status-value">
+        <div class="status-indicator status-connected"></div>
+        ${data.ap.ssid} (${data.ap.connected_clients} devices)
+      </span>
+    </div>
+    <div class="status-item">
+      <span class="status-label">AP IP Address</span>
+      <span class="status-value">${data.ap.ip}</span>
+    </div>
+  `;
+  
+  if (data.sta.connected) {
+    const signalBars = getSignalBars(data.sta.rssi);
+    statusHTML += `
+      <div class="status-item">
+        <span class="status-label">Internet Connection</span>
+        <span class="status-value">
+          <div class="status-indicator status-connected"></div>
+          Connected to ${data.sta.ssid}
+        </span>
+      </div>
+      <div class="status-item">
+        <span class="status-label">IP Address</span>
+        <span class="status-value">${data.sta.ip}</span>
+      </div>
+      <div class="status-item">
+        <span class="status-label">Signal Strength</span>
+        <span class="status-value">
+          ${signalBars}
+          ${data.sta.rssi} dBm
+        </span>
+      </div>
+    `;
+  } else {
+    statusHTML += `
+      <div class="status-item">
+        <span class="status-label">Internet Connection</span>
+        <span class="status-value">
+          <div class="status-indicator status-disconnected"></div>
+          Not connected
+        </span>
+      </div>
+    `;
+  }
+  
+  statusDisplay.innerHTML = statusHTML;
+}
+
+function getSignalBars(rssi) {
+  const strength = Math.max(0, Math.min(4, Math.floor((rssi + 100) / 12.5)));
+  let bars = '<div class="signal-strength">';
+  for (let i = 1; i <= 4; i++) {
+    bars += `<div class="signal-bar ${i <= strength ? 'active' : ''}"></div>`;
+  }
+  bars += '</div>';
+  return bars;
+}
+
+function toggleAutoTemperature() {
+  systemState.automation.temperature = !systemState.automation.temperature;
+  const toggle = document.getElementById('tempToggle');
+  toggle.classList.toggle('active', systemState.automation.temperature);
+  showMessage(`Auto Temperature Control: ${systemState.automation.temperature ? 'ON' : 'OFF'}`, 'success', 'controlMessage');
+  saveSettings();
+}
+
+function toggleAutoHumidity() {
+  systemState.automation.humidity = !systemState.automation.humidity;
+  const toggle = document.getElementById('humidityToggle');
+  toggle.classList.toggle('active', systemState.automation.humidity);
+  showMessage(`Auto Humidity Control: ${systemState.automation.humidity ? 'ON' : 'OFF'}`, 'success', 'controlMessage');
+  saveSettings();
+}
+
+function toggleAutoLight() {
+  systemState.automation.light = !systemState.automation.light;
+  const toggle = document.getElementById('lightToggle');
+  toggle.classList.toggle('active', systemState.automation.light);
+  showMessage(`Auto Light Control: ${systemState.automation.light ? 'ON' : 'OFF'}`, 'success', 'controlMessage');
+  saveSettings();
+}
+
+function toggleAutoIrrigation() {
+  systemState.automation.irrigation = !systemState.automation.irrigation;
+  const toggle = document.getElementById('irrigationToggle');
+  toggle.classList.toggle('active', systemState.automation.irrigation);
+  showMessage(`Auto Irrigation System: ${systemState.automation.irrigation ? 'ON' : 'OFF'}`, 'success', 'controlMessage');
+  saveSettings();
+}
+
+function saveThresholds() {
+  const tempMin = document.getElementById('tempMin').value;
+  const tempMax = document.getElementById('tempMax').value;
+  const humidity = document.getElementById('humidityThreshold').value;
+  const light = document.getElementById('lightThreshold').value;
+  
+  let updated = false;
+  
+  if (tempMin && !isNaN(tempMin)) {
+    systemState.thresholds.tempMin = parseFloat(tempMin);
+    updated = true;
+  }
+  
+  if (tempMax && !isNaN(tempMax)) {
+    systemState.thresholds.tempMax = parseFloat(tempMax);
+    updated = true;
+  }
+  
+  if (humidity && !isNaN(humidity)) {
+    systemState.thresholds.humidity = parseFloat(humidity);
+    updated = true;
+  }
+  
+  if (light && !isNaN(light)) {
+    systemState.thresholds.light = parseFloat(light);
+    updated = true;
+  }
+  
+  if (updated) {
+    showMessage('Thresholds saved successfully!', 'success', 'thresholdMessage');
+    saveSettings();
+  } else {
+    showMessage('Please enter at least one threshold value', 'error', 'thresholdMessage');
+  }
+}
+
+function saveSettings() {
+  const settings = {
+    automation: systemState.automation,
+    thresholds: systemState.thresholds
+  };
+  
+  window.greenhouseSettings = settings;
+  console.log('Settings saved:', settings);
+}
+
+function loadStoredSettings() {
+  const stored = window.greenhouseSettings;
+  if (stored) {
+    systemState.automation = { ...systemState.automation, ...stored.automation };
+    systemState.thresholds = { ...systemState.thresholds, ...stored.thresholds };
+    
+    Object.keys(systemState.automation).forEach(key => {
+      const toggle = document.getElementById(key + 'Toggle');
+      if (toggle) {
+        toggle.classList.toggle('active', systemState.automation[key]);
+      }
+    });
+    
+    Object.keys(systemState.thresholds).forEach(key => {
+      const input = document.getElementById(key === 'tempMin' ? 'tempMin' : 
+                                             key === 'tempMax' ? 'tempMax' :
+                                             key === 'humidity' ? 'humidityThreshold' : 
+                                             key === 'light' ? 'lightThreshold' : null);
+      if (input) {
+        input.value = systemState.thresholds[key];
+      }
+    });
+    console.log('Stored settings loaded:', stored);
+  }
+}
+
+function showMessage(message, type, containerId) {
+  const container = document.getElementById(containerId);
+  if (!container) return;
+  
+  console.log(`Message [${type}]:`, message);
+  container.innerHTML = `<div class="message ${type}">${message}</div>`;
+  
+  setTimeout(() => {
+    container.innerHTML = "";
+  }, 5000);
+}
+
+document.addEventListener('keydown', function(e) {
+  if (e.ctrlKey && e.key === 'r') {
+    e.preventDefault();
+    location.reload();
+  }
+  
+  if (e.key === 'Escape') {
+    ['connectionMessage', 'thresholdMessage', 'controlMessage'].forEach(id => {
+      const el = document.getElementById(id);
+      if (el) el.innerHTML = '';
+    });
+  }
+  
+  if (e.ctrlKey && e.key === 's') {
+    e.preventDefault();
+    scanWiFiNetworks();
+  }
+});
+
+window.addEventListener('error', function(e) {
+  console.error('Global error:', e.error);
+  updateSystemStatus('offline', 'System error detected');
+});
+
+document.addEventListener('visibilitychange', function() {
+  if (document.visibilityState === 'visible') {
+    console.log('Tab visible, resuming updates...');
+    updateSnapshot();
+  }
+});
+
+setInterval(() => {
+  if (systemState.availableNetworks.length === 0 && 
+      !systemState.scanInProgress && 
+      scanRetryCount < maxScanRetries) {
+    console.log('Auto-scanning for networks (no networks available)');
+    scanWiFiNetworks();
+  }
+}, 45000);
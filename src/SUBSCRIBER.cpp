@@ -1,59 +0,0 @@
-#include <WiFi.h>
-#include <PubSubClient.h>
-
-const char* ssid = "p";
-const char* password = "12345678";
-
-const char* mqttServer = "broker.hivemq.com";
-const int mqttPort = 1883;
-const char* mqttTopic = "esp32/sensor/data";
-
-WiFiClient espClient;
-PubSubClient client(espClient);
-
-void callback(char* topic, byte* payload, unsigned int length) {
-  Serial.print("Message arrived [");
-  Serial.print(topic);
-  Serial.print("] ");
-  char msg[length+1];
-  memcpy(msg, payload, length);
-  msg[length] = '\0';
-  Serial.println(msg);
-}
-
-void setup() {
-  Serial.begin(115200);
-
-  WiFi.begin(ssid, password);
-  Serial.print("Connecting to WiFi");
-  while (WiFi.status() != WL_CONNECTED) {
-    delay(500);
-    Serial.print(".");
-  }
-  Serial.println("\nConnected to WiFi!");
-
-  client.setServer(mqttServer, mqttPort);
-  client.setCallback(callback);
-}
-
-void reconnect() {
-  while (!client.connected()) {
-    Serial.print("Connecting to MQTT...");
-    if (client.connect("ESP32_SUB")) {
-      Serial.println("connected!");
-      client.subscribe(mqttTopic);
-    } else {
-      Serial.print("failed, rc=");
-      Serial.print(client.state());
-      Serial.println(" try again in 2 seconds");
-      delay(2000);
-    }
-  }
-}
-
-void loop() {
-  if (!client.connected()) {
-    reconnect();
-  }
-  client.loop();
-}
@@ -0,0 +1,101 @@
+#include "api_payloads.h"
+
+#ifdef SERIALIZER_BENCH
+#include <ArduinoJson.h>
+
+// Both paths are kept out of line so each shows up as its own symbol
+// (xtensa-esp32-elf-nm --size-sort -C firmware.elf); ArduinoJson's shared
+// templates are not counted there, so the document paths' real cost in
+// flash is larger.
+
+size_t __attribute__((noinline)) sensorPayloadGenerated(const SensorPayload& p, char* out) {
+  return p.toJson(out) - out;
+}
+
+size_t __attribute__((noinline)) scanEntryPayloadGenerated(const ScanEntryPayload& p, char* out) {
+  return p.toJson(out) - out;
+}
+
+size_t __attribute__((noinline)) wifiStatusPayloadGenerated(const WifiStatusPayload& p, char* out) {
+  return p.toJson(out) - out;
+}
+
+size_t __attribute__((noinline)) sensorPayloadDocument(const SensorPayload& p, char* out, size_t cap) {
+  JsonDocument doc;
+  doc["temperature"] = p.tempCenti / 100.0;
+  doc["humidity"]    = p.humidityCenti / 100.0;
+  doc["light"]       = p.light;
+  doc["seq"]         = p.seq;
+  return serializeJson(doc, out, cap);
+}
+
+size_t __attribute__((noinline)) scanEntryPayloadDocument(const ScanEntryPayload& p, char* out, size_t cap) {
+  char bssid[18];
+  snprintf(bssid, sizeof(bssid), "%02X:%02X:%02X:%02X:%02X:%02X",
+           p.bssid[0], p.bssid[1], p.bssid[2], p.bssid[3], p.bssid[4], p.bssid[5]);
+  JsonDocument doc;
+  doc["ssid"]       = p.ssid;
+  doc["rssi"]       = p.rssi;
+  doc["channel"]    = p.channel;
+  doc["bssid"]      = bssid;
+  doc["encryption"] = p.encryption;
+  doc["encrypted"]  = p.encrypted;
+  doc["aps"]        = p.aps;
+  return serializeJson(doc, out, cap);
+}
+
+size_t __attribute__((noinline)) wifiStatusPayloadDocument(const WifiStatusPayload& p, char* out, size_t cap) {
+  JsonDocument doc;
+  JsonObject ap = doc["ap"].to<JsonObject>();
+  ap["ssid"]              = p.ap.ssid;
+  ap["ip"]                = p.ap.ip.toString();
+  ap["connected_clients"] = p.ap.connectedClients;
+
+  JsonObject mqtt = doc["mqtt"].to<JsonObject>();
+  mqtt["device_id"] = p.mqtt.deviceId;
+  mqtt["topic"]     = p.mqtt.topic;
+  mqtt["connected"] = p.mqtt.connected;
+  mqtt["missed"]    = p.mqtt.missed;
+  mqtt["batches"]   = p.mqtt.batches;
+
+  const StaStatusPayload& s = p.sta;
+  JsonObject sta = doc["sta"].to<JsonObject>();
+  sta["connected"] = s.connected;
+  if (s.connected) {
+    char bssid[18];
+    snprintf(bssid, sizeof(bssid), "%02X:%02X:%02X:%02X:%02X:%02X",
+             s.bssid[0], s.bssid[1], s.bssid[2], s.bssid[3], s.bssid[4], s.bssid[5]);
+    sta["ssid"]    = s.ssid;
+    sta["ip"]      = s.ip.toString();
+    sta["rssi"]    = s.rssi;
+    sta["bssid"]   = bssid;
+    sta["channel"] = s.channel;
+  }
+  sta["saved"]                = s.saved;
+  sta["connecting"]           = s.connecting;
+  sta["connect_path"]         = s.connectPath;
+  sta["connect_ms"]           = s.connectMs;
+  sta["boot_to_connected_ms"] = s.bootToConnectedMs;
+  sta["fast_fallbacks"]       = s.fastFallbacks;
+
+  JsonObject roam = sta["roam"].to<JsonObject>();
+  roam["roams"]          = s.roam.roams;
+  roam["switches"]       = s.roam.switches;
+  roam["failures"]       = s.roam.failures;
+  roam["last_roam_ms"]   = s.roam.lastRoamMs;
+  roam["avg_roam_ms"]    = s.roam.avgRoamMs;
+  roam["max_roam_ms"]    = s.roam.maxRoamMs;
+  roam["last_from_rssi"] = s.roam.lastFromRssi;
+  roam["last_to_rssi"]   = s.roam.lastToRssi;
+  roam["scans"]          = s.roam.scans;
+  roam["scan_failures"]  = s.roam.scanFailures;
+  roam["last_scan_ms"]   = s.roam.lastScanMs;
+
+  JsonObject outages = sta["outages"].to<JsonObject>();
+  outages["count"]    = s.outages.count;
+  outages["last_ms"]  = s.outages.lastMs;
+  outages["max_ms"]   = s.outages.maxMs;
+  outages["total_ms"] = s.outages.totalMs;
+  return serializeJson(doc, out, cap);
+}
+#endif
@@ -0,0 +1,161 @@
+#ifndef API_PAYLOADS_H
+#define API_PAYLOADS_H
+
+#include <Arduino.h>
+#include "json_struct.h"
+#include "telemetry.h"
+
+// Response bodies of the hot API routes, declared once as structs with
+// generated serializers (json_struct.h). Handlers fill a struct from live
+// state and write it with toJson(); member order is key order.
+
+// Plain /api/sensors
+struct SensorPayload {
+  int32_t  tempCenti;
+  int32_t  humidityCenti;
+  int32_t  light;
+  uint32_t seq;
+  JSON_FIELDS(SensorPayload,
+    JSON_FIXED_AS(tempCenti, "temperature", 2),
+    JSON_FIXED_AS(humidityCenti, "humidity", 2),
+    JSON_FIELD(light),
+    JSON_FIELD(seq))
+};
+
+// One element of "networks" in the scan results
+struct ScanEntryPayload {
+  char        ssid[33];
+  int8_t      rssi;
+  uint8_t     channel;
+  uint8_t     bssid[6];
+  const char* encryption;
+  bool        encrypted;
+  uint8_t     aps;
+  JSON_FIELDS(ScanEntryPayload,
+    JSON_FIELD(ssid),
+    JSON_FIELD(rssi),
+    JSON_FIELD(channel),
+    JSON_FIELD(bssid),
+    JSON_STR(encryption, 16),
+    JSON_FIELD(encrypted),
+    JSON_FIELD(aps))
+};
+
+// /api/wifi/status
+struct ApStatusPayload {
+  const char* ssid;
+  IPAddress   ip;
+  uint8_t     connectedClients;
+  JSON_FIELDS(ApStatusPayload,
+    JSON_STR(ssid, 32),
+    JSON_FIELD(ip),
+    JSON_FIELD_AS(connectedClients, "connected_clients"))
+};
+
+struct MqttStatusPayload {
+  const char* deviceId;
+  const char* topic;
+  bool        connected;
+  uint32_t    missed;
+  uint32_t    batches;
+  JSON_FIELDS(MqttStatusPayload,
+    JSON_STR_AS(deviceId, "device_id", TELEMETRY_ID_LEN - 1),
+    JSON_STR(topic, TELEMETRY_TOPIC_LEN - 1),
+    JSON_FIELD(connected),
+    JSON_FIELD(missed),
+    JSON_FIELD(batches))
+};
+
+struct RoamStatusPayload {
+  uint32_t roams;
+  uint32_t switches;
+  uint32_t failures;
+  uint32_t lastRoamMs;
+  uint32_t avgRoamMs;
+  uint32_t maxRoamMs;
+  int8_t   lastFromRssi;
+  int8_t   lastToRssi;
+  uint32_t scans;
+  uint32_t scanFailures;
+  uint32_t lastScanMs;
+  JSON_FIELDS(RoamStatusPayload,
+    JSON_FIELD(roams),
+    JSON_FIELD(switches),
+    JSON_FIELD(failures),
+    JSON_FIELD_AS(lastRoamMs, "last_roam_ms"),
+    JSON_FIELD_AS(avgRoamMs, "avg_roam_ms"),
+    JSON_FIELD_AS(maxRoamMs, "max_roam_ms"),
+    JSON_FIELD_AS(lastFromRssi, "last_from_rssi"),
+    JSON_FIELD_AS(lastToRssi, "last_to_rssi"),
+    JSON_FIELD(scans),
+    JSON_FIELD_AS(scanFailures, "scan_failures"),
+    JSON_FIELD_AS(lastScanMs, "last_scan_ms"))
+};
+
+struct OutageStatusPayload {
+  uint32_t count;
+  uint32_t lastMs;
+  uint32_t maxMs;
+  uint32_t totalMs;
+  JSON_FIELDS(OutageStatusPayload,
+    JSON_FIELD(count),
+    JSON_FIELD_AS(lastMs, "last_ms"),
+    JSON_FIELD_AS(maxMs, "max_ms"),
+    JSON_FIELD_AS(totalMs, "total_ms"))
+};
+
+struct StaStatusPayload {
+  bool        connected;
+  char        ssid[33];     // link fields only while connected
+  IPAddress   ip;
+  int8_t      rssi;
+  uint8_t     bssid[6];
+  uint8_t     channel;
+  bool        saved;
+  bool        connecting;
+  const char* connectPath;
+  uint32_t    connectMs;
+  uint32_t    bootToConnectedMs;
+  uint8_t     fastFallbacks;
+  RoamStatusPayload   roam;
+  OutageStatusPayload outages;
+  JSON_FIELDS(StaStatusPayload,
+    JSON_FIELD(connected),
+    JSON_FIELD_IF(ssid, connected),
+    JSON_FIELD_IF(ip, connected),
+    JSON_FIELD_IF(rssi, connected),
+    JSON_FIELD_IF(bssid, connected),
+    JSON_FIELD_IF(channel, connected),
+    JSON_FIELD(saved),
+    JSON_FIELD(connecting),
+    JSON_STR_AS(connectPath, "connect_path", 16),
+    JSON_FIELD_AS(connectMs, "connect_ms"),
+    JSON_FIELD_AS(bootToConnectedMs, "boot_to_connected_ms"),
+    JSON_FIELD_AS(fastFallbacks, "fast_fallbacks"),
+    JSON_FIELD(roam),
+    JSON_FIELD(outages))
+};
+
+struct WifiStatusPayload {
+  ApStatusPayload   ap;
+  MqttStatusPayload mqtt;
+  StaStatusPayload  sta;
+  JSON_FIELDS(WifiStatusPayload,
+    JSON_FIELD(ap),
+    JSON_FIELD(mqtt),
+    JSON_FIELD(sta))
+};
+
+#ifdef SERIALIZER_BENCH
+// For POST /api/serializer/bench: the generated serializers, and the same
+// payloads through an ArduinoJson document the way handlers used to build
+// them. Each returns the length written to `out`.
+size_t sensorPayloadGenerated(const SensorPayload& p, char* out);
+size_t scanEntryPayloadGenerated(const ScanEntryPayload& p, char* out);
+size_t wifiStatusPayloadGenerated(const WifiStatusPayload& p, char* out);
+size_t sensorPayloadDocument(const SensorPayload& p, char* out, size_t cap);
+size_t scanEntryPayloadDocument(const ScanEntryPayload& p, char* out, size_t cap);
+size_t wifiStatusPayloadDocument(const WifiStatusPayload& p, char* out, size_t cap);
+#endif
+
+#endif // API_PAYLOADS_H
@@ -0,0 +1,119 @@
+#include "arena.h"
+#include <stdarg.h>
+
+// Each block is preceded by its (aligned) size, so the top block can be
+// grown or released in place
+struct BlockHeader {
+  uint32_t size;
+  uint32_t reserved;   // keeps the payload ARENA_ALIGN-aligned
+};
+
+static size_t alignUp(size_t n) {
+  return (n + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+Arena::Arena(uint8_t* buf, size_t size) : buf_(buf), cap_(size) {
+  stats_.capacity = size;
+}
+
+bool Arena::isTop(const void* p) const {
+  return hasTop_ && (const uint8_t*)p == buf_ + top_ + sizeof(BlockHeader);
+}
+
+void* Arena::heapAllocate(size_t size) {
+  HeapBlock* b = (HeapBlock*)malloc(sizeof(HeapBlock) + size);
+  if (!b) return nullptr;
+  stats_.fallbacks++;
+  b->prev = nullptr;
+  b->next = heap_;
+  if (heap_) heap_->prev = b;
+  heap_ = b;
+  return b + 1;
+}
+
+void* Arena::allocate(size_t size) {
+  stats_.allocations++;
+  size_t need = sizeof(BlockHeader) + alignUp(size);
+  if (need > cap_ - used_) return heapAllocate(size);
+  BlockHeader* h = (BlockHeader*)(buf_ + used_);
+  h->size = alignUp(size);
+  top_ = used_;
+  hasTop_ = true;
+  used_ += need;
+  if (used_ > stats_.highWater) stats_.highWater = used_;
+  return h + 1;
+}
+
+void Arena::deallocate(void* ptr) {
+  if (!ptr) return;
+  if (!owns(ptr)) {
+    HeapBlock* b = (HeapBlock*)ptr - 1;
+    if (b->prev) b->prev->next = b->next;
+    else         heap_ = b->next;
+    if (b->next) b->next->prev = b->prev;
+    free(b);
+    return;
+  }
+  if (isTop(ptr)) {
+    used_ = top_;
+    hasTop_ = false;   // the block below is not tracked; it waits for reset()
+  }
+}
+
+void* Arena::reallocate(void* ptr, size_t size) {
+  if (!ptr) return allocate(size);
+  if (!owns(ptr)) {
+    HeapBlock* b = (HeapBlock*)ptr - 1;
+    HeapBlock* n = (HeapBlock*)realloc(b, sizeof(HeapBlock) + size);
+    if (!n) return nullptr;
+    if (n->prev) n->prev->next = n;
+    else         heap_ = n;
+    if (n->next) n->next->prev = n;
+    return n + 1;
+  }
+  BlockHeader* h = (BlockHeader*)ptr - 1;
+  if (isTop(ptr) && top_ + sizeof(BlockHeader) + alignUp(size) <= cap_) {
+    h->size = alignUp(size);
+    used_ = top_ + sizeof(BlockHeader) + h->size;
+    if (used_ > stats_.highWater) stats_.highWater = used_;
+    return ptr;
+  }
+  size_t oldSize = h->size;
+  void* moved = allocate(size);
+  if (!moved) return nullptr;
+  memcpy(moved, ptr, min(oldSize, size));
+  deallocate(ptr);   // only reclaims anything if ptr is still the top
+  return moved;
+}
+
+char* Arena::printf(const char* fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  int n = vsnprintf(nullptr, 0, fmt, args);
+  va_end(args);
+  if (n < 0) return nullptr;
+  char* out = alloc<char>(n + 1);
+  if (!out) return nullptr;
+  va_start(args, fmt);
+  vsnprintf(out, n + 1, fmt, args);
+  va_end(args);
+  return out;
+}
+
+void Arena::reset() {
+  while (heap_) {
+    HeapBlock* next = heap_->next;
+    free(heap_);
+    heap_ = next;
+  }
+  used_ = 0;
+  hasTop_ = false;
+  stats_.resets++;
+}
+
+void Arena::resetStats() {
+  stats_.highWater = used_;
+  stats_.allocations = 0;
+  stats_.fallbacks = 0;
+  stats_.resets = 0;
+}
@@ -0,0 +1,81 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Bump allocator for scratch memory that lives exactly one request (or one
+// MQTT publish).
+//
+//   JsonDocument doc(&requestArena);          // pools and strings in the arena
+//   char* out = requestArena.alloc<char>(n);
+//   ...
+//   requestArena.reset();                     // everything above is gone
+//
+// Allocations are carved from a fixed buffer in order and released all at
+// once by reset(), so request scratch never touches the global heap and cannot
+// fragment it. Freeing or growing the most recent block works in place
+// (ArduinoJson's string builder and shrinkToFit rely on that); anything
+// else freed early just waits for the reset. A request that does not fit
+// falls back to the heap: it still works, is counted under `fallbacks`,
+// and its blocks are released by the same reset. `highWater` is the most
+// bytes in use at once, i.e. what the buffer has to hold.
+
+#define ARENA_ALIGN 8
+
+struct ArenaStats {
+  uint32_t capacity;
+  uint32_t highWater;     // bytes, since the last resetStats()
+  uint32_t allocations;
+  uint32_t fallbacks;     // allocations that went to the heap
+  uint32_t resets;
+};
+
+class Arena : public ArduinoJson::Allocator {
+ public:
+  Arena(uint8_t* buf, size_t size);
+
+  void* allocate(size_t size) override;
+  void  deallocate(void* ptr) override;
+  void* reallocate(void* ptr, size_t size) override;
+
+  template <typename T>
+  T* alloc(size_t n = 1) { return static_cast<T*>(allocate(n * sizeof(T))); }
+  // NUL-terminated, formatted into the arena
+  char* printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+  void   reset();
+  size_t used() const { return used_; }
+  const ArenaStats& stats() const { return stats_; }
+  void   resetStats();
+
+ private:
+  struct HeapBlock {
+    HeapBlock* prev;
+    HeapBlock* next;
+  };
+
+  bool  owns(const void* p) const { return (const uint8_t*)p >= buf_ && (const uint8_t*)p < buf_ + cap_; }
+  bool  isTop(const void* p) const;
+  void* heapAllocate(size_t size);
+
+  uint8_t*   buf_;
+  size_t     cap_;
+  size_t     used_ = 0;
+  size_t     top_ = 0;          // offset of the last block's header...
+  bool       hasTop_ = false;   // ...while it is still allocated
+  HeapBlock* heap_ = nullptr;   // fallback blocks, freed by reset()
+  ArenaStats stats_ = {};
+};
+
+// Arena with its own static-sized buffer
+template <size_t N>
+class FixedArena : public Arena {
+ public:
+  FixedArena() : Arena(storage_, N) {}
+
+ private:
+  alignas(ARENA_ALIGN) uint8_t storage_[N];
+};
+
+#endif // ARENA_H
@@ -0,0 +1,28 @@
+#include "boot_profile.h"
+
+static BootMark marks[BOOT_MAX_MARKS];
+static size_t   markCount = 0;
+
+void bootMark(const char* stage) {
+  if (markCount >= BOOT_MAX_MARKS) return;
+  marks[markCount].stage = stage;
+  marks[markCount].us    = micros();
+  markCount++;
+}
+
+void bootMarkOnce(const char* stage) {
+  if (bootMarkUs(stage) == 0) bootMark(stage);
+}
+
+uint32_t bootMarkUs(const char* stage) {
+  for (size_t i = 0; i < markCount; i++) {
+    if (strcmp(marks[i].stage, stage) == 0) return marks[i].us;
+  }
+  return 0;
+}
+
+size_t bootMarkCount() { return markCount; }
+
+const BootMark* bootMarkAt(size_t i) {
+  return i < markCount ? &marks[i] : nullptr;
+}
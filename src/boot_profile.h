@@ -0,0 +1,26 @@
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <Arduino.h>
+
+// Boot timeline.
+//
+// bootMark() stamps micros() (time since the app started, so the first mark
+// already includes ROM/bootloader/app init before setup()) against a stage
+// name. Marks go into a fixed table; stage names must be string literals.
+// The timeline is served at /api/boot.
+
+#define BOOT_MAX_MARKS 24
+
+struct BootMark {
+  const char* stage;
+  uint32_t    us;
+};
+
+void            bootMark(const char* stage);
+void            bootMarkOnce(const char* stage);   // ignored if `stage` is already marked
+uint32_t        bootMarkUs(const char* stage);     // 0 if not reached yet
+size_t          bootMarkCount();
+const BootMark* bootMarkAt(size_t i);
+
+#endif // BOOT_PROFILE_H
@@ -0,0 +1,256 @@
+#include "captive_dns.h"
+
+// DNS wire-format constants (RFC 1035, RFC 9460)
+static const size_t   DNS_HEADER_LEN = 12;
+static const uint16_t DNS_TYPE_A     = 1;
+static const uint16_t DNS_TYPE_ANY   = 255;
+static const uint16_t DNS_CLASS_IN   = 1;
+static const uint8_t  DNS_RCODE_NOTIMP = 4;
+
+// Hostnames used by OS connectivity checks. These always resolve to the AP
+// so the portal keeps working while other names are forwarded.
+static const char* const CAPTIVE_PROBE_HOSTS[] = {
+  "connectivitycheck.gstatic.com",
+  "connectivitycheck.android.com",
+  "clients1.google.com",
+  "clients3.google.com",
+  "captive.apple.com",
+  "www.msftconnecttest.com",
+  "www.msftncsi.com",
+  "dns.msftncsi.com",
+  "detectportal.firefox.com",
+  "nmcheck.gnome.org",
+};
+
+static inline uint16_t rd16(const uint8_t* p) { return (uint16_t)(p[0] << 8) | p[1]; }
+static inline void     wr16(uint8_t* p, uint16_t v) { p[0] = v >> 8; p[1] = v & 0xFF; }
+
+// Compares a wire-format qname against a dotted hostname, ignoring case
+static bool qnameEquals(const uint8_t* q, const char* host) {
+  while (*q) {
+    uint8_t l = *q++;
+    for (uint8_t i = 0; i < l; ++i, ++q, ++host) {
+      char c = (*q >= 'A' && *q <= 'Z') ? *q + 32 : *q;
+      if (c != *host) return false;
+    }
+    if (*q && *host++ != '.') return false;
+  }
+  return *host == '\0';
+}
+
+static bool isCaptiveProbeHost(const uint8_t* qname) {
+  for (const char* host : CAPTIVE_PROBE_HOSTS) {
+    if (qnameEquals(qname, host)) return true;
+  }
+  return false;
+}
+
+bool CaptiveDns::begin(IPAddress ip, uint16_t port, uint32_t ttl) {
+  // Answer RR: pointer to the question name at offset 12, type A, class IN
+  answer_[0]  = 0xC0; answer_[1] = DNS_HEADER_LEN;
+  wr16(&answer_[2], DNS_TYPE_A);
+  wr16(&answer_[4], DNS_CLASS_IN);
+  answer_[6]  = ttl >> 24; answer_[7] = ttl >> 16; answer_[8] = ttl >> 8; answer_[9] = ttl;
+  wr16(&answer_[10], 4);
+  for (int i = 0; i < 4; ++i) answer_[12 + i] = ip[i];
+
+  resetStats();
+  running_ = udp_.begin(port);
+  return running_;
+}
+
+void CaptiveDns::stop() {
+  setUpstream(IPAddress());
+  udp_.stop();
+  running_ = false;
+}
+
+void CaptiveDns::setUpstream(IPAddress resolver) {
+  bool enable = (uint32_t)resolver != 0;
+  if (enable == forwarding_ && resolver == upstreamIP_) return;
+
+  if (forwarding_) upstreamUdp_.stop();
+  for (Pending& p : pending_) p.used = false;
+  cache_.clear();
+
+  upstreamIP_ = resolver;
+  forwarding_ = enable && upstreamUdp_.begin(CAPTIVE_DNS_UPSTREAM_LOCAL_PORT);
+}
+
+size_t CaptiveDns::process() {
+  if (!running_) return 0;
+  size_t handled = 0;
+  uint32_t t0 = micros();
+
+  if (forwarding_) {
+    drainUpstream();
+    expirePending();
+  }
+
+  while (handled < CAPTIVE_DNS_MAX_BURST) {
+    int len = udp_.parsePacket();
+    if (len <= 0) break;
+    handled++;
+    stats_.queries++;
+
+    if (len > (int)sizeof(buf_)) {   // EDNS jumbo query; we never need it
+      udp_.flush();
+      stats_.rejected++;
+      continue;
+    }
+    udp_.read(buf_, len);
+
+    size_t outLen = handleQuery(len);
+    if (outLen) reply(udp_.remoteIP(), udp_.remotePort(), outLen);
+  }
+
+  if (handled) {
+    stats_.busyUs += micros() - t0;
+    if (handled > stats_.maxBurst) stats_.maxBurst = handled;
+  }
+  return handled;
+}
+
+void CaptiveDns::reply(IPAddress ip, uint16_t port, size_t len) {
+  udp_.beginPacket(ip, port);
+  udp_.write(buf_, len);
+  udp_.endPacket();
+}
+
+// Answers the query in buf_ in place, from the cache, or forwards it.
+// Returns the response length to send back, or 0 if nothing is sent now.
+size_t CaptiveDns::handleQuery(size_t len) {
+  if (len < DNS_HEADER_LEN) { stats_.rejected++; return 0; }
+  if (buf_[2] & 0x80) { stats_.rejected++; return 0; }   // QR set: not a query
+
+  size_t qlen = dnsQuestionLen(buf_, len);
+  uint8_t opcode = (buf_[2] >> 3) & 0x0F;
+  if (qlen == 0 || opcode != 0) return buildCaptiveResponse(len, 0);
+
+  if (forwarding_ && !isCaptiveProbeHost(&buf_[DNS_HEADER_LEN])) {
+    uint32_t t0 = micros();
+    size_t hitLen = cache_.lookup(buf_, len, millis(), buf_, sizeof(buf_));
+    if (hitLen) {
+      stats_.hitUs += micros() - t0;
+      return hitLen;
+    }
+    forwardQuery(len);
+    return 0;
+  }
+  return buildCaptiveResponse(len, DNS_HEADER_LEN + qlen);
+}
+
+// Turns the query in buf_ into a wildcard response. `qend` == 0 means the
+// query is not one we support and gets NOTIMP.
+size_t CaptiveDns::buildCaptiveResponse(size_t len, size_t qend) {
+  // Response: QR=1, keep opcode and RD; AA=1, RA=0
+  uint8_t flags = buf_[2];
+  buf_[2] = 0x80 | (flags & 0x79) | 0x04;
+  buf_[3] = 0;
+
+  if (qend == 0) {
+    buf_[3] = DNS_RCODE_NOTIMP;
+    memset(&buf_[4], 0, 8);               // no sections echoed back
+    stats_.rejected++;
+    return DNS_HEADER_LEN;
+  }
+
+  uint16_t qtype = rd16(&buf_[qend - 4]);
+  wr16(&buf_[8], 0);                      // NSCOUNT
+  wr16(&buf_[10], 0);                     // ARCOUNT (drops any EDNS OPT)
+
+  if (qtype == DNS_TYPE_A || qtype == DNS_TYPE_ANY) {
+    if (qend + sizeof(answer_) > sizeof(buf_)) { stats_.rejected++; return 0; }
+    wr16(&buf_[6], 1);
+    memcpy(&buf_[qend], answer_, sizeof(answer_));
+    stats_.answered++;
+    return qend + sizeof(answer_);
+  }
+
+  wr16(&buf_[6], 0);                      // NODATA: name exists, no records
+  stats_.nodata++;
+  return qend;
+}
+
+bool CaptiveDns::forwardQuery(size_t len) {
+  Pending* slot = nullptr;
+  for (Pending& p : pending_) {
+    if (!p.used) { slot = &p; break; }
+  }
+  if (!slot) {                            // client will retry
+    stats_.pendingFull++;
+    return false;
+  }
+
+  size_t qlen = dnsQuestionLen(buf_, len);
+  uint16_t id;
+  bool taken;
+  do {                                    // unpredictable, and unique among those in flight
+    id = esp_random() & 0xFFFF;
+    taken = false;
+    for (const Pending& p : pending_) taken |= p.used && p.upstreamId == id;
+  } while (taken);
+
+  slot->used       = true;
+  slot->upstreamId = id;
+  slot->qlen       = qlen;
+  slot->qhash      = dnsQuestionHash(&buf_[DNS_HEADER_LEN], qlen);
+  slot->clientId   = rd16(&buf_[0]);
+  slot->client     = udp_.remoteIP();
+  slot->clientPort = udp_.remotePort();
+  slot->sentMs     = millis();
+  slot->sentUs     = micros();
+
+  wr16(&buf_[0], slot->upstreamId);
+  upstreamUdp_.beginPacket(upstreamIP_, 53);
+  upstreamUdp_.write(buf_, len);
+  upstreamUdp_.endPacket();
+  stats_.forwarded++;
+  return true;
+}
+
+void CaptiveDns::drainUpstream() {
+  for (size_t n = 0; n < CAPTIVE_DNS_MAX_BURST; ++n) {
+    int len = upstreamUdp_.parsePacket();
+    if (len <= 0) return;
+    if (len > (int)sizeof(buf_) || upstreamUdp_.remoteIP() != upstreamIP_ ||
+        upstreamUdp_.remotePort() != 53) {
+      upstreamUdp_.flush();
+      stats_.upstreamRejected++;
+      continue;
+    }
+    upstreamUdp_.read(buf_, len);
+    size_t qlen = dnsQuestionLen(buf_, len);
+    if (qlen == 0 || !(buf_[2] & 0x80)) {   // not a response to a single question
+      stats_.upstreamRejected++;
+      continue;
+    }
+
+    uint16_t id = rd16(&buf_[0]);
+    uint32_t qhash = dnsQuestionHash(&buf_[DNS_HEADER_LEN], qlen);
+    Pending* p = nullptr;
+    for (Pending& q : pending_) {
+      if (q.used && q.upstreamId == id && q.qlen == qlen && q.qhash == qhash) { p = &q; break; }
+    }
+    if (!p) {
+      stats_.upstreamRejected++;
+      continue;
+    }
+    p->used = false;
+    stats_.upstreamReplies++;
+    stats_.upstreamUs += micros() - p->sentUs;
+    cache_.insert(buf_, len, millis());
+    wr16(&buf_[0], p->clientId);
+    reply(p->client, p->clientPort, len);
+  }
+}
+
+void CaptiveDns::expirePending() {
+  uint32_t now = millis();
+  for (Pending& p : pending_) {
+    if (p.used && now - p.sentMs > CAPTIVE_DNS_UPSTREAM_TIMEOUT_MS) {
+      p.used = false;
+      stats_.upstreamTimeouts++;
+    }
+  }
+}
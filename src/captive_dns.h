@@ -0,0 +1,94 @@
+#ifndef CAPTIVE_DNS_H
+#define CAPTIVE_DNS_H
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include "dns_cache.h"
+
+// Wildcard DNS responder for the captive portal.
+//
+// Unlike DNSServer (one query per call), process() drains every datagram
+// waiting on the socket. Responses are built in the receive buffer: the
+// header is patched, anything after the question is dropped and a
+// precomputed A record pointing at the AP IP is appended. AAAA / HTTPS /
+// SVCB (and any other non-A type) get an immediate NOERROR/NODATA answer
+// so clients fall back to IPv4 instead of waiting for a timeout.
+//
+// Once an upstream resolver is set (STA link up), names other than the OS
+// captive-probe hosts are forwarded to it instead, and answers are served
+// from a DnsCache while their TTL lasts. Every forwarded query gets a
+// random ID, and a reply is only taken if it comes from the resolver's port
+// 53 with that ID and the same question, so an off-path packet cannot
+// plant an answer in the cache shared by all AP clients.
+
+#define CAPTIVE_DNS_MAX_PACKET   512
+#define CAPTIVE_DNS_MAX_BURST    32    // bound per call so HTTP is not starved
+#define CAPTIVE_DNS_MAX_PENDING  16    // forwarded queries awaiting upstream
+#define CAPTIVE_DNS_UPSTREAM_TIMEOUT_MS 2500
+#define CAPTIVE_DNS_UPSTREAM_LOCAL_PORT 53530
+
+struct CaptiveDnsStats {
+  uint32_t queries;
+  uint32_t answered;      // A / ANY -> apIP
+  uint32_t nodata;        // AAAA, HTTPS, ... -> empty NOERROR
+  uint32_t rejected;      // malformed, responses, unsupported opcodes
+  uint32_t maxBurst;      // most queries drained in a single process()
+  uint64_t busyUs;        // time spent parsing + answering
+  // Forwarding mode
+  uint32_t forwarded;     // cache misses sent upstream
+  uint32_t upstreamReplies;
+  uint32_t upstreamTimeouts;
+  uint32_t pendingFull;   // dropped: no free pending slot
+  uint32_t upstreamRejected; // reply from the wrong source, or not matching a query
+  uint64_t upstreamUs;    // sum of upstream round trips
+  uint64_t hitUs;         // sum of time to answer a cache hit
+};
+
+class CaptiveDns {
+ public:
+  bool   begin(IPAddress ip, uint16_t port = 53, uint32_t ttl = 60);
+  void   stop();
+  size_t process();       // returns number of queries handled this call
+
+  // Non-zero address enables forwarding; IPAddress() returns to wildcard mode
+  void      setUpstream(IPAddress resolver);
+  IPAddress upstream() const { return upstreamIP_; }
+  bool      forwarding() const { return forwarding_; }
+
+  const CaptiveDnsStats& stats() const { return stats_; }
+  const DnsCacheStats&   cacheStats() const { return cache_.stats(); }
+  void resetStats() { memset(&stats_, 0, sizeof(stats_)); cache_.resetStats(); }
+
+ private:
+  struct Pending {
+    bool      used;
+    uint16_t  upstreamId;
+    uint16_t  qlen;        // forwarded question, for matching the reply
+    uint32_t  qhash;
+    uint16_t  clientId;
+    IPAddress client;
+    uint16_t  clientPort;
+    uint32_t  sentMs;
+    uint32_t  sentUs;
+  };
+
+  size_t handleQuery(size_t len);
+  size_t buildCaptiveResponse(size_t len, size_t qend);
+  bool   forwardQuery(size_t len);
+  void   drainUpstream();
+  void   expirePending();
+  void   reply(IPAddress ip, uint16_t port, size_t len);
+
+  WiFiUDP         udp_;
+  WiFiUDP         upstreamUdp_;
+  bool            running_ = false;
+  bool            forwarding_ = false;
+  IPAddress       upstreamIP_;
+  Pending         pending_[CAPTIVE_DNS_MAX_PENDING] = {};
+  DnsCache        cache_;
+  uint8_t         answer_[16];   // name ptr, type, class, ttl, rdlen, rdata
+  uint8_t         buf_[CAPTIVE_DNS_MAX_PACKET];
+  CaptiveDnsStats stats_ = {};
+};
+
+#endif // CAPTIVE_DNS_H
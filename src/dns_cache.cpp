@@ -0,0 +1,166 @@
+#include "dns_cache.h"
+
+static const size_t   DNS_HEADER_LEN = 12;
+static const uint16_t DNS_TYPE_SOA   = 6;
+static const uint16_t DNS_TYPE_OPT   = 41;
+
+static inline uint16_t rd16(const uint8_t* p) { return (uint16_t)(p[0] << 8) | p[1]; }
+static inline uint32_t rd32(const uint8_t* p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+static inline void wr32(uint8_t* p, uint32_t v) {
+  p[0] = v >> 24; p[1] = v >> 16; p[2] = v >> 8; p[3] = v;
+}
+static inline uint8_t lower(uint8_t c) { return (c >= 'A' && c <= 'Z') ? c + 32 : c; }
+
+// Skips a (possibly compressed) name starting at `pos`; returns the offset
+// just past it or 0 if it runs off the packet.
+static size_t skipName(const uint8_t* pkt, size_t len, size_t pos) {
+  while (pos < len) {
+    uint8_t l = pkt[pos];
+    if (l == 0) return pos + 1;
+    if ((l & 0xC0) == 0xC0) return pos + 2 <= len ? pos + 2 : 0;
+    pos += l + 1;
+  }
+  return 0;
+}
+
+size_t dnsQuestionLen(const uint8_t* pkt, size_t len) {
+  if (len < DNS_HEADER_LEN || rd16(&pkt[4]) != 1) return 0;
+  size_t pos = DNS_HEADER_LEN;
+  while (pos < len && pkt[pos] != 0) {
+    if (pkt[pos] & 0xC0) return 0;       // queries never compress the qname
+    pos += pkt[pos] + 1;
+  }
+  pos += 1 + 4;
+  return pos <= len ? pos - DNS_HEADER_LEN : 0;
+}
+
+// FNV-1a over the lowercased question so "Example.COM" shares a slot
+uint32_t dnsQuestionHash(const uint8_t* q, size_t qlen) {
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < qlen; ++i) {
+    h ^= lower(q[i]);
+    h *= 16777619u;
+  }
+  return h ? h : 1;
+}
+
+static bool sameQuestion(const uint8_t* a, const uint8_t* b, size_t qlen) {
+  for (size_t i = 0; i < qlen; ++i) {
+    if (lower(a[i]) != lower(b[i])) return false;
+  }
+  return true;
+}
+
+// Walks every RR after the question and calls fn(ttlOffset, type, section)
+// where section is 0 = answer, 1 = authority, 2 = additional. Returns false
+// if the packet is malformed.
+template <typename Fn>
+static bool forEachRr(const uint8_t* pkt, size_t len, size_t qend, Fn fn) {
+  uint16_t counts[3] = { rd16(&pkt[6]), rd16(&pkt[8]), rd16(&pkt[10]) };
+  size_t pos = qend;
+  for (uint8_t section = 0; section < 3; ++section) {
+    for (uint16_t i = 0; i < counts[section]; ++i) {
+      pos = skipName(pkt, len, pos);
+      if (pos == 0 || pos + 10 > len) return false;
+      fn(pos + 4, rd16(&pkt[pos]), section);
+      pos += 10 + rd16(&pkt[pos + 8]);
+      if (pos > len) return false;
+    }
+  }
+  return true;
+}
+
+// Subtracts `ageSec` from every TTL; OPT pseudo-records are skipped since
+// their TTL field carries EDNS flags.
+static void ageTtls(uint8_t* pkt, size_t len, size_t qend, uint32_t ageSec) {
+  forEachRr(pkt, len, qend, [&](size_t off, uint16_t type, uint8_t) {
+    if (type == DNS_TYPE_OPT) return;
+    uint32_t ttl = rd32(&pkt[off]);
+    wr32(&pkt[off], ttl > ageSec ? ttl - ageSec : 0);
+  });
+}
+
+size_t DnsCache::lookup(const uint8_t* query, size_t len, uint32_t nowMs, uint8_t* out, size_t cap) {
+  size_t qlen = dnsQuestionLen(query, len);
+  if (qlen == 0) return 0;
+  const uint8_t* q = query + DNS_HEADER_LEN;
+  uint32_t h = dnsQuestionHash(q, qlen);
+  uint8_t id0 = query[0], id1 = query[1];   // `out` may alias `query`
+
+  for (Entry& e : entries_) {
+    if (e.hash != h || e.qlen != qlen || !sameQuestion(e.data + DNS_HEADER_LEN, q, qlen)) continue;
+    uint32_t age = nowMs - e.storedMs;
+    if (age >= e.ttlMs) {
+      e.hash = 0;
+      stats_.expired++;
+      break;
+    }
+    if (e.len > cap) break;
+    memcpy(out, e.data, e.len);
+    out[0] = id0;                         // client's transaction ID
+    out[1] = id1;
+    if (age >= 1000) ageTtls(out, e.len, DNS_HEADER_LEN + qlen, age / 1000);
+    e.lastUseMs = nowMs;
+    stats_.hits++;
+    return e.len;
+  }
+  stats_.misses++;
+  return 0;
+}
+
+void DnsCache::insert(const uint8_t* resp, size_t len, uint32_t nowMs) {
+  if (len > DNS_CACHE_MAX_RESPONSE || len < DNS_HEADER_LEN) return;
+  if (resp[2] & 0x02) return;             // truncated: client will retry over TCP
+  uint8_t rcode = resp[3] & 0x0F;
+  if (rcode != 0 && rcode != 3) return;   // only NOERROR / NXDOMAIN
+
+  size_t qlen = dnsQuestionLen(resp, len);
+  if (qlen == 0) return;
+
+  // Cache lifetime: smallest answer TTL, or the SOA TTL for negative
+  // answers (RFC 2308)
+  uint32_t ttl = UINT32_MAX;
+  bool ok = forEachRr(resp, len, DNS_HEADER_LEN + qlen, [&](size_t off, uint16_t type, uint8_t section) {
+    if (section == 0 || type == DNS_TYPE_SOA) ttl = min<uint32_t>(ttl, rd32(&resp[off]));
+  });
+  if (!ok) return;
+  bool negative = rcode == 3 || rd16(&resp[6]) == 0;
+  if (negative) ttl = min<uint32_t>(ttl, DNS_CACHE_NEG_TTL);
+  if (ttl == UINT32_MAX || ttl == 0) return;
+  ttl = min<uint32_t>(ttl, DNS_CACHE_MAX_TTL);
+
+  const uint8_t* q = resp + DNS_HEADER_LEN;
+  uint32_t h = dnsQuestionHash(q, qlen);
+
+  // Reuse the slot for this question, else an empty one, else the LRU one
+  Entry* slot = nullptr;
+  for (Entry& e : entries_) {
+    if (e.hash == h && e.qlen == qlen && sameQuestion(e.data + DNS_HEADER_LEN, q, qlen)) { slot = &e; break; }
+  }
+  if (!slot) {
+    Entry* lru = &entries_[0];
+    for (Entry& e : entries_) {
+      if (e.hash == 0) { slot = &e; break; }
+      if (nowMs - e.lastUseMs > nowMs - lru->lastUseMs) lru = &e;
+    }
+    if (!slot) {
+      slot = lru;
+      stats_.evictions++;
+    }
+  }
+
+  memcpy(slot->data, resp, len);
+  slot->hash      = h;
+  slot->qlen      = qlen;
+  slot->len       = len;
+  slot->storedMs  = nowMs;
+  slot->lastUseMs = nowMs;
+  slot->ttlMs     = ttl * 1000;
+  stats_.inserts++;
+}
+
+void DnsCache::clear() {
+  for (Entry& e : entries_) e.hash = 0;
+}
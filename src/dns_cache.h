@@ -0,0 +1,56 @@
+#ifndef DNS_CACHE_H
+#define DNS_CACHE_H
+
+#include <Arduino.h>
+
+// Fixed-size LRU cache of upstream DNS responses, keyed by the question
+// section (case-insensitive name + type + class). Entries expire after the
+// smallest TTL in the response; on a hit every RR TTL is aged by the time
+// spent in the cache so clients never see stale lifetimes. NXDOMAIN and
+// empty answers are cached negatively for at most DNS_CACHE_NEG_TTL.
+
+#define DNS_CACHE_ENTRIES      24
+#define DNS_CACHE_MAX_RESPONSE 512
+#define DNS_CACHE_MAX_TTL      3600
+#define DNS_CACHE_NEG_TTL      60
+
+struct DnsCacheStats {
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t inserts;
+  uint32_t evictions;   // live entry replaced by LRU
+  uint32_t expired;     // found but past its TTL
+};
+
+class DnsCache {
+ public:
+  // `query` is a full DNS query packet. On a hit the cached response is
+  // copied into `out` with TTLs aged and the query's ID; returns its length
+  // or 0 on a miss.
+  size_t lookup(const uint8_t* query, size_t len, uint32_t nowMs, uint8_t* out, size_t cap);
+  void   insert(const uint8_t* resp, size_t len, uint32_t nowMs);
+  void   clear();
+
+  const DnsCacheStats& stats() const { return stats_; }
+  void resetStats() { memset(&stats_, 0, sizeof(stats_)); }
+
+ private:
+  struct Entry {
+    uint32_t hash;        // 0 = empty slot
+    uint32_t storedMs;
+    uint32_t ttlMs;
+    uint32_t lastUseMs;
+    uint16_t qlen;        // question section length (starts at offset 12)
+    uint16_t len;
+    uint8_t  data[DNS_CACHE_MAX_RESPONSE];
+  };
+
+  Entry         entries_[DNS_CACHE_ENTRIES] = {};
+  DnsCacheStats stats_ = {};
+};
+
+// Shared wire-format helpers (also used by the captive responder)
+size_t   dnsQuestionLen(const uint8_t* pkt, size_t len);   // 0 if malformed
+uint32_t dnsQuestionHash(const uint8_t* q, size_t qlen);
+
+#endif // DNS_CACHE_H
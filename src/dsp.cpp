@@ -0,0 +1,87 @@
+#include <Arduino.h>
+
+#include "dsp.h"
+
+#ifdef DSP_BENCH
+// DHT22-style temperature trace (centi-degrees, 1 s apart): readings
+// quantized to 0.1 degC with sensor noise around TRACE_REF, plus the glitches
+// a DHT22 on a long cable produces - a failed read decoded as 0 (#20), a
+// two-sample checksum-garbage burst (#45-46), a sign glitch (#71) and a
+// single spike (#88).
+static const int16_t TRACE_RAW[] = {
+  2310, 2320, 2310, 2310, 2310, 2320, 2330, 2320, 2330, 2330, 2330, 2330, 2310,
+  2330, 2330, 2330, 2310, 2310, 2320, 2320, 0, 2320, 2330, 2320, 2320, 2320,
+  2310, 2330, 2320, 2330, 2310, 2310, 2310, 2310, 2320, 2310, 2310, 2300, 2310,
+  2320, 2300, 2310, 2310, 2300, 2310, 8510, 8510, 2310, 2320, 2310, 2330, 2320,
+  2310, 2340, 2340, 2340, 2350, 2340, 2340, 2330, 2350, 2340, 2350, 2340, 2350,
+  2360, 2370, 2350, 2350, 2370, 2380, -400, 2350, 2350, 2380, 2370, 2360, 2380,
+  2380, 2380, 2380, 2380, 2390, 2380, 2380, 2380, 2360, 2390, 3310, 2380, 2360,
+  2370, 2380, 2360, 2370, 2390
+};
+static const int16_t TRACE_REF[] = {
+  2310, 2312, 2313, 2315, 2317, 2318, 2320, 2321, 2322, 2323, 2324, 2325, 2326,
+  2326, 2327, 2327, 2327, 2327, 2327, 2326, 2325, 2325, 2324, 2323, 2322, 2321,
+  2320, 2319, 2317, 2316, 2315, 2314, 2313, 2312, 2311, 2311, 2310, 2310, 2310,
+  2310, 2310, 2310, 2311, 2311, 2312, 2314, 2315, 2316, 2318, 2320, 2322, 2324,
+  2327, 2329, 2332, 2334, 2337, 2340, 2342, 2345, 2348, 2350, 2353, 2355, 2357,
+  2360, 2362, 2364, 2365, 2367, 2368, 2370, 2371, 2372, 2373, 2373, 2374, 2374,
+  2374, 2374, 2374, 2374, 2374, 2374, 2374, 2374, 2374, 2374, 2373, 2373, 2374,
+  2374, 2374, 2375, 2376, 2376
+};
+static const uint16_t TRACE_LEN = sizeof(TRACE_RAW) / sizeof(TRACE_RAW[0]);
+
+static const FilterConfig BENCH_CHAIN = {
+  FILTER_OUTLIER | FILTER_MEDIAN | FILTER_KALMAN, 300, 3, 16384, 16, 100
+};
+
+// Replays the trace `iterations` times through a fresh filter per pass;
+// the error figures come from the first pass.
+template <typename Make, typename Step>
+static DspBenchFilter runFilter(const char* name, uint16_t iterations, Make make, Step step) {
+  DspBenchFilter r = { name, 0, 0, 0 };
+  uint64_t cycles = 0;
+  uint64_t sq = 0;
+  for (uint16_t it = 0; it < iterations; ++it) {
+    auto f = make();
+    for (uint16_t i = 0; i < TRACE_LEN; ++i) {
+      uint32_t t0 = ESP.getCycleCount();
+      int32_t y = step(f, TRACE_RAW[i]);
+      cycles += ESP.getCycleCount() - t0;
+      if (it == 0) {
+        uint32_t err = abs(y - TRACE_REF[i]);
+        sq += (uint64_t)err * err;
+        if (err > r.maxError) r.maxError = err;
+      }
+    }
+  }
+  r.cycles = cycles / ((uint32_t)iterations * TRACE_LEN);
+  uint32_t mean = sq / TRACE_LEN;
+  uint32_t root = 0;   // integer sqrt
+  while ((root + 1) * (root + 1) <= mean) root++;
+  r.rmsError = root;
+  return r;
+}
+
+DspBenchResult dspBenchmark(uint16_t iterations) {
+  if (iterations == 0) iterations = 1;
+  DspBenchResult r;
+  r.traceLen = TRACE_LEN;
+  r.filters[0] = runFilter("raw", iterations,
+      [] { return 0; }, [](int, int32_t x) { return x; });
+  r.filters[1] = runFilter("outlier", iterations,
+      [] { return OutlierReject(300, 3); },
+      [](OutlierReject& f, int32_t x) { int32_t y; f.process(x, &y); return y; });
+  r.filters[2] = runFilter("median5", iterations,
+      [] { return MedianFilter<5>(); }, [](MedianFilter<5>& f, int32_t x) { return f.process(x); });
+  r.filters[3] = runFilter("average8", iterations,
+      [] { return MovingAverage<8>(); }, [](MovingAverage<8>& f, int32_t x) { return f.process(x); });
+  r.filters[4] = runFilter("ema", iterations,
+      [] { return Ema(16384); }, [](Ema& f, int32_t x) { return f.process(x); });
+  r.filters[5] = runFilter("kalman", iterations,
+      [] { return Kalman1D(16, 100); }, [](Kalman1D& f, int32_t x) { return f.process(x); });
+  r.filters[6] = runFilter("chain", iterations,
+      [] { return FilterChain<5, 8>(BENCH_CHAIN); },
+      [](FilterChain<5, 8>& f, int32_t x) { return f.process(x); });
+  return r;
+}
+#endif
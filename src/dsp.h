@@ -0,0 +1,212 @@
+#ifndef DSP_H
+#define DSP_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// Fixed-point signal conditioning for sensor channels. Plain C/C++ only
+// (no Arduino headers), so the native test env builds it too.
+//
+// Values are int32 in the channel's own scaled unit (e.g. centi-degrees);
+// nothing here touches floating point. Window sizes are template
+// parameters, so every filter's state is a fixed-size member and a chain
+// costs no heap.
+//
+// FilterChain runs the enabled stages in a fixed order:
+//
+//   outlier rejection -> median-of-N -> moving average -> EMA -> 1-D Kalman
+//
+// and which stages run (and their parameters) is per-channel runtime
+// configuration (FilterConfig).
+
+// Drops samples that jump more than `threshold` from the last accepted
+// value. After `maxReject` consecutive rejections the new level is
+// accepted, so a genuine step change gets through with a short delay.
+class OutlierReject {
+ public:
+  OutlierReject(int32_t threshold = 0, uint8_t maxReject = 3)
+      : threshold_(threshold), maxReject_(maxReject) {}
+  // Returns false if `x` was rejected (*out then holds the last good value)
+  bool process(int32_t x, int32_t* out) {
+    if (!primed_ || abs(x - last_) <= threshold_ || ++run_ > maxReject_) {
+      primed_ = true;
+      last_ = x;
+      run_ = 0;
+      *out = x;
+      return true;
+    }
+    rejected_++;
+    *out = last_;
+    return false;
+  }
+  uint32_t rejected() const { return rejected_; }
+  void reset() { primed_ = false; run_ = 0; }
+
+ private:
+  int32_t  threshold_;
+  uint8_t  maxReject_;
+  uint8_t  run_ = 0;
+  bool     primed_ = false;
+  int32_t  last_ = 0;
+  uint32_t rejected_ = 0;
+};
+
+// Median of the last N samples (N odd). Until N samples have been seen,
+// the median of those available.
+template <uint8_t N>
+class MedianFilter {
+  static_assert(N % 2 == 1 && N <= 15, "median window must be odd and small");
+
+ public:
+  int32_t process(int32_t x) {
+    win_[pos_] = x;
+    pos_ = (pos_ + 1) % N;
+    if (count_ < N) count_++;
+    int32_t s[N];
+    for (uint8_t i = 0; i < count_; ++i) {   // insertion sort, N is tiny
+      int32_t v = win_[i];
+      uint8_t j = i;
+      for (; j > 0 && s[j - 1] > v; --j) s[j] = s[j - 1];
+      s[j] = v;
+    }
+    return s[count_ / 2];
+  }
+  void reset() { count_ = 0; pos_ = 0; }
+
+ private:
+  int32_t win_[N];
+  uint8_t pos_ = 0;
+  uint8_t count_ = 0;
+};
+
+// Mean of the last N samples, O(1) per sample via a running sum
+template <uint8_t N>
+class MovingAverage {
+ public:
+  int32_t process(int32_t x) {
+    if (count_ == N) sum_ -= win_[pos_];
+    else             count_++;
+    win_[pos_] = x;
+    sum_ += x;
+    pos_ = (pos_ + 1) % N;
+    return (int32_t)((sum_ + (sum_ >= 0 ? count_ / 2 : -(int64_t)(count_ / 2))) / count_);
+  }
+  void reset() { count_ = 0; pos_ = 0; sum_ = 0; }
+
+ private:
+  int32_t win_[N];
+  int64_t sum_ = 0;
+  uint8_t pos_ = 0;
+  uint8_t count_ = 0;
+};
+
+// Exponential smoothing y += alpha * (x - y), alpha in Q16 (65536 = 1.0).
+// The state keeps 16 fractional bits so small alphas do not stall.
+class Ema {
+ public:
+  explicit Ema(uint32_t alphaQ16 = 65536) : alpha_(alphaQ16) {}
+  int32_t process(int32_t x) {
+    int64_t xq = (int64_t)x << 16;
+    if (!primed_) { y_ = xq; primed_ = true; }
+    else          y_ += ((xq - y_) * alpha_) >> 16;
+    return (int32_t)((y_ + (1 << 15)) >> 16);
+  }
+  void reset() { primed_ = false; }
+
+ private:
+  uint32_t alpha_;
+  int64_t  y_ = 0;
+  bool     primed_ = false;
+};
+
+// Scalar Kalman filter for a slowly drifting level: process noise `q` and
+// measurement noise `r` are variances in (channel unit)^2. State and
+// variance carry 8 fractional bits.
+class Kalman1D {
+ public:
+  Kalman1D(uint32_t q = 1, uint32_t r = 1) : q_((int64_t)q << 8), r_((int64_t)r << 8) {}
+  int32_t process(int32_t z) {
+    int64_t zq = (int64_t)z << 8;
+    if (!primed_) {
+      x_ = zq;
+      p_ = r_;
+      primed_ = true;
+    } else {
+      p_ += q_;
+      int64_t kQ16 = (p_ << 16) / (p_ + r_);        // gain in Q16
+      x_ += ((zq - x_) * kQ16) >> 16;
+      p_ = (p_ * (65536 - kQ16)) >> 16;
+      if (p_ < 1) p_ = 1;
+    }
+    return (int32_t)((x_ + 128) >> 8);
+  }
+  void reset() { primed_ = false; }
+
+ private:
+  int64_t q_, r_;
+  int64_t x_ = 0, p_ = 0;
+  bool    primed_ = false;
+};
+
+enum FilterStage : uint8_t {
+  FILTER_OUTLIER = 1 << 0,
+  FILTER_MEDIAN  = 1 << 1,
+  FILTER_AVERAGE = 1 << 2,
+  FILTER_EMA     = 1 << 3,
+  FILTER_KALMAN  = 1 << 4,
+};
+
+struct FilterConfig {
+  uint8_t  stages;            // FilterStage bits
+  int32_t  outlierThreshold;  // channel units
+  uint8_t  outlierMaxReject;
+  uint32_t emaAlphaQ16;
+  uint32_t kalmanQ;           // channel units^2
+  uint32_t kalmanR;
+};
+
+template <uint8_t MedianN = 5, uint8_t AverageN = 8>
+class FilterChain {
+ public:
+  explicit FilterChain(const FilterConfig& cfg)
+      : cfg_(cfg), outlier_(cfg.outlierThreshold, cfg.outlierMaxReject),
+        ema_(cfg.emaAlphaQ16), kalman_(cfg.kalmanQ, cfg.kalmanR) {}
+
+  int32_t process(int32_t x) {
+    if (cfg_.stages & FILTER_OUTLIER) outlier_.process(x, &x);
+    if (cfg_.stages & FILTER_MEDIAN)  x = median_.process(x);
+    if (cfg_.stages & FILTER_AVERAGE) x = average_.process(x);
+    if (cfg_.stages & FILTER_EMA)     x = ema_.process(x);
+    if (cfg_.stages & FILTER_KALMAN)  x = kalman_.process(x);
+    return x;
+  }
+  uint32_t rejected() const { return outlier_.rejected(); }
+
+ private:
+  FilterConfig              cfg_;
+  OutlierReject             outlier_;
+  MedianFilter<MedianN>     median_;
+  MovingAverage<AverageN>   average_;
+  Ema                       ema_;
+  Kalman1D                  kalman_;
+};
+
+#ifdef DSP_BENCH
+// Cycles per sample for each filter, and each filter's error against the
+// clean reference of a DHT22-style temperature trace with glitches
+// (see dsp.cpp); values in centi-degrees.
+struct DspBenchFilter {
+  const char* name;
+  uint32_t    cycles;
+  uint32_t    rmsError;
+  uint32_t    maxError;
+};
+#define DSP_BENCH_FILTERS 7
+struct DspBenchResult {
+  uint16_t       traceLen;
+  DspBenchFilter filters[DSP_BENCH_FILTERS];
+};
+DspBenchResult dspBenchmark(uint16_t iterations);
+#endif
+
+#endif // DSP_H
@@ -0,0 +1,479 @@
+#include "http_server.h"
+#include "arena.h"
+
+// ===================== Helpers ============================
+static const char* statusText(int code) {
+  switch (code) {
+    case 200: return "OK";
+    case 202: return "Accepted";
+    case 204: return "No Content";
+    case 301: return "Moved Permanently";
+    case 302: return "Found";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 413: return "Payload Too Large";
+    case 429: return "Too Many Requests";
+    case 431: return "Request Header Fields Too Large";
+    case 500: return "Internal Server Error";
+    case 503: return "Service Unavailable";
+    default:  return "";
+  }
+}
+
+static HTTPMethod parseMethod(const char* m) {
+  if (!strcmp(m, "GET"))     return HTTP_GET;
+  if (!strcmp(m, "POST"))    return HTTP_POST;
+  if (!strcmp(m, "HEAD"))    return HTTP_HEAD;
+  if (!strcmp(m, "PUT"))     return HTTP_PUT;
+  if (!strcmp(m, "DELETE"))  return HTTP_DELETE;
+  if (!strcmp(m, "OPTIONS")) return HTTP_OPTIONS;
+  if (!strcmp(m, "PATCH"))   return HTTP_PATCH;
+  return HTTP_ANY;   // unknown: only matches HTTP_ANY routes
+}
+
+static int hexVal(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// In-place %xx / '+' decoding
+static void urlDecode(char* s) {
+  char* o = s;
+  for (; *s; ++s) {
+    int hi, lo;
+    if (*s == '+') {
+      *o++ = ' ';
+    } else if (*s == '%' && (hi = hexVal(s[1])) >= 0 && (lo = hexVal(s[2])) >= 0) {
+      *o++ = (char)(hi << 4 | lo);
+      s += 2;
+    } else {
+      *o++ = *s;
+    }
+  }
+  *o = '\0';
+}
+
+static char* trim(char* s) {
+  while (*s == ' ' || *s == '\t') s++;
+  char* e = s + strlen(s);
+  while (e > s && (e[-1] == ' ' || e[-1] == '\t')) *--e = '\0';
+  return s;
+}
+
+// Offset just past "\r\n\r\n", or 0 if the headers are not complete yet
+static size_t headerEnd(const char* buf, size_t len) {
+  for (size_t i = 3; i < len; i++) {
+    if (buf[i] == '\n' && buf[i - 1] == '\r' && buf[i - 2] == '\n' && buf[i - 3] == '\r') return i + 1;
+  }
+  return 0;
+}
+
+// Content-Length from the raw (not yet split) header block; 0 if absent
+static long rawContentLength(const char* buf, size_t end) {
+  static const char NAME[] = "\r\ncontent-length:";
+  const size_t n = sizeof(NAME) - 1;
+  for (size_t i = 0; i + n <= end; i++) {
+    if (strncasecmp(buf + i, NAME, n) == 0) return strtol(buf + i + n, nullptr, 10);
+  }
+  return 0;
+}
+
+// ===================== Server =============================
+HttpServer::HttpServer(uint16_t port) : server_(port, HTTP_MAX_CONNS) {
+  for (Conn& c : conns_) {
+    c.open = false;
+    c.backlog = false;
+    c.len = 0;
+  }
+}
+
+void HttpServer::begin() {
+  server_.begin();
+  server_.setNoDelay(true);
+}
+
+void HttpServer::on(const char* uri, HTTPMethod method, THandlerFunction fn) {
+  if (routeCount_ >= HTTP_MAX_ROUTES) return;
+  routes_[routeCount_++] = { uri, method, fn };
+}
+
+uint8_t HttpServer::openConnections() const {
+  uint8_t n = 0;
+  for (const Conn& c : conns_) n += c.open;
+  return n;
+}
+
+void HttpServer::resetStats() {
+  stats_ = {};
+  stats_.maxOpen = openConnections();
+}
+
+void HttpServer::closeConn(Conn& c) {
+  c.client.stop();
+  c.open = false;
+  c.backlog = false;
+  c.len = 0;
+}
+
+void HttpServer::acceptClients() {
+  for (int i = 0; i < HTTP_MAX_CONNS && server_.hasClient(); i++) {
+    WiFiClient nc = server_.accept();
+    if (!nc) return;
+    stats_.accepted++;
+
+    Conn* slot = nullptr;
+    for (Conn& c : conns_) {
+      if (!c.open) { slot = &c; break; }
+    }
+    if (!slot) {
+      // Reuse the longest-idle connection that has nothing in flight
+      for (Conn& c : conns_) {
+        if (c.len == 0 && (!slot || (int32_t)(c.lastActiveMs - slot->lastActiveMs) < 0)) slot = &c;
+      }
+      if (!slot) {
+        stats_.rejected++;
+        static const char BUSY[] = "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        nc.write((const uint8_t*)BUSY, sizeof(BUSY) - 1);
+        nc.stop();
+        continue;
+      }
+      stats_.evicted++;
+      closeConn(*slot);
+    }
+
+    nc.setNoDelay(true);
+    slot->client = nc;
+    slot->open = true;
+    slot->backlog = false;
+    slot->len = 0;
+    slot->requests = 0;
+    slot->lastActiveMs = millis();
+    uint8_t open = openConnections();
+    if (open > stats_.maxOpen) stats_.maxOpen = open;
+  }
+}
+
+void HttpServer::handleClient() {
+  uint32_t t0 = micros();
+  bool worked = server_.hasClient();
+  if (worked) acceptClients();
+
+  uint32_t now = millis();
+  for (Conn& c : conns_) {
+    if (!c.open) continue;
+
+    int avail = c.client.available();
+    if (avail > 0) {
+      size_t room = HTTP_REQ_BUF - c.len;
+      if (room > 0) {
+        int n = c.client.read((uint8_t*)c.buf + c.len, min((size_t)avail, room));
+        if (n > 0) c.len += n;
+      }
+      c.lastActiveMs = now;
+    } else if (!c.backlog) {
+      if (!c.client.connected()) {
+        closeConn(c);
+      } else if (now - c.lastActiveMs > HTTP_IDLE_TIMEOUT_MS) {
+        stats_.closedIdle++;
+        closeConn(c);
+      }
+      continue;
+    }
+    worked = true;
+    c.backlog = false;
+
+    // Answer every complete request already buffered (pipelining), a few
+    // per call so one client cannot starve the others
+    int k = 0;
+    for (; k < HTTP_MAX_PIPELINE && c.open && c.len > 0; k++) {
+      int used = parseRequest(c);
+      if (used == 0) break;
+      if (used < 0) {
+        stats_.badRequests++;
+        sendError(c, -used);
+        closeConn(c);
+        break;
+      }
+      if (k > 0) stats_.pipelined++;
+      if (c.requests > 0) stats_.reused++;
+      stats_.requests++;
+
+      // The body is NUL-terminated in place for arg("plain"); the byte it
+      // overwrites may be the start of the next pipelined request.
+      char saved = c.buf[used];
+      c.buf[used] = '\0';
+      cur_ = &c;
+      dispatch();
+      finishResponse();
+      if (arena_) arena_->reset();
+      cur_ = nullptr;
+      c.buf[used] = saved;
+      c.requests++;
+
+      if (!keepAlive_) {
+        closeConn(c);
+        break;
+      }
+      memmove(c.buf, c.buf + used, c.len - used);
+      c.len -= used;
+    }
+    if (c.open && k == HTTP_MAX_PIPELINE && c.len > 0) c.backlog = true;
+  }
+
+  if (worked) stats_.busyUs += micros() - t0;
+}
+
+// ===================== Request parsing =====================
+int HttpServer::parseRequest(Conn& c) {
+  size_t end = headerEnd(c.buf, c.len);
+  if (end == 0) return c.len >= HTTP_REQ_BUF ? -431 : 0;
+  long bodyLen = rawContentLength(c.buf, end);
+  if (bodyLen < 0 || end + bodyLen > HTTP_REQ_BUF) return -413;
+  if (c.len < end + bodyLen) return 0;
+
+  // Complete: split in place
+  headerCount_ = 0;
+  argCount_ = 0;
+  c.buf[end - 2] = '\0';
+  char* save = nullptr;
+  char* line = strtok_r(c.buf, "\r\n", &save);
+  if (!line) return -400;
+
+  char* sp1 = strchr(line, ' ');
+  char* sp2 = sp1 ? strchr(sp1 + 1, ' ') : nullptr;
+  if (!sp1 || !sp2) return -400;
+  *sp1 = '\0';
+  *sp2 = '\0';
+  method_ = parseMethod(line);
+  head_ = method_ == HTTP_HEAD;
+  path_ = sp1 + 1;
+  http11_ = strcmp(sp2 + 1, "HTTP/1.0") != 0;
+
+  while ((line = strtok_r(nullptr, "\r\n", &save)) != nullptr) {
+    char* colon = strchr(line, ':');
+    if (!colon || headerCount_ >= HTTP_MAX_HEADERS) continue;
+    *colon = '\0';
+    headers_[headerCount_++] = { trim(line), trim(colon + 1) };
+  }
+
+  char* query = strchr(path_, '?');
+  if (query) *query++ = '\0';
+  urlDecode(path_);
+
+  // key=value&... from the query string and url-encoded form bodies
+  auto parseArgs = [this](char* s) {
+    char* save2 = nullptr;
+    for (char* kv = strtok_r(s, "&", &save2); kv && argCount_ < HTTP_MAX_ARGS;
+         kv = strtok_r(nullptr, "&", &save2)) {
+      char* eq = strchr(kv, '=');
+      if (eq) *eq++ = '\0';
+      urlDecode(kv);
+      if (eq) urlDecode(eq);
+      args_[argCount_++] = { kv, eq ? eq : "" };
+    }
+  };
+  if (query) parseArgs(query);
+
+  char* body = c.buf + end;
+  if (bodyLen > 0) {
+    static const char FORM_TYPE[] = "application/x-www-form-urlencoded";
+    const char* type = headerValue("Content-Type");
+    if (type && strncasecmp(type, FORM_TYPE, sizeof(FORM_TYPE) - 1) == 0) {
+      char saved = body[bodyLen];
+      body[bodyLen] = '\0';
+      parseArgs(body);
+      body[bodyLen] = saved;
+    } else if (argCount_ < HTTP_MAX_ARGS) {
+      args_[argCount_++] = { "plain", body };   // NUL-terminated by handleClient()
+    }
+  }
+
+  const char* conn = headerValue("Connection");
+  keepAlive_ = http11_ ? !(conn && strcasecmp(conn, "close") == 0)
+                       : (conn && strcasecmp(conn, "keep-alive") == 0);
+  if (c.requests + 1 >= HTTP_MAX_REQUESTS) keepAlive_ = false;
+  return (int)(end + bodyLen);
+}
+
+String HttpServer::arg(const char* name) const {
+  const char* v = argValue(name);
+  return v ? String(v) : String();
+}
+
+const char* HttpServer::argValue(const char* name) const {
+  for (size_t i = 0; i < argCount_; i++) {
+    if (strcmp(args_[i].key, name) == 0) return args_[i].value;
+  }
+  return nullptr;
+}
+
+bool HttpServer::hasArg(const char* name) const {
+  for (size_t i = 0; i < argCount_; i++) {
+    if (strcmp(args_[i].key, name) == 0) return true;
+  }
+  return false;
+}
+
+String HttpServer::header(const char* name) const {
+  const char* v = headerValue(name);
+  return v ? String(v) : String();
+}
+
+const char* HttpServer::headerValue(const char* name) const {
+  for (size_t i = 0; i < headerCount_; i++) {
+    if (strcasecmp(headers_[i].key, name) == 0) return headers_[i].value;
+  }
+  return nullptr;
+}
+
+bool HttpServer::hasHeader(const char* name) const {
+  for (size_t i = 0; i < headerCount_; i++) {
+    if (strcasecmp(headers_[i].key, name) == 0) return true;
+  }
+  return false;
+}
+
+void HttpServer::dispatch() {
+  respHeadersLen_ = 0;
+  contentLength_ = CONTENT_LENGTH_NOT_SET;
+  responded_ = chunked_ = chunkedDone_ = false;
+  outLen_ = 0;
+
+  HTTPMethod m = head_ ? HTTP_GET : method_;   // HEAD runs the GET handler, body dropped
+  for (size_t i = 0; i < routeCount_; i++) {
+    const Route& r = routes_[i];
+    if ((r.method == HTTP_ANY || r.method == m) && strcmp(r.uri, path_) == 0) {
+      r.fn();
+      return;
+    }
+  }
+  if (notFound_) notFound_();
+  else           send(404, "text/plain", "Not Found");
+}
+
+// ===================== Response ===========================
+void HttpServer::flush() {
+  if (outLen_ == 0 || !cur_) return;
+  if (cur_->client.write((const uint8_t*)out_, outLen_) != outLen_) keepAlive_ = false;
+  outLen_ = 0;
+}
+
+void HttpServer::write(const char* data, size_t len) {
+  if (outLen_ + len <= sizeof(out_)) {
+    memcpy(out_ + outLen_, data, len);
+    outLen_ += len;
+    return;
+  }
+  flush();
+  if (len > sizeof(out_)) {
+    if (cur_->client.write((const uint8_t*)data, len) != len) keepAlive_ = false;
+  } else {
+    memcpy(out_, data, len);
+    outLen_ = len;
+  }
+}
+
+void HttpServer::sendHeader(const char* name, const char* value, bool first) {
+  size_t nameLen = strlen(name), valueLen = strlen(value);
+  size_t len = nameLen + 2 + valueLen + 2;
+  if (respHeadersLen_ + len > sizeof(respHeaders_)) return;
+  char* h = respHeaders_ + respHeadersLen_;
+  if (first) {
+    memmove(respHeaders_ + len, respHeaders_, respHeadersLen_);
+    h = respHeaders_;
+  }
+  memcpy(h, name, nameLen);
+  memcpy(h + nameLen, ": ", 2);
+  memcpy(h + nameLen + 2, value, valueLen);
+  memcpy(h + len - 2, "\r\n", 2);
+  respHeadersLen_ += len;
+}
+
+void HttpServer::beginResponse(int code, const char* contentType, size_t bodyLen) {
+  responded_ = true;
+  char line[96];
+  snprintf(line, sizeof(line), "HTTP/1.%d %d %s\r\n", http11_ ? 1 : 0, code, statusText(code));
+  writeStr(line);
+  if (contentType && *contentType) {
+    writeStr("Content-Type: ");
+    writeStr(contentType);
+    writeStr("\r\n");
+  }
+  write(respHeaders_, respHeadersLen_);
+
+  if (contentLength_ == CONTENT_LENGTH_UNKNOWN) {
+    // Chunked keeps the connection usable; 1.0 clients get close-delimited
+    if (http11_) {
+      chunked_ = true;
+      writeStr("Transfer-Encoding: chunked\r\n");
+    } else {
+      keepAlive_ = false;
+    }
+  } else {
+    snprintf(line, sizeof(line), "Content-Length: %u\r\n",
+             (unsigned)(contentLength_ != CONTENT_LENGTH_NOT_SET ? contentLength_ : bodyLen));
+    writeStr(line);
+  }
+  if (keepAlive_) {
+    snprintf(line, sizeof(line), "Connection: keep-alive\r\nKeep-Alive: timeout=%u, max=%u\r\n\r\n",
+             HTTP_IDLE_TIMEOUT_MS / 1000, HTTP_MAX_REQUESTS - cur_->requests - 1);
+    writeStr(line);
+  } else {
+    writeStr("Connection: close\r\n\r\n");
+  }
+}
+
+void HttpServer::send(int code, const char* contentType, const char* content) {
+  if (responded_ || !cur_) return;
+  size_t len = content ? strlen(content) : 0;
+  beginResponse(code, contentType, len);
+  if (len > 0) sendContent(content, len);
+}
+
+void HttpServer::send(int code, const char* contentType, const String& content) {
+  if (responded_ || !cur_) return;
+  beginResponse(code, contentType, content.length());
+  if (content.length() > 0) sendContent(content.c_str(), content.length());
+}
+
+void HttpServer::send_P(int code, const char* contentType, const char* content, size_t len) {
+  if (responded_ || !cur_) return;
+  beginResponse(code, contentType, len);
+  if (len > 0) sendContent(content, len);
+}
+
+void HttpServer::sendContent(const char* data, size_t len) {
+  if (!cur_ || head_ || chunkedDone_) return;
+  if (!responded_) beginResponse(200, nullptr, 0);
+  if (!chunked_) {
+    write(data, len);
+    return;
+  }
+  if (len == 0) {
+    writeStr("0\r\n\r\n");
+    chunkedDone_ = true;
+    return;
+  }
+  char size[12];
+  snprintf(size, sizeof(size), "%x\r\n", (unsigned)len);
+  writeStr(size);
+  write(data, len);
+  writeStr("\r\n");
+}
+
+void HttpServer::finishResponse() {
+  if (!responded_) send(500, "text/plain", "Handler sent no response");
+  if (chunked_ && !chunkedDone_ && !head_) sendContent("", 0);
+  flush();
+}
+
+void HttpServer::sendError(Conn& c, int code) {
+  char resp[128];
+  int n = snprintf(resp, sizeof(resp), "HTTP/1.1 %d %s\r\nContent-Length: 0\r\nConnection: close\r\n\r\n",
+                   code, statusText(code));
+  c.client.write((const uint8_t*)resp, n);
+}
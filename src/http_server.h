@@ -0,0 +1,162 @@
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <HTTP_Method.h>
+#include <functional>
+
+class Arena;
+
+// Small HTTP/1.1 server for the dashboard and API.
+//
+// Exposes the subset of the Arduino WebServer API that main.cpp uses, but
+// keeps connections open: up to HTTP_MAX_CONNS clients stay connected
+// between requests (closed after HTTP_IDLE_TIMEOUT_MS idle, or evicted
+// oldest-first when a new client needs the slot), pipelined requests already
+// in the buffer are answered in order, and unknown-length responses use
+// chunked encoding so the connection survives them. HTTP/1.0 clients and
+// requests with "Connection: close" get one request per connection.
+//
+// Requests are parsed in place in the connection's buffer; arg()/header()
+// values are only valid inside the handler. path()/argValue()/headerValue()
+// point into that buffer, while uri()/arg()/header() copy into a String.
+// Parsing itself does not allocate. Response headers are collected in a
+// fixed buffer, and the scratch arena set with setArena() is reset once each
+// response is written, so a handler that sticks to the pointer accessors
+// and builds its response in the arena makes no heap allocations of its own.
+
+#define HTTP_MAX_CONNS        6
+#define HTTP_REQ_BUF          1536   // request line + headers + body
+#define HTTP_OUT_BUF          1436   // coalesces headers and small bodies into one segment
+#define HTTP_MAX_HEADERS      16
+#define HTTP_MAX_ARGS         12
+#define HTTP_MAX_ROUTES       32
+#define HTTP_RESP_HEADER_BUF  256    // sendHeader() lines of one response
+#define HTTP_IDLE_TIMEOUT_MS  5000
+#define HTTP_MAX_REQUESTS     100    // per connection, then "Connection: close"
+#define HTTP_MAX_PIPELINE     4      // requests answered per connection per handleClient()
+
+#ifndef CONTENT_LENGTH_UNKNOWN
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+#endif
+#ifndef CONTENT_LENGTH_NOT_SET
+#define CONTENT_LENGTH_NOT_SET ((size_t)-2)
+#endif
+
+struct HttpServerStats {
+  uint32_t accepted;      // TCP connections
+  uint32_t requests;
+  uint32_t reused;        // requests served on an already-used connection
+  uint32_t pipelined;     // requests that were already buffered behind another
+  uint32_t closedIdle;
+  uint32_t evicted;       // idle connection closed to make room for a new one
+  uint32_t rejected;      // every slot busy -> 503
+  uint32_t badRequests;
+  uint32_t maxOpen;
+  uint64_t busyUs;        // handleClient() time spent accepting, parsing, handling, writing
+};
+
+class HttpServer {
+ public:
+  typedef std::function<void(void)> THandlerFunction;
+
+  explicit HttpServer(uint16_t port = 80);
+  void begin();
+  void handleClient();
+
+  void on(const char* uri, HTTPMethod method, THandlerFunction fn);
+  void on(const char* uri, THandlerFunction fn) { on(uri, HTTP_ANY, fn); }
+  void onNotFound(THandlerFunction fn) { notFound_ = fn; }
+  void setArena(Arena* arena) { arena_ = arena; }
+
+  // Current request (inside a handler)
+  const char* path() const { return path_; }
+  String     uri() const { return String(path_); }
+  HTTPMethod method() const { return method_; }
+  String     arg(const char* name) const;
+  bool       hasArg(const char* name) const;
+  String     header(const char* name) const;
+  bool       hasHeader(const char* name) const;
+  const char* argValue(const char* name) const;     // nullptr if absent
+  const char* headerValue(const char* name) const;  // nullptr if absent
+
+  // Response
+  void sendHeader(const char* name, const char* value, bool first = false);
+  void sendHeader(const char* name, const String& value, bool first = false) {
+    sendHeader(name, value.c_str(), first);
+  }
+  void setContentLength(size_t len) { contentLength_ = len; }
+  void send(int code, const char* contentType, const char* content);
+  void send(int code, const char* contentType, const String& content);
+  void send_P(int code, const char* contentType, const char* content, size_t len);
+  void sendContent(const char* data, size_t len);
+  void sendContent(const String& s) { sendContent(s.c_str(), s.length()); }
+  // Responses are buffered until the handler returns; a handler that must
+  // get its reply out first (e.g. before restarting) pushes it here
+  void flush();
+
+  const HttpServerStats& stats() const { return stats_; }
+  uint8_t                openConnections() const;
+  void                   resetStats();
+
+ private:
+  struct Route {
+    const char*      uri;
+    HTTPMethod       method;
+    THandlerFunction fn;
+  };
+  struct Conn {
+    WiFiClient client;
+    bool       open;
+    bool       backlog;        // complete requests left after HTTP_MAX_PIPELINE
+    uint16_t   len;            // bytes buffered
+    uint16_t   requests;       // answered on this connection
+    uint32_t   lastActiveMs;
+    char       buf[HTTP_REQ_BUF + 1];
+  };
+  struct KeyValue {
+    const char* key;
+    const char* value;
+  };
+
+  void acceptClients();
+  void closeConn(Conn& c);
+  int  parseRequest(Conn& c);   // bytes consumed, 0 = incomplete, -status on error
+  void dispatch();
+  void finishResponse();
+  void sendError(Conn& c, int code);
+  void beginResponse(int code, const char* contentType, size_t bodyLen);
+  void write(const char* data, size_t len);
+  void writeStr(const char* s) { write(s, strlen(s)); }
+
+  WiFiServer       server_;
+  Route            routes_[HTTP_MAX_ROUTES];
+  size_t           routeCount_ = 0;
+  THandlerFunction notFound_;
+  Arena*           arena_ = nullptr;
+  Conn             conns_[HTTP_MAX_CONNS];
+  HttpServerStats  stats_ = {};
+
+  // Current request/response
+  Conn*       cur_ = nullptr;
+  HTTPMethod  method_ = HTTP_GET;
+  bool        head_ = false;
+  bool        http11_ = true;
+  bool        keepAlive_ = false;
+  char*       path_ = nullptr;
+  KeyValue    headers_[HTTP_MAX_HEADERS];
+  size_t      headerCount_ = 0;
+  KeyValue    args_[HTTP_MAX_ARGS];
+  size_t      argCount_ = 0;
+  char        respHeaders_[HTTP_RESP_HEADER_BUF];
+  size_t      respHeadersLen_ = 0;
+  size_t      contentLength_ = CONTENT_LENGTH_NOT_SET;
+  bool        responded_ = false;
+  bool        chunked_ = false;
+  bool        chunkedDone_ = false;
+  char        out_[HTTP_OUT_BUF];
+  size_t      outLen_ = 0;
+};
+
+#endif // HTTP_SERVER_H
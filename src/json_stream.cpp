@@ -0,0 +1,153 @@
+#include "json_stream.h"
+#include "metrics.h"
+#include "num_format.h"
+
+JsonStream::JsonStream(HttpServer& server, int code) : server_(&server) {
+  server_->setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server_->send(code, "application/json", "");
+}
+
+void JsonStream::flush() {
+  if (len_ == 0) return;
+  for (size_t i = 0; i < len_; ++i) hash_ = (hash_ ^ (uint8_t)buf_[i]) * 16777619u;
+  if (server_) {
+    metricsHeapProbe();   // the buffer is full: the deepest point of a handler
+    server_->sendContent(buf_, len_);
+  }
+  bytes_ += len_;
+  chunks_++;
+  len_ = 0;
+}
+
+void JsonStream::put(const char* s, size_t n) {
+  while (n > 0) {
+    if (len_ == sizeof(buf_)) flush();
+    size_t take = min(n, sizeof(buf_) - len_);
+    memcpy(buf_ + len_, s, take);
+    len_ += take;
+    s += take;
+    n -= take;
+  }
+}
+
+void JsonStream::putString(const char* s) {
+  static const char hex[] = "0123456789abcdef";
+  put('"');
+  for (; *s; ++s) {
+    uint8_t c = *s;
+    if (c == '"' || c == '\\') {
+      put('\\');
+      put(c);
+    } else if (c < 0x20) {
+      char esc[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf]};
+      put(esc, sizeof(esc));
+    } else {
+      put(c);
+    }
+  }
+  put('"');
+}
+
+void JsonStream::separate(const char* key) {
+  uint32_t bit = 1u << depth_;
+  if (hasItems_ & bit) put(',');
+  hasItems_ |= bit;
+  if (key) {
+    putString(key);
+    put(':');
+  }
+}
+
+JsonStream& JsonStream::beginObject(const char* key) {
+  separate(key);
+  put('{');
+  if (depth_ < JSON_STREAM_DEPTH - 1) depth_++;
+  hasItems_ &= ~(1u << depth_);
+  return *this;
+}
+
+JsonStream& JsonStream::endObject() {
+  if (depth_ > 0) depth_--;
+  put('}');
+  return *this;
+}
+
+JsonStream& JsonStream::beginArray(const char* key) {
+  separate(key);
+  put('[');
+  if (depth_ < JSON_STREAM_DEPTH - 1) depth_++;
+  hasItems_ &= ~(1u << depth_);
+  return *this;
+}
+
+JsonStream& JsonStream::endArray() {
+  if (depth_ > 0) depth_--;
+  put(']');
+  return *this;
+}
+
+JsonStream& JsonStream::add(const char* key, const char* v) {
+  separate(key);
+  if (v) putString(v);
+  else   put("null", 4);
+  return *this;
+}
+
+JsonStream& JsonStream::add(const char* key, bool v) {
+  separate(key);
+  if (v) put("true", 4);
+  else   put("false", 5);
+  return *this;
+}
+
+JsonStream& JsonStream::add(const char* key, long long v) {
+  separate(key);
+  char num[NUM_FORMAT_MAX];
+  put(num, fmtInt64(num, v) - num);
+  return *this;
+}
+
+JsonStream& JsonStream::add(const char* key, unsigned long long v) {
+  separate(key);
+  char num[NUM_FORMAT_MAX];
+  put(num, fmtUint64(num, v) - num);
+  return *this;
+}
+
+JsonStream& JsonStream::add(const char* key, double v, uint8_t decimals) {
+  separate(key);
+  if (isnan(v) || isinf(v)) {   // not representable in JSON
+    put("null", 4);
+    return *this;
+  }
+  char num[32];
+  int n = snprintf(num, sizeof(num), "%.*f", decimals, v);
+  put(num, min(n, (int)sizeof(num) - 1));
+  return *this;
+}
+
+JsonStream& JsonStream::addFixed(const char* key, int32_t v, uint8_t decimals) {
+  separate(key);
+  char num[NUM_FORMAT_MAX];
+  put(num, fmtFixed(num, v, decimals) - num);
+  return *this;
+}
+
+JsonStream& JsonStream::addNull(const char* key) {
+  separate(key);
+  put("null", 4);
+  return *this;
+}
+
+JsonStream& JsonStream::addRaw(const char* key, const char* json, size_t len) {
+  separate(key);
+  put(json, len);
+  return *this;
+}
+
+void JsonStream::end() {
+  if (ended_) return;
+  ended_ = true;
+  flush();
+  if (server_) server_->sendContent("", 0);   // terminating chunk
+}
@@ -0,0 +1,97 @@
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+#include <Arduino.h>
+#include "http_server.h"
+
+// Streaming JSON writer for API responses.
+//
+//   JsonStream js(server);
+//   js.beginObject();
+//   js.add("count", n);
+//   js.beginArray("networks");
+//   for (...) { js.beginObject(); js.add("ssid", ssid); js.endObject(); }
+//   js.endArray();
+//   js.endObject();
+//   js.end();
+//
+// Output goes through a JSON_STREAM_BUF-byte buffer that lives inside the
+// writer (i.e. on the handler's stack); each time it fills it is sent as one
+// HTTP chunk. Nothing is built on the heap, so memory use does not grow with
+// the response, and the first bytes leave before the last element is
+// formatted. Commas and string escaping are handled by the writer; keys are
+// written as given.
+//
+// A writer constructed without a server sends nothing and only hashes the
+// output; handlers use that to derive an ETag before deciding between 304
+// and a full response (serializing twice costs CPU, not memory or airtime).
+
+#define JSON_STREAM_BUF   512
+#define JSON_STREAM_DEPTH 16
+
+class JsonStream {
+ public:
+  // Sends the status line and headers (chunked) for `code`.
+  explicit JsonStream(HttpServer& server, int code = 200);
+  JsonStream() {}   // dry run: hash() only
+  ~JsonStream() { end(); }
+
+  // `key` is used inside an object and omitted (nullptr) inside an array
+  JsonStream& beginObject(const char* key = nullptr);
+  JsonStream& endObject();
+  JsonStream& beginArray(const char* key = nullptr);
+  JsonStream& endArray();
+
+  JsonStream& add(const char* key, const char* v);
+  JsonStream& add(const char* key, const String& v) { return add(key, v.c_str()); }
+  JsonStream& add(const char* key, bool v);
+  JsonStream& add(const char* key, int v)           { return add(key, (long long)v); }
+  JsonStream& add(const char* key, unsigned v)      { return add(key, (unsigned long long)v); }
+  JsonStream& add(const char* key, long v)          { return add(key, (long long)v); }
+  JsonStream& add(const char* key, unsigned long v) { return add(key, (unsigned long long)v); }
+  JsonStream& add(const char* key, long long v);
+  JsonStream& add(const char* key, unsigned long long v);
+  JsonStream& add(const char* key, double v, uint8_t decimals = 2);
+  // Fixed-point value scaled by 10^decimals (2345, 2 -> 23.45)
+  JsonStream& addFixed(const char* key, int32_t v, uint8_t decimals);
+  JsonStream& addNull(const char* key);
+  // Pre-formatted JSON value, written verbatim
+  JsonStream& addRaw(const char* key, const char* json, size_t len);
+  // Payload struct with a generated serializer (json_struct.h), formatted
+  // in one pass on the stack
+  template <typename T>
+  JsonStream& addStruct(const char* key, const T& v) {
+    char buf[T::jsonMaxLen()];
+    return addRaw(key, buf, v.toJson(buf) - buf);
+  }
+
+  // Array elements
+  template <typename T>
+  JsonStream& item(T v) { return add(nullptr, v); }
+
+  // Flushes the buffer and sends the terminating chunk; idempotent.
+  void   end();
+  size_t bytes() const { return bytes_ + len_; }
+  size_t chunks() const { return chunks_; }
+  // FNV-1a of everything written; complete after end()
+  uint32_t hash() const { return hash_; }
+
+ private:
+  void separate(const char* key);   // comma + "key": as needed
+  void put(char c) { if (len_ == sizeof(buf_)) flush(); buf_[len_++] = c; }
+  void put(const char* s, size_t n);
+  void putString(const char* s);
+  void flush();
+
+  HttpServer* server_ = nullptr;
+  char        buf_[JSON_STREAM_BUF];
+  size_t      len_ = 0;
+  size_t      bytes_ = 0;
+  size_t      chunks_ = 0;
+  uint8_t     depth_ = 0;
+  uint32_t    hasItems_ = 0;   // bit d: container at depth d already has an element
+  uint32_t    hash_ = 2166136261u;
+  bool        ended_ = false;
+};
+
+#endif // JSON_STREAM_H
@@ -0,0 +1,252 @@
+#ifndef JSON_STRUCT_H
+#define JSON_STRUCT_H
+
+#include <Arduino.h>
+#include <type_traits>
+#include "num_format.h"
+
+// Compile-time JSON serializers for API payload structs.
+//
+//   struct SensorPayload {
+//     int32_t  tempCenti;
+//     uint32_t seq;
+//     JSON_FIELDS(SensorPayload,
+//       JSON_FIXED_AS(tempCenti, "temperature", 2),
+//       JSON_FIELD(seq))
+//   };
+//
+//   char buf[SensorPayload::jsonMaxLen()];
+//   size_t len = payload.toJson(buf) - buf;   // {"temperature":23.45,"seq":7}
+//
+// A struct lists its fields once. Each entry becomes a descriptor holding
+// the key as a ready-made `,"key":` fragment (a string literal, so its
+// length is a compile-time constant) and a member pointer. toJson() copies
+// the fragments and formats the values straight into the buffer: no
+// document, no key strings built at run time, no heap. The first field's
+// comma becomes the `{`, so optional fields cost no separator bookkeeping.
+//
+// jsonMaxLen() is the worst case over every field (a constant expression),
+// so buffers are sized exactly and the writers never check bounds. Values:
+//   integers, bool          as JSON numbers / true / false
+//   char[N]                 string, escaped, bounded by N
+//   const char*             string via JSON_STR(m, max), cut at `max` chars
+//   IPAddress               "a.b.c.d"
+//   uint8_t[6]              MAC address "AA:BB:CC:DD:EE:FF"
+//   int32_t via JSON_FIXED  scaled integer (2345, 2 -> 23.45)
+//   payload structs         nested object
+// The *_AS variants take the JSON key when it differs from the member name;
+// JSON_FIELD_IF(m, cond) writes `m` only while bool member `cond` is true.
+
+// ===== Value writers =====
+
+// Escaped, quoted string of at most `max` characters of `s`
+inline char* jsonString(char* p, const char* s, size_t max) {
+  static const char hex[] = "0123456789abcdef";
+  *p++ = '"';
+  for (size_t i = 0; i < max && s[i]; ++i) {
+    uint8_t c = s[i];
+    if (c == '"' || c == '\\') {
+      *p++ = '\\';
+      *p++ = c;
+    } else if (c < 0x20) {
+      memcpy(p, "\\u00", 4);
+      p[4] = hex[c >> 4];
+      p[5] = hex[c & 0xf];
+      p += 6;
+    } else {
+      *p++ = c;
+    }
+  }
+  *p++ = '"';
+  return p;
+}
+
+inline constexpr size_t jsonStringMaxLen(size_t max) { return 2 + 6 * max; }
+
+// Payload structs (anything with JSON_FIELDS) are nested objects
+template <typename T, typename = void>
+struct JsonValue {
+  static constexpr size_t maxLen() { return T::jsonMaxLen(); }
+  static char* write(char* p, const T& v) { return v.toJson(p); }
+};
+
+template <typename T>
+struct JsonValue<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type> {
+  static constexpr bool kSigned = std::is_signed<T>::value;
+  static constexpr size_t maxLen() {
+    return sizeof(T) > 4 ? 20 : sizeof(T) == 4 ? 10 + kSigned : sizeof(T) == 2 ? 5 + kSigned : 3 + kSigned;
+  }
+  static char* write(char* p, T v) {
+    if (sizeof(T) > 4) return kSigned ? fmtInt64(p, (int64_t)v) : fmtUint64(p, (uint64_t)v);
+    return kSigned ? fmtInt(p, (int32_t)v) : fmtUint(p, (uint32_t)v);
+  }
+};
+
+template <>
+struct JsonValue<bool> {
+  static constexpr size_t maxLen() { return 5; }
+  static char* write(char* p, bool v) {
+    if (v) { memcpy(p, "true", 4); return p + 4; }
+    memcpy(p, "false", 5);
+    return p + 5;
+  }
+};
+
+template <size_t N>
+struct JsonValue<char[N]> {
+  static constexpr size_t maxLen() { return jsonStringMaxLen(N - 1); }
+  static char* write(char* p, const char (&v)[N]) { return jsonString(p, v, N - 1); }
+};
+
+template <>
+struct JsonValue<IPAddress> {
+  static constexpr size_t maxLen() { return 17; }
+  static char* write(char* p, const IPAddress& ip) {
+    *p++ = '"';
+    for (uint8_t i = 0; i < 4; ++i) {
+      if (i) *p++ = '.';
+      p = fmtUint(p, ip[i]);
+    }
+    *p++ = '"';
+    return p;
+  }
+};
+
+template <>
+struct JsonValue<uint8_t[6]> {
+  static constexpr size_t maxLen() { return 19; }
+  static char* write(char* p, const uint8_t (&mac)[6]) {
+    static const char hex[] = "0123456789ABCDEF";
+    *p++ = '"';
+    for (uint8_t i = 0; i < 6; ++i) {
+      if (i) *p++ = ':';
+      *p++ = hex[mac[i] >> 4];
+      *p++ = hex[mac[i] & 0xf];
+    }
+    *p++ = '"';
+    return p;
+  }
+};
+
+// ===== Field descriptors =====
+
+template <typename S, typename M>
+struct JsonField {
+  const char* frag;   // ,"key":
+  uint8_t     len;
+  M S::*      member;
+  constexpr size_t maxLen() const { return len + JsonValue<M>::maxLen(); }
+  char* write(char* p, const S& s) const {
+    memcpy(p, frag, len);
+    return JsonValue<M>::write(p + len, s.*member);
+  }
+};
+
+template <typename S, typename M>
+struct JsonFieldIf {
+  const char* frag;
+  uint8_t     len;
+  M S::*      member;
+  bool S::*   cond;
+  constexpr size_t maxLen() const { return len + JsonValue<M>::maxLen(); }
+  char* write(char* p, const S& s) const {
+    if (!(s.*cond)) return p;
+    memcpy(p, frag, len);
+    return JsonValue<M>::write(p + len, s.*member);
+  }
+};
+
+template <typename S>
+struct JsonFixedField {
+  const char* frag;
+  uint8_t     len;
+  int32_t S::* member;
+  uint8_t     decimals;
+  constexpr size_t maxLen() const { return len + 12; }   // "-21474836.48"
+  char* write(char* p, const S& s) const {
+    memcpy(p, frag, len);
+    return fmtFixed(p + len, s.*member, decimals);
+  }
+};
+
+template <typename S>
+struct JsonStrField {
+  const char* frag;
+  uint8_t     len;
+  const char* S::* member;
+  uint8_t     max;
+  constexpr size_t maxLen() const { return len + jsonStringMaxLen(max); }
+  char* write(char* p, const S& s) const {
+    memcpy(p, frag, len);
+    const char* v = s.*member;
+    return jsonString(p + len, v ? v : "", max);
+  }
+};
+
+template <typename S, typename M>
+constexpr JsonField<S, M> jsonField(const char* frag, uint8_t len, M S::* m) {
+  return JsonField<S, M>{ frag, len, m };
+}
+
+template <typename S, typename M>
+constexpr JsonFieldIf<S, M> jsonFieldIf(const char* frag, uint8_t len, M S::* m, bool S::* cond) {
+  return JsonFieldIf<S, M>{ frag, len, m, cond };
+}
+
+template <typename S>
+constexpr JsonFixedField<S> jsonFixedField(const char* frag, uint8_t len, int32_t S::* m, uint8_t decimals) {
+  return JsonFixedField<S>{ frag, len, m, decimals };
+}
+
+template <typename S>
+constexpr JsonStrField<S> jsonStrField(const char* frag, uint8_t len, const char* S::* m, uint8_t max) {
+  return JsonStrField<S>{ frag, len, m, max };
+}
+
+// ===== Object writer =====
+
+inline constexpr size_t jsonFieldsMaxLen() { return 0; }
+
+template <typename F, typename... R>
+constexpr size_t jsonFieldsMaxLen(const F& f, const R&... rest) {
+  return f.maxLen() + jsonFieldsMaxLen(rest...);
+}
+
+template <typename S>
+inline char* jsonWriteFields(char* p, const S&) { return p; }
+
+template <typename S, typename F, typename... R>
+inline char* jsonWriteFields(char* p, const S& s, const F& f, const R&... rest) {
+  return jsonWriteFields(f.write(p, s), s, rest...);
+}
+
+template <typename S, typename... F>
+inline char* jsonWriteObject(char* p, const S& s, const F&... fields) {
+  char* open = p;
+  p = jsonWriteFields(p, s, fields...);
+  if (p == open) *p++ = '{';
+  else *open = '{';   // the first field's comma
+  *p++ = '}';
+  return p;
+}
+
+#define JSON_KEY_FRAG_(key) ",\"" key "\":"
+#define JSON_KEY_LEN_(key)  (uint8_t)(sizeof(JSON_KEY_FRAG_(key)) - 1)
+
+#define JSON_FIELD_AS(m, key)          jsonField(JSON_KEY_FRAG_(key), JSON_KEY_LEN_(key), &JsonSelf::m)
+#define JSON_FIELD(m)                  JSON_FIELD_AS(m, #m)
+#define JSON_FIELD_IF_AS(m, key, cond) jsonFieldIf(JSON_KEY_FRAG_(key), JSON_KEY_LEN_(key), &JsonSelf::m, &JsonSelf::cond)
+#define JSON_FIELD_IF(m, cond)         JSON_FIELD_IF_AS(m, #m, cond)
+#define JSON_FIXED_AS(m, key, dec)     jsonFixedField(JSON_KEY_FRAG_(key), JSON_KEY_LEN_(key), &JsonSelf::m, dec)
+#define JSON_FIXED(m, dec)             JSON_FIXED_AS(m, #m, dec)
+#define JSON_STR_AS(m, key, max)       jsonStrField(JSON_KEY_FRAG_(key), JSON_KEY_LEN_(key), &JsonSelf::m, max)
+#define JSON_STR(m, max)               JSON_STR_AS(m, #m, max)
+
+// Declares the struct's serializer: toJson(p) writes the object at `p`
+// (no NUL) and returns the end; jsonMaxLen() bounds its length
+#define JSON_FIELDS(Self, ...)                                                    \
+  typedef Self JsonSelf;                                                          \
+  static constexpr size_t jsonMaxLen() { return 2 + jsonFieldsMaxLen(__VA_ARGS__); } \
+  char* toJson(char* p) const { return jsonWriteObject(p, *this, __VA_ARGS__); }
+
+#endif // JSON_STRUCT_H
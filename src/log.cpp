@@ -0,0 +1,200 @@
+#include "log.h"
+#include <atomic>
+#include <stdarg.h>
+
+// Bounded MPSC ring (Vyukov): each slot carries a sequence number that
+// tells producers and the consumer whose turn it is, so no lock is taken on
+// the logging path.
+struct LogSlot {
+  std::atomic<uint32_t> turn;
+  LogEntry entry;
+};
+
+static LogSlot               ring[LOG_RING_SIZE];
+static std::atomic<uint32_t> enqueuePos{0};
+static uint32_t              dequeuePos = 0;      // drain task only
+static std::atomic<uint32_t> nextSeq{1};
+static std::atomic<uint32_t> statWritten{0};
+static std::atomic<uint32_t> statDropped{0};
+static std::atomic<uint32_t> statSuppressed{0};
+
+// Drained entries, read by HTTP handlers on the loop task
+static LogEntry     history[LOG_HISTORY];
+static uint32_t     historyCount = 0;
+static portMUX_TYPE historyMux = portMUX_INITIALIZER_UNLOCKED;
+
+static TaskHandle_t drainTask = nullptr;
+
+char logLevelChar(uint8_t level) {
+  switch (level) {
+    case LOG_LEVEL_ERROR: return 'E';
+    case LOG_LEVEL_WARN:  return 'W';
+    case LOG_LEVEL_INFO:  return 'I';
+    case LOG_LEVEL_DEBUG: return 'D';
+    default:              return '?';
+  }
+}
+
+static LogEntry* claimSlot(uint32_t* posOut) {
+  uint32_t pos = enqueuePos.load(std::memory_order_relaxed);
+  for (;;) {
+    LogSlot& s = ring[pos & (LOG_RING_SIZE - 1)];
+    int32_t diff = (int32_t)(s.turn.load(std::memory_order_acquire) - pos);
+    if (diff == 0) {
+      if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        *posOut = pos;
+        return &s.entry;
+      }
+    } else if (diff < 0) {
+      return nullptr;                         // full
+    } else {
+      pos = enqueuePos.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+static void publishSlot(uint32_t pos) {
+  ring[pos & (LOG_RING_SIZE - 1)].turn.store(pos + 1, std::memory_order_release);
+  if (drainTask) xTaskNotifyGive(drainTask);
+}
+
+static void vlogWrite(uint8_t level, const char* tag, const char* fmt, va_list ap) {
+  uint32_t pos;
+  LogEntry* e = claimSlot(&pos);
+  if (!e) {
+    statDropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  e->seq   = nextSeq.fetch_add(1, std::memory_order_relaxed);
+  e->ms    = millis();
+  e->level = level;
+  strncpy(e->tag, tag, LOG_TAG_LEN - 1);
+  e->tag[LOG_TAG_LEN - 1] = '\0';
+  vsnprintf(e->msg, LOG_MSG_LEN, fmt, ap);
+  publishSlot(pos);
+  statWritten.fetch_add(1, std::memory_order_relaxed);
+}
+
+void logWrite(uint8_t level, const char* tag, const char* fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  vlogWrite(level, tag, fmt, ap);
+  va_end(ap);
+}
+
+// Races between tasks on the same call site only blur the counts a little,
+// which is fine for a rate limiter.
+bool logRateAllow(LogRateState* st, uint8_t level, const char* tag) {
+  uint32_t now = millis();
+  if (now - st->windowStart >= LOG_RATE_WINDOW_MS) {
+    uint16_t skipped = st->suppressed;
+    st->windowStart = now;
+    st->count = 0;
+    st->suppressed = 0;
+    if (skipped) logWrite(level, tag, "(%u similar messages suppressed)", skipped);
+  }
+  if (st->count < LOG_RATE_BURST) {
+    st->count++;
+    return true;
+  }
+  if (st->suppressed < UINT16_MAX) st->suppressed++;
+  statSuppressed.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+static void drainLoop(void*) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+    for (;;) {
+      LogSlot& s = ring[dequeuePos & (LOG_RING_SIZE - 1)];
+      if (s.turn.load(std::memory_order_acquire) != dequeuePos + 1) break;
+
+      const LogEntry& e = s.entry;
+      Serial.printf("[%7lu][%c][%s] %s\n", (unsigned long)e.ms, logLevelChar(e.level), e.tag, e.msg);
+
+      portENTER_CRITICAL(&historyMux);
+      history[historyCount % LOG_HISTORY] = e;
+      historyCount++;
+      portEXIT_CRITICAL(&historyMux);
+
+      s.turn.store(dequeuePos + LOG_RING_SIZE, std::memory_order_release);
+      dequeuePos++;
+    }
+  }
+}
+
+void logBegin() {
+  for (uint32_t i = 0; i < LOG_RING_SIZE; ++i) ring[i].turn.store(i, std::memory_order_relaxed);
+  // Core 0 at low priority: serial output never competes with the loop task
+  xTaskCreatePinnedToCore(drainLoop, "log", 3072, nullptr, tskIDLE_PRIORITY + 1, &drainTask, 0);
+}
+
+size_t logHistory(uint32_t since, LogEntry* out, size_t max) {
+  size_t n = 0;
+  portENTER_CRITICAL(&historyMux);
+  uint32_t first = historyCount > LOG_HISTORY ? historyCount - LOG_HISTORY : 0;
+  for (uint32_t i = first; i < historyCount && n < max; ++i) {
+    const LogEntry& e = history[i % LOG_HISTORY];
+    if (e.seq > since) out[n++] = e;
+  }
+  portEXIT_CRITICAL(&historyMux);
+  return n;
+}
+
+LogStats logStats() {
+  LogStats s;
+  s.written    = statWritten.load(std::memory_order_relaxed);
+  s.dropped    = statDropped.load(std::memory_order_relaxed);
+  s.suppressed = statSuppressed.load(std::memory_order_relaxed);
+  return s;
+}
+
+#ifdef LOG_BENCH
+LogBenchResult logBenchmark(uint16_t iterations) {
+  LogBenchResult r = {};
+  uint32_t t0, total;
+
+  // Enabled: bypass the rate limiter so every call reaches the ring, and
+  // wait for the drain task so the ring never fills during the run.
+  total = 0;
+  for (uint16_t i = 0; i < iterations; ++i) {
+    t0 = ESP.getCycleCount();
+    logWrite(LOG_LEVEL_DEBUG, "BENCH", "iteration %u value %d", i, (int)(i * 7));
+    total += ESP.getCycleCount() - t0;
+    if ((i & 15) == 15) vTaskDelay(pdMS_TO_TICKS(20));
+  }
+  r.enabledCycles = total / iterations;
+
+  // Filtered: a LOGD() in a build with LOG_LEVEL below DEBUG expands to an
+  // empty statement, so only the measurement overhead remains.
+  total = 0;
+  for (uint16_t i = 0; i < iterations; ++i) {
+    t0 = ESP.getCycleCount();
+    do {} while (0);
+    total += ESP.getCycleCount() - t0;
+  }
+  r.filteredCycles = total / iterations;
+
+  // Rate limited: a burst-exhausted call site
+  static LogRateState limited = { 0, LOG_RATE_BURST, 0 };
+  limited.windowStart = millis();
+  total = 0;
+  for (uint16_t i = 0; i < iterations; ++i) {
+    t0 = ESP.getCycleCount();
+    if (logRateAllow(&limited, LOG_LEVEL_DEBUG, "BENCH")) logWrite(LOG_LEVEL_DEBUG, "BENCH", "never");
+    total += ESP.getCycleCount() - t0;
+  }
+  r.limitedCycles = total / iterations;
+  limited.suppressed = 0;
+
+  // Baseline: the synchronous Serial.printf this logger replaced
+  total = 0;
+  for (uint16_t i = 0; i < iterations; ++i) {
+    t0 = ESP.getCycleCount();
+    Serial.printf("[BENCH] iteration %u value %d\n", i, (int)(i * 7));
+    total += ESP.getCycleCount() - t0;
+  }
+  r.serialCycles = total / iterations;
+  return r;
+}
+#endif
@@ -0,0 +1,104 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <Arduino.h>
+
+// Leveled, asynchronous logger.
+//
+//   LOGI("HTTP", "GET %s", path);
+//
+// Calls above LOG_LEVEL compile to nothing. Enabled calls format straight
+// into a slot of a lock-free ring (multi-producer, single consumer) and
+// return; a low-priority task drains the ring to Serial and keeps the last
+// LOG_HISTORY entries for /api/logs. When the ring is full the entry is
+// dropped and counted instead of blocking the caller.
+//
+// Each call site is rate limited to LOG_RATE_BURST messages per
+// LOG_RATE_WINDOW_MS; the overflow is summarised as one "suppressed" line.
+
+#define LOG_LEVEL_NONE    0
+#define LOG_LEVEL_ERROR   1
+#define LOG_LEVEL_WARN    2
+#define LOG_LEVEL_INFO    3
+#define LOG_LEVEL_DEBUG   4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#define LOG_MSG_LEN        96
+#define LOG_TAG_LEN        8
+#define LOG_RING_SIZE      32    // power of two
+#define LOG_HISTORY        64
+#define LOG_RATE_BURST     5
+#define LOG_RATE_WINDOW_MS 1000
+
+struct LogEntry {
+  uint32_t seq;
+  uint32_t ms;
+  uint8_t  level;
+  char     tag[LOG_TAG_LEN];
+  char     msg[LOG_MSG_LEN];
+};
+
+struct LogRateState {
+  uint32_t windowStart;
+  uint16_t count;
+  uint16_t suppressed;
+};
+
+struct LogStats {
+  uint32_t written;      // entries accepted into the ring
+  uint32_t dropped;      // ring full
+  uint32_t suppressed;   // rate limited
+};
+
+void logBegin();
+void logWrite(uint8_t level, const char* tag, const char* fmt, ...) __attribute__((format(printf, 3, 4)));
+bool logRateAllow(LogRateState* st, uint8_t level, const char* tag);
+
+// Copies up to `max` history entries with seq > `since` (oldest first) and
+// returns how many were copied.
+size_t   logHistory(uint32_t since, LogEntry* out, size_t max);
+LogStats logStats();
+char     logLevelChar(uint8_t level);
+
+#define LOG_AT(level, tag, fmt, ...)                                    \
+  do {                                                                  \
+    static LogRateState _logRate;                                       \
+    if (logRateAllow(&_logRate, level, tag)) logWrite(level, tag, fmt, ##__VA_ARGS__); \
+  } while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOGE(tag, fmt, ...) LOG_AT(LOG_LEVEL_ERROR, tag, fmt, ##__VA_ARGS__)
+#else
+#define LOGE(tag, fmt, ...) do {} while (0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOGW(tag, fmt, ...) LOG_AT(LOG_LEVEL_WARN, tag, fmt, ##__VA_ARGS__)
+#else
+#define LOGW(tag, fmt, ...) do {} while (0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOGI(tag, fmt, ...) LOG_AT(LOG_LEVEL_INFO, tag, fmt, ##__VA_ARGS__)
+#else
+#define LOGI(tag, fmt, ...) do {} while (0)
+#endif
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOGD(tag, fmt, ...) LOG_AT(LOG_LEVEL_DEBUG, tag, fmt, ##__VA_ARGS__)
+#else
+#define LOGD(tag, fmt, ...) do {} while (0)
+#endif
+
+#ifdef LOG_BENCH
+// Cycles per call for the logging paths; see /api/logs/bench
+struct LogBenchResult {
+  uint32_t enabledCycles;     // formatted into the ring
+  uint32_t filteredCycles;    // level compiled out
+  uint32_t limitedCycles;     // rejected by the rate limiter
+  uint32_t serialCycles;      // Serial.printf baseline
+};
+LogBenchResult logBenchmark(uint16_t iterations);
+#endif
+
+#endif // LOG_H
@@ -0,0 +1,246 @@
+#include "loop_watchdog.h"
+#include "log.h"
+#include "time_sync.h"
+#include <esp_system.h>
+#include <esp_timer.h>
+
+#define WATCHDOG_MAGIC 0x57444731   // "WDG1"
+
+// Survives everything but a power cycle; validated by magic + checksum
+struct WatchdogRtc {
+  uint32_t      magic;
+  uint32_t      bootCount;
+  bool          hasStall;
+  WatchdogStall stall;
+  uint32_t      check;    // FNV-1a of everything above
+};
+RTC_NOINIT_ATTR static WatchdogRtc rtc;
+
+// Live stage trail of the loop task; the monitor reads it under `mux`
+static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+static const char*  trail[WATCHDOG_MAX_DEPTH];
+static uint32_t     trailPc[WATCHDOG_MAX_DEPTH];
+static uint8_t      depth = 0;            // may exceed WATCHDOG_MAX_DEPTH; extra levels are not kept
+static bool         inLoop = false;
+static bool         captured = false;     // this iteration's stall is in rtc
+static uint32_t     loopStartMs = 0;
+static uint64_t     loopStartTsMs = 0;
+
+// Loop task only
+static uint32_t            loopStartUs = 0;
+static WatchdogStageStats  stages[WATCHDOG_MAX_STAGES];
+static size_t              stageCount = 0;
+static WatchdogStageStats* current = nullptr;
+static uint32_t            stageStartUs = 0;
+static WatchdogStageStats* slowest = nullptr;
+static uint32_t            slowestUs = 0;
+
+static WatchdogStats       stats = {};
+static esp_timer_handle_t  monitor = nullptr;
+
+static uint32_t rtcCheck() {
+  const uint8_t* p = (const uint8_t*)&rtc;
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < offsetof(WatchdogRtc, check); ++i) h = (h ^ p[i]) * 16777619u;
+  return h;
+}
+
+// Return address -> address of the call instruction, as esp_backtrace
+// prints it (windowed ABI keeps the window size in the top two bits)
+static uint32_t callSite(void* ra) {
+  uint32_t pc = (uint32_t)(uintptr_t)ra;
+#ifdef __XTENSA__
+  if (pc & 0x80000000) pc = (pc & 0x3fffffff) | 0x40000000;
+#endif
+  return pc - 3;
+}
+
+static WatchdogStageStats* stageFor(const char* name) {
+  for (size_t i = 0; i < stageCount; ++i) {
+    if (stages[i].name == name) return &stages[i];
+  }
+  if (stageCount == WATCHDOG_MAX_STAGES) return nullptr;
+  stages[stageCount] = { name, 0, 0, 0, 0 };
+  return &stages[stageCount++];
+}
+
+static void closeStage(uint32_t nowUs) {
+  if (!current) return;
+  uint32_t us = nowUs - stageStartUs;
+  current->count++;
+  current->totalUs += us;
+  if (us > current->maxUs) current->maxUs = us;
+  if (us > slowestUs) {
+    slowestUs = us;
+    slowest = current;
+  }
+  current = nullptr;
+}
+
+// Copies the live trail into rtc; caller holds `mux`
+static void captureLocked(uint32_t durationMs, bool finished) {
+  WatchdogStall& s = rtc.stall;
+  s.bootCount  = rtc.bootCount;
+  s.uptimeMs   = loopStartMs;
+  s.tsMs       = loopStartTsMs;
+  s.durationMs = durationMs;
+  s.finished   = finished;
+  s.depth      = depth < WATCHDOG_MAX_DEPTH ? depth : WATCHDOG_MAX_DEPTH;
+  for (uint8_t i = 0; i < s.depth; ++i) {
+    strncpy(s.stage[i], trail[i], WATCHDOG_NAME_LEN - 1);
+    s.stage[i][WATCHDOG_NAME_LEN - 1] = '\0';
+    s.pc[i] = trailPc[i];
+  }
+  rtc.hasStall = true;
+  rtc.check = rtcCheck();
+}
+
+// esp_timer task: catches an iteration while it is still stuck
+static void monitorTick(void*) {
+  uint32_t now = millis();
+  portENTER_CRITICAL(&mux);
+  if (inLoop && now - loopStartMs >= stats.stallMs) {
+    if (!captured) {
+      captured = true;
+      stats.stalls++;
+      captureLocked(now - loopStartMs, false);
+    } else {
+      rtc.stall.durationMs = now - loopStartMs;
+      rtc.check = rtcCheck();
+    }
+  }
+  portEXIT_CRITICAL(&mux);
+}
+
+void watchdogBegin(uint32_t sloMs, uint32_t stallMs) {
+  stats.sloMs = sloMs;
+  stats.stallMs = stallMs;
+  if (rtc.magic != WATCHDOG_MAGIC || rtc.check != rtcCheck()) {
+    memset(&rtc, 0, sizeof(rtc));         // power-on garbage
+    rtc.magic = WATCHDOG_MAGIC;
+  }
+  rtc.bootCount++;
+  rtc.check = rtcCheck();
+
+  esp_timer_create_args_t args = {};
+  args.callback = monitorTick;
+  args.name = "loop_wd";
+  if (esp_timer_create(&args, &monitor) == ESP_OK) {
+    esp_timer_start_periodic(monitor, WATCHDOG_POLL_MS * 1000);
+  }
+}
+
+void watchdogLoopStart() {
+  uint32_t nowMs = millis();
+  uint64_t tsMs = timeAtMs(nowMs);
+  loopStartUs = micros();
+  current = nullptr;
+  slowest = nullptr;
+  slowestUs = 0;
+  portENTER_CRITICAL(&mux);
+  loopStartMs = nowMs;
+  loopStartTsMs = tsMs;
+  depth = 0;
+  captured = false;
+  inLoop = true;
+  portEXIT_CRITICAL(&mux);
+}
+
+void watchdogLoopEnd() {
+  uint32_t now = micros();
+  closeStage(now);
+  uint32_t us = now - loopStartUs;
+
+  portENTER_CRITICAL(&mux);
+  inLoop = false;
+  bool stalled = captured;
+  if (stalled) {
+    rtc.stall.durationMs = us / 1000;
+    rtc.stall.finished = true;
+    rtc.check = rtcCheck();
+  }
+  portEXIT_CRITICAL(&mux);
+
+  stats.loops++;
+  stats.totalUs += us;
+  if (us > stats.maxUs) stats.maxUs = us;
+  if (us > stats.sloMs * 1000) {
+    stats.violations++;
+    if (slowest) slowest->violations++;
+    stats.lastViolationStage = slowest ? slowest->name : nullptr;
+    stats.lastViolationUs = us;
+    stats.lastViolationMs = millis();
+  }
+  if (stalled) {
+    LOGW("WDOG", "loop stalled %lu ms, slowest stage %s (%lu ms)", (unsigned long)(us / 1000),
+         slowest ? slowest->name : "?", (unsigned long)(slowestUs / 1000));
+  }
+}
+
+void __attribute__((noinline)) watchdogStage(const char* name) {
+  uint32_t pc = callSite(__builtin_return_address(0));
+  uint32_t now = micros();
+  closeStage(now);
+  current = stageFor(name);
+  stageStartUs = now;
+  portENTER_CRITICAL(&mux);
+  trail[0] = name;
+  trailPc[0] = pc;
+  depth = 1;
+  portEXIT_CRITICAL(&mux);
+}
+
+void __attribute__((noinline)) watchdogPush(const char* name) {
+  uint32_t pc = callSite(__builtin_return_address(0));
+  portENTER_CRITICAL(&mux);
+  if (depth < WATCHDOG_MAX_DEPTH) {
+    trail[depth] = name;
+    trailPc[depth] = pc;
+  }
+  if (depth < UINT8_MAX) depth++;
+  portEXIT_CRITICAL(&mux);
+}
+
+void watchdogPop() {
+  portENTER_CRITICAL(&mux);
+  if (depth > 0) depth--;
+  portEXIT_CRITICAL(&mux);
+}
+
+const WatchdogStats& watchdogStats() { return stats; }
+size_t watchdogStageCount() { return stageCount; }
+const WatchdogStageStats* watchdogStageAt(size_t i) { return i < stageCount ? &stages[i] : nullptr; }
+
+bool watchdogLastStall(WatchdogStall* out) {
+  portENTER_CRITICAL(&mux);
+  bool has = rtc.hasStall;
+  if (has) *out = rtc.stall;
+  portEXIT_CRITICAL(&mux);
+  return has;
+}
+
+uint32_t watchdogBootCount() { return rtc.bootCount; }
+
+const char* watchdogResetReason() {
+  switch (esp_reset_reason()) {
+    case ESP_RST_POWERON:   return "power_on";
+    case ESP_RST_EXT:       return "external";
+    case ESP_RST_SW:        return "software";
+    case ESP_RST_PANIC:     return "panic";
+    case ESP_RST_INT_WDT:   return "interrupt_wdt";
+    case ESP_RST_TASK_WDT:  return "task_wdt";
+    case ESP_RST_WDT:       return "other_wdt";
+    case ESP_RST_DEEPSLEEP: return "deep_sleep";
+    case ESP_RST_BROWNOUT:  return "brownout";
+    case ESP_RST_SDIO:      return "sdio";
+    default:                return "unknown";
+  }
+}
+
+void watchdogResetStats() {
+  uint32_t slo = stats.sloMs, stall = stats.stallMs;
+  stats = {};
+  stats.sloMs = slo;
+  stats.stallMs = stall;
+  for (size_t i = 0; i < stageCount; ++i) stages[i] = { stages[i].name, 0, 0, 0, 0 };
+}
@@ -0,0 +1,89 @@
+#ifndef LOOP_WATCHDOG_H
+#define LOOP_WATCHDOG_H
+
+#include <Arduino.h>
+
+// Software watchdog for loop() latency.
+//
+// loop() is split into named stages (watchdogStage) and code that may block
+// inside a stage opens a nested scope (WatchdogScope, e.g. an MQTT connect
+// or an HTTP route), so at any moment the watchdog knows the stage trail the
+// loop is in and the call site (PC) of every level.
+//
+// Every iteration is timed against the latency SLO: iterations over it are
+// counted as violations and attributed to their slowest stage. An
+// esp_timer monitor checks the running iteration every WATCHDOG_POLL_MS;
+// one that exceeds the stall threshold is captured while it is still stuck
+// (trail, call-site PCs, duration so far) into RTC memory that survives
+// software resets, panics and watchdog resets, and is updated with the
+// final duration once the loop moves on. /api/watchdog reports the counters
+// and the last stall, including one from before the reboot it may have
+// caused. The PCs resolve to source lines with
+//   xtensa-esp32-elf-addr2line -e .pio/build/<env>/firmware.elf <pc>...
+
+#define WATCHDOG_MAX_DEPTH  6
+#define WATCHDOG_NAME_LEN   24
+#define WATCHDOG_MAX_STAGES 16
+#define WATCHDOG_POLL_MS    50
+
+struct WatchdogStall {
+  uint32_t bootCount;       // boot the stall happened in
+  uint32_t uptimeMs;        // millis() when the iteration started
+  uint64_t tsMs;            // wall time of the same, 0 without a clock
+  uint32_t durationMs;      // so far, or final once `finished`
+  bool     finished;        // false: the loop never came back (e.g. reset)
+  uint8_t  depth;
+  char     stage[WATCHDOG_MAX_DEPTH][WATCHDOG_NAME_LEN];
+  uint32_t pc[WATCHDOG_MAX_DEPTH];
+};
+
+struct WatchdogStageStats {
+  const char* name;
+  uint32_t    count;
+  uint64_t    totalUs;
+  uint32_t    maxUs;
+  uint32_t    violations;   // SLO violations where this was the slowest stage
+};
+
+struct WatchdogStats {
+  uint32_t sloMs;
+  uint32_t stallMs;
+  uint32_t loops;
+  uint64_t totalUs;
+  uint32_t maxUs;
+  uint32_t violations;
+  uint32_t stalls;
+  const char* lastViolationStage;
+  uint32_t lastViolationUs;
+  uint32_t lastViolationMs; // millis()
+};
+
+// `sloMs`: per-iteration budget; `stallMs`: captured as a stall
+void watchdogBegin(uint32_t sloMs, uint32_t stallMs);
+
+void watchdogLoopStart();
+void watchdogLoopEnd();
+// Starts the next top-level stage of the current iteration; `name` must
+// be a string literal (kept by pointer)
+void watchdogStage(const char* name);
+void watchdogPush(const char* name);
+void watchdogPop();
+
+class WatchdogScope {
+ public:
+  explicit WatchdogScope(const char* name) { watchdogPush(name); }
+  ~WatchdogScope() { watchdogPop(); }
+  WatchdogScope(const WatchdogScope&) = delete;
+  WatchdogScope& operator=(const WatchdogScope&) = delete;
+};
+
+const WatchdogStats& watchdogStats();
+size_t watchdogStageCount();
+const WatchdogStageStats* watchdogStageAt(size_t i);
+// Last captured stall (possibly from a previous boot); false if none
+bool watchdogLastStall(WatchdogStall* out);
+uint32_t watchdogBootCount();
+const char* watchdogResetReason();
+void watchdogResetStats();
+
+#endif // LOOP_WATCHDOG_H
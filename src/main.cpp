@@ -2,35 +2,118 @@
   ESP32 Hybrid Mode WiFi Manager with Captive Portal, Embedded Dashboard, and MQTT Publisher
   ------------------------------------------------------------------------------------------
   - AP + STA mode
-  - Serves embedded HTML dashboard from flash
-  - Scans nearby WiFi networks
-  - Connects/disconnects from WiFi
+  - Serves the dashboard from flash as a small HTML shell plus content-hashed
+    CSS/JS assets (immutable caching, so repeat visits only revalidate the shell)
+  - Scans nearby WiFi networks (deduplicated by SSID, filterable, streamed)
+  - Connects/disconnects from WiFi; saved networks (with priorities), BSSID,
+    channel and lease are kept in NVS so reboots reconnect without a full scan
+  - Background roaming to a stronger BSSID / preferred saved network
   - JSON API for UI (incl. /api/sensors)
+  - Persistent (keep-alive) HTTP/1.1 connections with pipelining, so the
+    dashboard's polling reuses a handful of sockets
+  - Per-route request timing at /api/metrics (driven by tools/http_bench.py)
   - Robust captive portal (DNS spoof, OS probe endpoints, host-agnostic redirect)
-  - Publishes simulated sensor data via MQTT (PubSubClient)
+  - DNS queries drained in bursts every loop tick, AAAA/HTTPS answered NODATA
+  - Caching DNS forwarder for AP clients while the STA uplink is connected
+  - Leveled async logging drained off the hot path; recent entries at /api/logs
+  - Boot timeline at /api/boot; AP/DNS/HTTP come up first, MQTT, STA
+    reconnect and the first scan are deferred to the loop
+  - Publishes simulated sensor data via MQTT (PubSubClient) under a per-device
+    topic (site/zone/device/channel) with a MAC-derived client id
 */
 
 #include <WiFi.h>
-#include <WebServer.h>
-#include <DNSServer.h>
 #include <ArduinoJson.h>
 #include <PubSubClient.h>
-#include "index_html.h"  // Embedded HTML UI (see updated snippet further below)
+#include "http_server.h" // Persistent HTTP/1.1 connections with pipelining
+#include "web_assets.h"  // Dashboard shell + hashed CSS/JS (generated from data/ by tools/web_assets.py)
+#include "metrics.h"     // Per-route request timing for /api/metrics
+#include "captive_dns.h" // Burst-draining wildcard DNS for the captive portal
+#include "telemetry.h"   // Device id, topic layout and payload format (shared with tools/fleet)
+#include "log.h"         // Leveled async logger (LOGE/LOGW/LOGI/LOGD)
+#include "scan_cache.h"  // Deduplicated, RSSI-sorted scan results with TTL
+#include "sta_link.h"    // Stored STA credentials + fast (cached BSSID/channel) reconnect
+#include "boot_profile.h" // Boot stage timestamps for /api/boot
+#include "roaming.h"     // Background RSSI-based BSSID / saved-network selection
+#include "json_stream.h" // Chunked JSON writer with a fixed buffer (scan, status, logs)
+#include "samples.h"     // Sequence-numbered sensor samples for /api/sensors?since=
+#include "dsp.h"         // Fixed-point filter chains applied to each sensor channel
+#include "time_sync.h"   // SNTP wall clock for sample timestamps
+#include "loop_watchdog.h" // Loop latency SLO + stall capture kept across resets
+#include "api_payloads.h" // API response structs with generated JSON serializers
+#include "wifi_state.h"   // Event-driven cached WiFi link state
+#include "arena.h"        // Per-request / per-publish scratch allocator
+#include "mqtt_broker.h"  // Local MQTT broker for AP-side subscribers
+#include "report_filter.h" // Report-by-exception deadbands for upstream samples
 
 // ===================== CONFIGURATION =====================
 static const char* apSSID = "ESP32_AP";
 static const char* apPassword = "12345678";
 
-// MQTT Broker Settings
+// MQTT Broker Settings (topics: MQTT_SITE/MQTT_ZONE/<device id>/<channel>)
 static const char* mqttServer = "broker.hivemq.com";
 static const int   mqttPort   = 1883;
-static const char* mqttTopic  = "esp32/sensor/data";
+static const unsigned long PUBLISH_INTERVAL_MS = 1000;
+// Samples per MQTT message once the clock is synced (base time + deltas on
+// the batch topic); 1 publishes every sample as it is taken. Backlogs after
+// a broker or link outage are always sent as one batch.
+static const uint8_t PUBLISH_BATCH = 1;
+// Report-by-exception upstream: a sample is published when a channel leaves
+// its deadband around the last published value (no sooner than the minimum
+// interval after the previous one), plus a heartbeat when nothing changes.
+// The local broker still gets every sample.
+// { enabled, { {abs, pct (0.1 %)} for temp, light, humidity }, min ms, heartbeat ms }
+static const ReportConfig REPORT_CONFIG = { true, { { 20, 0 }, { 10, 50 }, { 50, 0 } }, 0, 60000 };
+
+// Loop latency budget: iterations over LOOP_SLO_MS count as SLO violations
+// (attributed to their slowest stage); one still running after
+// LOOP_STALL_MS is captured as a stall into RTC memory (/api/watchdog)
+static const uint32_t LOOP_SLO_MS   = 50;
+static const uint32_t LOOP_STALL_MS = 1000;
+
+// Per-channel signal conditioning, in the units the filters see:
+// temperature and humidity in hundredths, light in raw counts.
+// { stages, outlier threshold, max rejects, EMA alpha (Q16), Kalman q, Kalman r }
+static const FilterConfig TEMP_FILTER     = { FILTER_OUTLIER | FILTER_MEDIAN | FILTER_KALMAN, 300, 3, 0, 16, 100 };
+static const FilterConfig HUMIDITY_FILTER = { FILTER_OUTLIER | FILTER_MEDIAN | FILTER_EMA, 1000, 3, 16384, 0, 0 };
+static const FilterConfig LIGHT_FILTER    = { FILTER_MEDIAN | FILTER_AVERAGE, 0, 0, 0, 0, 0 };
+
+// DNS: once STA is up, AP clients' lookups are forwarded to the uplink's
+// resolver (cached). Build with -DDNS_UPSTREAM_OVERRIDE=\"a.b.c.d\" to use a
+// fixed resolver instead, e.g. a local stand-in while testing.
+// SNTP server; -DSNTP_SERVER_OVERRIDE=\"a.b.c.d\" for a local stand-in
+// (tools/sntp_stub.py)
+#ifdef SNTP_SERVER_OVERRIDE
+static const char* sntpServer = SNTP_SERVER_OVERRIDE;
+#else
+static const char* sntpServer = "pool.ntp.org";
+#endif
+
+#ifdef DNS_UPSTREAM_OVERRIDE
+static const char* dnsUpstreamOverride = DNS_UPSTREAM_OVERRIDE;
+#else
+static const char* dnsUpstreamOverride = nullptr;
+#endif
+
+// Scratch memory, reset after every HTTP response / MQTT publish; sized
+// from the high-water marks under `arena` in /api/metrics
+static const size_t REQUEST_ARENA_SIZE = 12288;
+static const size_t MQTT_ARENA_SIZE    = 2048;
 
 // ===================== GLOBALS ============================
-WebServer   server(80);
-DNSServer   dnsServer;
+HttpServer  server(80);
+FixedArena<REQUEST_ARENA_SIZE> requestArena;
+FixedArena<MQTT_ARENA_SIZE>    mqttArena;
+CaptiveDns  dnsServer;
 WiFiClient  espClient;
 PubSubClient mqttClient(espClient);
+MqttBroker  broker;
+
+// Per-device identity, filled in setup() from the STA MAC
+char deviceId[TELEMETRY_ID_LEN];
+char mqttTopic[TELEMETRY_TOPIC_LEN];
+char mqttStatusTopic[TELEMETRY_TOPIC_LEN];
+char mqttBatchTopic[TELEMETRY_TOPIC_LEN];
 
 const byte DNS_PORT = 53;
 
@@ -38,17 +121,30 @@ IPAddress apIP(192,168,4,1);
 IPAddress apGateway(192,168,4,1);
 IPAddress apSubnet(255,255,255,0);
 
-// Cache variables for last WiFi scan
-String lastScanJson;
-bool   lastScanAvailable = false;
+// Last WiFi scan, serialized on demand
+ScanCache scanCache;
+// Full scans run async and are polled in loop(); one scan at a time on the
+// radio, so a request made during a roaming scan waits for it.
+bool      fullScanRunning   = false;
+bool      fullScanRequested = false;
+static const uint32_t SCAN_FRESH_MS = 5000;   // newer results are served without rescanning
+
+// MQTT samples that never reached the broker (aged out of the sample ring,
+// or taken while down without a wall clock to batch them) - the loss windows
+// as the telemetry consumer sees them
+uint32_t  publishesMissed = 0;
+uint32_t  publishedSeq = 0;       // latest sample handed to the broker
+uint32_t  publishedBatches = 0;
+ReportFilter reportFilter(REPORT_CONFIG);   // state of the last publish that went through
+
+// Sensor filters (loop task only)
+FilterChain<> tempFilter(TEMP_FILTER);
+FilterChain<> humidityFilter(HUMIDITY_FILTER);
+FilterChain<> lightFilter(LIGHT_FILTER);
 
-// Simulated sensor values
-int   tempVal     = 25;
-int   lightVal    = 500;
-float humidityVal = 60.0;
 
 // =================== Helper Functions ====================
-String encryptionTypeStr(wifi_auth_mode_t type) {
+const char* encryptionTypeStr(wifi_auth_mode_t type) {
   switch (type) {
     case WIFI_AUTH_OPEN:            return "Open";
     case WIFI_AUTH_WEP:             return "WEP";
@@ -68,145 +164,385 @@ String encryptionTypeStr(wifi_auth_mode_t type) {
 
 // Any request with a Host header not matching our AP IP is treated as captive
 bool isCaptivePortal() {
-  if (!server.hasHeader("Host")) return true;
-  String host = server.header("Host");
+  const char* host = server.headerValue("Host");
+  if (!host) return true;
   // Accept "ap ip" or "ap ip:80"
-  if (host == apIP.toString() || host == (apIP.toString() + ":80")) return false;
-  return true;
+  char ip[16];
+  size_t len = snprintf(ip, sizeof(ip), "%u.%u.%u.%u", apIP[0], apIP[1], apIP[2], apIP[3]);
+  if (strncmp(host, ip, len) != 0) return true;
+  return !(host[len] == '\0' || strcmp(host + len, ":80") == 0);
 }
 
 void sendRedirectToRoot() {
-  String url = "http://" + apIP.toString() + "/";
-  server.sendHeader("Location", url, true);
+  char* url = requestArena.printf("http://%u.%u.%u.%u/", apIP[0], apIP[1], apIP[2], apIP[3]);
+  server.sendHeader("Location", url ? url : "/", true);
   server.send(302, "text/plain", "");
-  Serial.printf("[HTTP] Captive redirect -> %s\n", url.c_str());
+  LOGD("HTTP", "Captive redirect -> %s", url ? url : "/");
 }
 
 // ================= MQTT Functions ========================
-void mqttReconnect() {
-  while (!mqttClient.connected() && WiFi.status() == WL_CONNECTED) {
-    Serial.print("[MQTT] Connecting...");
-    if (mqttClient.connect("ESP32_Client")) {
-      Serial.println("connected!");
-    } else {
-      Serial.print("failed, rc=");
-      Serial.print(mqttClient.state());
-      Serial.println(" retry in 2s");
-      delay(2000);
-    }
+// One connect attempt at most every MQTT_RETRY_MS; never blocks the loop
+// waiting for the broker (DNS/portal keep being served between attempts).
+static const unsigned long MQTT_RETRY_MS = 2000;
+
+bool mqttReconnect() {
+  static unsigned long lastAttempt = 0;
+  static bool attempted = false;
+  if (mqttClient.connected()) return true;
+  if (!wifiStaConnected()) return false;
+  if (attempted && millis() - lastAttempt < MQTT_RETRY_MS) return false;
+  attempted = true;
+  lastAttempt = millis();
+
+  LOGI("MQTT", "Connecting as %s...", deviceId);
+  // Last will marks the device offline if it drops off the broker; blocks
+  // for the broker lookup and TCP connect
+  WatchdogScope wd("mqtt_connect");
+  if (mqttClient.connect(deviceId, mqttStatusTopic, 0, true, "offline")) {
+    LOGI("MQTT", "connected!");
+    mqttClient.publish(mqttStatusTopic, "online", true);
+    reportFilter.rearm();   // the first sample after a reconnect always goes out
+    bootMarkOnce("mqtt_connected");
+    return true;
   }
+  LOGW("MQTT", "connect failed, rc=%d, retry in %lus", mqttClient.state(), MQTT_RETRY_MS / 1000);
+  return false;
+}
+
+// Simulated sensors (varied but bounded), conditioned by each channel's
+// filter chain before they are recorded
+void sampleSensors() {
+  int32_t tempCenti     = tempFilter.process((20 + random(0, 11)) * 100);
+  int32_t light         = lightFilter.process(400 + random(0, 201));
+  int32_t humidityCenti = humidityFilter.process((50 + random(0, 21)) * 100);
+  samplesRecord(tempCenti, light, humidityCenti, timeNowMs());
 }
 
+// Wall time of a sample: stamped at acquisition, or derived from its
+// millis() if the clock was synced after it was taken
+static uint64_t sampleTime(const SensorSample& s) {
+  return s.tsMs ? s.tsMs : timeAtMs(s.ms);
+}
+
+// Publishes every sample not yet sent that report-by-exception lets
+// through: one payload per sample, or a batch (base time + deltas) once
+// PUBLISH_BATCH have accumulated or after an outage. Without a wall clock
+// only the latest sample can be sent. Suppressed samples count as handled.
+// A failed publish is retried with the next sample (the filter state is
+// only kept once it went through); what ages out of the ring by then is
+// counted as missed. Scratch (pending samples, readings, payload) comes
+// from mqttArena, released at the next publish.
 void publishSensorData() {
-  if (WiFi.status() != WL_CONNECTED) return;
-  if (!mqttClient.connected()) mqttReconnect();
+  if (!mqttReconnect()) return;
   mqttClient.loop();
 
-  char payload[100];
-  snprintf(payload, sizeof(payload),
-           "{\"temp\":%d,\"light\":%d,\"humidity\":%.2f}",
-           tempVal, lightVal, humidityVal);
+  SensorSample* pending = mqttArena.alloc<SensorSample>(SAMPLE_HISTORY);
+  if (!pending) return;
+  size_t n = samplesSince(publishedSeq, pending, SAMPLE_HISTORY);
+  if (n == 0) return;
+  bool haveTime = timeSource() != TIME_MONOTONIC;
+  if (haveTime && n < PUBLISH_BATCH && pending[0].seq == publishedSeq + 1) return;
+  uint32_t lost = pending[0].seq - publishedSeq - 1;
+  uint32_t lastSeq = pending[n - 1].seq;
+  if (!haveTime) {
+    lost += n - 1;
+    pending[0] = pending[n - 1];
+    n = 1;
+  }
 
-  bool ok = mqttClient.publish(mqttTopic, payload);
-  Serial.printf("[MQTT] Publish [%s]: %s\n", ok ? "OK" : "FAIL", payload);
+  ReportFilter filter = reportFilter;
+  size_t k = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const SensorSample& s = pending[i];
+    if (filter.check(s.tempCenti, s.light, s.humidityCenti, s.ms) != REPORT_SUPPRESSED) pending[k++] = s;
+  }
+  bool ok = true;
+  char* payload = nullptr;
+  if (k > 0) {
+    size_t cap = haveTime && k > 1 ? TELEMETRY_BATCH_LEN(k) : TELEMETRY_PAYLOAD_LEN;
+    payload = mqttArena.alloc<char>(cap);
+    if (!payload) return;
+    if (haveTime && k > 1) {
+      TelemetryReading* r = mqttArena.alloc<TelemetryReading>(k);
+      if (!r) return;
+      for (size_t i = 0; i < k; ++i) {
+        r[i] = { sampleTime(pending[i]), pending[i].tempCenti, pending[i].light, pending[i].humidityCenti };
+      }
+      int len = telemetryBatchPayload(payload, cap, r, k);
+      ok = mqttClient.publish(mqttBatchTopic, (const uint8_t*)payload, len);
+      if (ok) publishedBatches++;
+    } else {
+      const SensorSample& s = pending[0];
+      int len = telemetrySensorPayload(payload, cap, s.tempCenti, s.light, s.humidityCenti,
+                                       sampleTime(s));
+      ok = mqttClient.publish(mqttTopic, (const uint8_t*)payload, len);
+    }
+  }
+  if (!ok) {
+    LOGW("MQTT", "Publish FAILED (%u samples pending)", (unsigned)k);
+    return;
+  }
+  if (payload) LOGD("MQTT", "Publish: %s", payload);
+  reportFilter = filter;
+  publishesMissed += lost;
+  publishedSeq = lastSeq;
+}
 
-  // Update simulated values (varied but bounded)
-  tempVal     = 20 + random(0, 11);
-  lightVal    = 400 + random(0, 201);
-  humidityVal = 50  + random(0, 21);
+// The latest sample to subscribers of the local broker, on the same topic
+// and in the same format as upstream. Retained, so a client that subscribes
+// later gets it at once; works with the uplink down.
+void publishLocal() {
+  const SensorSample* s = samplesLatest();
+  if (!s) return;
+  char* payload = mqttArena.alloc<char>(TELEMETRY_PAYLOAD_LEN);
+  if (!payload) return;
+  int len = telemetrySensorPayload(payload, TELEMETRY_PAYLOAD_LEN, s->tempCenti, s->light, s->humidityCenti,
+                                   sampleTime(*s));
+  if (len > 0) broker.publish(mqttTopic, (const uint8_t*)payload, len, /*retain=*/true);
 }
 
 // ===================== HTTP Handlers =====================
-// Serve the dashboard
+// Tags the response with `etag`; if the client already holds that version,
+// answers 304 without a body and returns true.
+bool sendNotModified(const char* etag) {
+  server.sendHeader("ETag", etag);
+  const char* held = server.headerValue("If-None-Match");
+  if (!held || strcmp(held, etag) != 0) return false;
+  server.send(304, nullptr, "");
+  return true;
+}
+
+// Serializes `doc` into the request arena and sends it; the document itself
+// should live there too (JsonDocument doc(&requestArena))
+void sendJson(int code, const JsonDocument& doc) {
+  size_t len = measureJson(doc);
+  char* out = requestArena.alloc<char>(len + 1);
+  if (!out) {
+    server.send(500, "application/json", "{\"status\":\"error\",\"message\":\"Out of memory\"}");
+    return;
+  }
+  serializeJson(doc, out, len + 1);
+  server.send_P(code, "application/json", out, len);
+}
+
+// Integer query/form argument, `def` if absent
+long argInt(const char* name, long def) {
+  const char* v = server.argValue(name);
+  return v ? strtol(v, nullptr, 10) : def;
+}
+
+// Dotted quad, formatted into the request arena (IPAddress::toString()
+// would allocate a String)
+const char* ipString(IPAddress ip) {
+  const char* s = requestArena.printf("%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+  return s ? s : "";
+}
+
+// Serves a generated asset from flash. Hashed assets never change under
+// their URL, so browsers may keep them forever; the shell is revalidated on
+// every load and costs a bodyless 304 while it is unchanged.
+void sendAsset(const WebAsset& a) {
+  server.sendHeader("Cache-Control", a.immutable ? "public, max-age=31536000, immutable" : "no-cache");
+  if (sendNotModified(a.etag)) return;
+  server.send_P(200, a.contentType, a.data, a.len);
+}
+
+// Serve the dashboard shell
 void handleRoot() {
-  Serial.println("[HTTP] GET / (dashboard)");
-  // Serve from PROGMEM blob
-  server.setContentLength(index_html_len);
-  server.send(200, "text/html", (const char*)index_html);
+  LOGD("HTTP", "GET / (dashboard)");
+  sendAsset(WEB_ASSETS[0]);
 }
 
 // OS captive probes -> force the captive portal UI
 void handleAndroidProbe() {  // /generate_204
-  Serial.println("[HTTP] Android probe -> redirect");
+  LOGD("HTTP", "Android probe -> redirect");
   sendRedirectToRoot();
 }
 void handleAppleProbe() {    // /hotspot-detect.html
-  Serial.println("[HTTP] Apple probe -> simple page");
+  LOGD("HTTP", "Apple probe -> simple page");
   server.send(200, "text/html",
               "<html><head><meta http-equiv='refresh' content='0; url=/'/></head>"
               "<body>Login...</body></html>");
 }
 void handleWindowsProbe() {  // /ncsi.txt and /connecttest.txt
-  Serial.println("[HTTP] Windows probe -> redirect");
+  LOGD("HTTP", "Windows probe -> redirect");
   sendRedirectToRoot();
 }
 
 // Generic: if host mismatches, redirect; otherwise serve index
 void handleAnyPath() {
   if (isCaptivePortal()) {
-    Serial.printf("[HTTP] Captive host redirect from path: %s\n", server.uri().c_str());
+    LOGD("HTTP", "Captive host redirect from path: %s", server.path());
     sendRedirectToRoot();
     return;
   }
-  Serial.printf("[HTTP] GET %s -> serve index\n", server.uri().c_str());
+  if (strncmp(server.path(), "/assets/", 8) == 0) {   // stale hash from an old shell
+    server.send(404, "text/plain", "Not Found");
+    return;
+  }
+  LOGD("HTTP", "GET %s -> serve index", server.path());
   handleRoot();
 }
 
-void handleScan() {
-  Serial.println("[HTTP] GET /api/wifi/scan -> starting scan...");
-  int n = WiFi.scanNetworks(/*async=*/false, /*show_hidden=*/true);
-  Serial.printf("[WIFI] Networks found: %d\n", n);
+ScanFilter scanFilterFromArgs() {
+  ScanFilter f;
+  f.minRssi = argInt("min_rssi", f.minRssi);
+  f.limit = constrain(argInt("limit", f.limit), 0, SCAN_MAX_ENTRIES);
+  if (const char* v = server.argValue("open_only")) {
+    f.openOnly = !strcmp(v, "1") || !strcmp(v, "true");
+  }
+  return f;
+}
 
-  DynamicJsonDocument doc(4096);
-  doc["status"] = "success";
-  doc["count"]  = (n > 0) ? n : 0;
-  JsonArray nets = doc.createNestedArray("networks");
-
-  if (n > 0) {
-    for (int i = 0; i < n; ++i) {
-      String encStr = encryptionTypeStr(WiFi.encryptionType(i));
-      bool isEnc = (WiFi.encryptionType(i) != WIFI_AUTH_OPEN);
-
-      JsonObject net = nets.createNestedObject();
-      net["ssid"]       = WiFi.SSID(i);
-      net["rssi"]       = WiFi.RSSI(i);
-      net["channel"]    = WiFi.channel(i);
-      net["bssid"]      = WiFi.BSSIDstr(i);
-      net["encryption"] = encStr;
-      net["encrypted"]  = isEnc;
-    }
+// Streams the cached scan as chunked JSON through a fixed buffer, so the
+// response size never depends on a preallocated document.
+ScanEntryPayload scanEntryPayload(const ScanEntry& e) {
+  ScanEntryPayload p;
+  memcpy(p.ssid, e.ssid, sizeof(p.ssid));
+  p.rssi       = e.rssi;
+  p.channel    = e.channel;
+  memcpy(p.bssid, e.bssid, sizeof(p.bssid));
+  p.encryption = encryptionTypeStr((wifi_auth_mode_t)e.auth);
+  p.encrypted  = e.auth != WIFI_AUTH_OPEN;
+  p.aps        = e.apCount;
+  return p;
+}
+
+void sendScanResults(const ScanFilter& f) {
+  size_t matching = 0;
+  for (size_t i = 0; i < scanCache.size() && matching < f.limit; ++i) {
+    if (f.matches(scanCache.at(i))) matching++;
+  }
+
+  JsonStream js(server);
+  js.beginObject();
+  js.add("status", "success");
+  js.add("count", matching);
+  js.add("total", scanCache.size());
+  js.add("raw", scanCache.rawCount());
+  js.add("age_ms", scanCache.ageMs());
+  js.beginArray("networks");
+  size_t sent = 0;
+  for (size_t i = 0; i < scanCache.size() && sent < matching; ++i) {
+    const ScanEntry& e = scanCache.at(i);
+    if (!f.matches(e)) continue;
+    js.addStruct(nullptr, scanEntryPayload(e));
+    sent++;
   }
+  js.endArray();
+  js.endObject();
+  js.end();
+}
 
+#ifdef JSON_STREAM_BENCH
+// The pre-streaming implementation (document + String), kept to compare
+// peak heap and time-to-first-byte against sendScanResults()
+void handleScanResultsDocument() {
+  JsonDocument doc;
+  doc["status"] = "success";
+  doc["count"]  = scanCache.size();
+  doc["total"]  = scanCache.size();
+  doc["raw"]    = scanCache.rawCount();
+  doc["age_ms"] = scanCache.ageMs();
+  JsonArray arr = doc["networks"].to<JsonArray>();
+  char bssid[18];
+  for (size_t i = 0; i < scanCache.size(); ++i) {
+    const ScanEntry& e = scanCache.at(i);
+    snprintf(bssid, sizeof(bssid), "%02X:%02X:%02X:%02X:%02X:%02X",
+             e.bssid[0], e.bssid[1], e.bssid[2], e.bssid[3], e.bssid[4], e.bssid[5]);
+    JsonObject o = arr.add<JsonObject>();
+    o["ssid"]       = e.ssid;
+    o["rssi"]       = e.rssi;
+    o["channel"]    = e.channel;
+    o["bssid"]      = bssid;
+    o["encryption"] = encryptionTypeStr((wifi_auth_mode_t)e.auth);
+    o["encrypted"]  = e.auth != WIFI_AUTH_OPEN;
+    o["aps"]        = e.apCount;
+  }
   String out;
   serializeJson(doc, out);
-  lastScanJson = out;
-  lastScanAvailable = true;
+  metricsHeapProbe();   // document and its serialization both alive
+  server.send(200, "application/json", out);
+}
 
+// Replaces the scan cache with ?n= synthetic networks (default 60)
+void handleScanSynthetic() {
+  size_t n = argInt("n", 60);
+  scanCache.synthesize(n);
+  server.send(200, "application/json", "{\"status\":\"success\"}");
+}
+#endif
+
+bool startFullScan() {
+  if (roamScanning()) {
+    fullScanRequested = true;   // pollScan() starts it once the radio is free
+    return true;
+  }
+  fullScanRequested = false;
+  if (WiFi.scanNetworks(/*async=*/true, /*show_hidden=*/true) != WIFI_SCAN_RUNNING) return false;
+  fullScanRunning = true;
+  return true;
+}
+
+void pollScan() {
+  if (fullScanRequested && !roamScanning() && !startFullScan()) {
+    LOGW("WIFI", "queued scan failed to start");
+  }
+  if (!fullScanRunning) return;
+  int16_t n = WiFi.scanComplete();
+  if (n == WIFI_SCAN_RUNNING) return;
+  fullScanRunning = false;
+  if (n >= 0) {
+    scanCache.update(n);
+    LOGI("WIFI", "Networks found: %d (%u after dedup)", n, (unsigned)scanCache.size());
+  }
   WiFi.scanDelete();
-  server.send(200, "application/json", out);
-  Serial.printf("[HTTP] /api/wifi/scan -> responded with %d networks\n", n);
+  bootMarkOnce("scan_done");
+}
+
+// Answers 202 and scans in the background (the UI polls /results); a scan
+// younger than SCAN_FRESH_MS is returned straight away.
+void handleScan() {
+  LOGD("HTTP", "GET /api/wifi/scan");
+  bool busy = fullScanRunning || fullScanRequested;
+  if (!busy && scanCache.valid() && scanCache.ageMs() < SCAN_FRESH_MS) {
+    sendScanResults(scanFilterFromArgs());
+    return;
+  }
+  if (!busy && !startFullScan()) {
+    server.send(500, "application/json",
+                "{\"status\":\"error\",\"message\":\"Scan failed to start\"}");
+    return;
+  }
+  server.send(202, "application/json", "{\"status\":\"scanning\"}");
 }
 
 void handleScanResults() {
-  Serial.println("[HTTP] GET /api/wifi/scan/results");
-  if (lastScanAvailable) {
-    server.send(200, "application/json", lastScanJson);
-  } else {
+  LOGD("HTTP", "GET /api/wifi/scan/results");
+  if (fullScanRunning || fullScanRequested) {
+    server.send(202, "application/json", "{\"status\":\"scanning\"}");
+  } else if (!scanCache.valid()) {
     server.send(404, "application/json",
                 "{\"status\":\"error\",\"message\":\"No scan results\"}");
+  } else if (scanCache.expired()) {
+    server.send(404, "application/json",
+                "{\"status\":\"error\",\"message\":\"Scan results expired\"}");
+  } else {
+    sendScanResults(scanFilterFromArgs());
   }
 }
 
 void handleConnect() {
-  Serial.println("[HTTP] POST /api/wifi/connect -> connect request");
+  LOGD("HTTP", "POST /api/wifi/connect -> connect request");
   if (server.method() != HTTP_POST) {
     server.send(405, "text/plain", "Method Not Allowed");
     return;
   }
 
-  String body = server.arg("plain");
-  Serial.printf("[HTTP] Body: %s\n", body.c_str());
-  DynamicJsonDocument req(512);
+  const char* body = server.argValue("plain");
+  if (!body) body = "";
+  LOGD("HTTP", "Body: %s", body);
+  JsonDocument req(&requestArena);
   if (deserializeJson(req, body)) {
     server.send(400, "application/json",
                 "{\"status\":\"error\",\"message\":\"Invalid JSON\"}");
@@ -215,148 +551,949 @@ void handleConnect() {
 
   const char* ssid = req["ssid"] | "";
   const char* password = req["password"] | "";
+  // Re-posting a saved network without "priority" keeps its place in the
+  // roaming order
+  int8_t priority = req["priority"].is<int>()
+                        ? (int8_t)constrain(req["priority"].as<int>(), -100, 100)
+                        : STA_PRIORITY_KEEP;
   if (strlen(ssid) == 0) {
     server.send(400, "application/json",
                 "{\"status\":\"error\",\"message\":\"Missing SSID\"}");
     return;
   }
 
-  Serial.printf("[WIFI] Connecting to SSID: %s\n", ssid);
-  if (strlen(password) > 0) WiFi.begin(ssid, password);
-  else                      WiFi.begin(ssid);
+  LOGI("WIFI", "Connecting to SSID: %s", ssid);
+  if (!staLinkConnect(ssid, password, priority)) {
+    server.send(400, "application/json",
+                "{\"status\":\"error\",\"message\":\"SSID or password too long\"}");
+    return;
+  }
 
+  // loop() is blocked here, so advance the link state machine while
+  // waiting; it only declares the link up (and persists the credentials
+  // with the new BSSID/channel/lease) on a fresh connect to this SSID, not
+  // on the link that was up before the request
+  WatchdogScope wd("wifi_connect_wait");
   int attempts = 0;
-  while (WiFi.status() != WL_CONNECTED && attempts < 40) {
+  while (staLinkConnecting() && attempts < 40) {
     delay(250);
-    Serial.print(".");
+    staLinkLoop();
     attempts++;
   }
-  Serial.println();
 
-  DynamicJsonDocument resp(512);
-  if (WiFi.status() == WL_CONNECTED) {
+  WifiState ws = wifiState();
+  bool up = staLinkUp() && strcmp(ws.ssid, ssid) == 0;
+  JsonDocument resp(&requestArena);
+  if (up) {
+    const char* ip = ipString(ws.ip);
     resp["status"]  = "success";
     resp["message"] = "Connected";
-    resp["ssid"]    = WiFi.SSID();
-    resp["ip"]      = WiFi.localIP().toString();
-    Serial.printf("[WIFI] Connected! IP: %s\n", WiFi.localIP().toString().c_str());
+    resp["ssid"]    = ws.ssid;
+    resp["ip"]      = ip;
+    LOGI("WIFI", "Connected! IP: %s", ip);
   } else {
     resp["status"]  = "error";
     resp["message"] = "Failed to connect";
-    Serial.println("[WIFI] Failed to connect.");
+    staLinkCancel();
+    LOGW("WIFI", "Failed to connect.");
   }
 
-  String out;
-  serializeJson(resp, out);
-  server.send(WiFi.status() == WL_CONNECTED ? 200 : 500, "application/json", out);
+  sendJson(up ? 200 : 500, resp);
 }
 
 void handleDisconnect() {
-  Serial.println("[HTTP] POST /api/wifi/disconnect -> disconnecting");
-  WiFi.disconnect(true, true);
+  LOGD("HTTP", "POST /api/wifi/disconnect -> disconnecting");
+  staLinkForget();
   server.send(200, "application/json",
               "{\"status\":\"success\",\"message\":\"Disconnected\"}");
 }
 
-void handleStatus() {
-  Serial.println("[HTTP] GET /api/wifi/status");
-  DynamicJsonDocument doc(512);
-  JsonObject ap = doc.createNestedObject("ap");
-  ap["ssid"] = apSSID;
-  ap["ip"]   = apIP.toString();
-  ap["connected_clients"] = WiFi.softAPgetStationNum();
+// Saved networks in priority order (passwords are never returned)
+void handleSaved() {
+  JsonDocument doc(&requestArena);
+  int current = staLinkCurrent();
+  JsonArray arr = doc["networks"].to<JsonArray>();
+  for (size_t i = 0; i < staLinkNetworkCount(); i++) {
+    const StaNetwork* n = staLinkNetworkAt(i);
+    JsonObject o = arr.add<JsonObject>();
+    o["ssid"]     = n->ssid;
+    o["priority"] = n->priority;
+    o["secure"]   = n->pass[0] != '\0';
+    o["channel"]  = n->channel;
+    o["current"]  = (int)i == current;
+  }
+  doc["max"] = STA_MAX_NETWORKS;
+  sendJson(200, doc);
+}
 
-  JsonObject sta = doc.createNestedObject("sta");
-  sta["connected"] = (WiFi.status() == WL_CONNECTED);
-  if (WiFi.status() == WL_CONNECTED) {
-    sta["ssid"] = WiFi.SSID();
-    sta["ip"]   = WiFi.localIP().toString();
-    sta["rssi"] = WiFi.RSSI();
+void handleForget() {
+  JsonDocument req(&requestArena);
+  const char* ssid = "";
+  const char* body = server.argValue("plain");
+  if (body && !deserializeJson(req, body)) ssid = req["ssid"] | "";
+  if (!staLinkForgetNetwork(ssid)) {
+    server.send(404, "application/json",
+                "{\"status\":\"error\",\"message\":\"Unknown network\"}");
+    return;
   }
+  server.send(200, "application/json", "{\"status\":\"success\"}");
+}
 
-  String out;
-  serializeJson(doc, out);
-  server.send(200, "application/json", out);
+void fillWifiStatus(WifiStatusPayload& p) {
+  WifiState ws = wifiState();
+  p.ap.ssid             = apSSID;
+  p.ap.ip               = apIP;
+  p.ap.connectedClients = ws.apClients;
+
+  p.mqtt.deviceId  = deviceId;
+  p.mqtt.topic     = mqttTopic;
+  p.mqtt.connected = mqttClient.connected();
+  p.mqtt.missed    = publishesMissed;
+  p.mqtt.batches   = publishedBatches;
+
+  StaStatusPayload& sta = p.sta;
+  sta.connected = ws.staConnected;
+  if (sta.connected) {
+    memcpy(sta.ssid, ws.ssid, sizeof(sta.ssid));
+    sta.ip      = ws.ip;
+    sta.rssi    = ws.rssi;
+    memcpy(sta.bssid, ws.bssid, sizeof(sta.bssid));
+    sta.channel = ws.channel;
+  }
+  // Reconnect instrumentation: which path brought the link up and how long
+  // it took (compare cold vs fast across reboots)
+  const StaLinkTiming& t = staLinkTiming();
+  sta.saved             = staLinkHasCredentials();
+  sta.connecting        = staLinkConnecting();
+  sta.connectPath       = staLinkPathName(t.path);
+  sta.connectMs         = t.connectMs;
+  sta.bootToConnectedMs = t.bootToConnectMs;
+  sta.fastFallbacks     = t.fallbacks;
+
+  // Roaming: moves, how long the link was down for each, and the RSSI
+  // before/after the last move
+  const StaLinkStats& ls = staLinkStats();
+  const RoamStats& rs = roamStats();
+  sta.roam.roams        = ls.roams;
+  sta.roam.switches     = rs.switches;
+  sta.roam.failures     = ls.roamFailures;
+  sta.roam.lastRoamMs   = ls.lastRoamMs;
+  sta.roam.avgRoamMs    = ls.roams ? ls.totalRoamMs / ls.roams : 0;
+  sta.roam.maxRoamMs    = ls.maxRoamMs;
+  sta.roam.lastFromRssi = rs.lastFromRssi;
+  sta.roam.lastToRssi   = rs.lastToRssi;
+  sta.roam.scans        = rs.scans;
+  sta.roam.scanFailures = rs.scanFailures;
+  sta.roam.lastScanMs   = rs.lastScanMs;
+  sta.outages.count   = ls.outages;
+  sta.outages.lastMs  = ls.lastOutageMs;
+  sta.outages.maxMs   = ls.maxOutageMs;
+  sta.outages.totalMs = ls.totalOutageMs;
+}
+
+// Status changes at no single point (RSSI, counters, ...), so its ETag is a
+// hash of the body: it is serialized once into a buffer, hashed, and only
+// a changed document is sent. Pollers with an unchanged view get a
+// bodyless 304.
+void handleStatus() {
+  LOGD("HTTP", "GET /api/wifi/status");
+  static char body[WifiStatusPayload::jsonMaxLen()];
+  WifiStatusPayload p;
+  fillWifiStatus(p);
+  size_t len = p.toJson(body) - body;
+  uint32_t h = 2166136261u;   // FNV-1a
+  for (size_t i = 0; i < len; ++i) h = (h ^ (uint8_t)body[i]) * 16777619u;
+  char etag[12];
+  snprintf(etag, sizeof(etag), "\"%08lx\"", (unsigned long)h);
+  server.sendHeader("Cache-Control", "no-cache");
+  if (sendNotModified(etag)) return;
+  server.send_P(200, "application/json", body, len);
+}
+
+SensorPayload sensorPayload(const SensorSample& s) {
+  SensorPayload p;
+  p.tempCenti     = s.tempCenti;
+  p.humidityCenti = s.humidityCenti;
+  p.light         = s.light;
+  p.seq           = s.seq;
+  return p;
 }
 
+// Latest sample, ETag "<boot id>-<seq>". With ?since=<seq>: every retained
+// sample newer than that (oldest first), or 304 when there is none. A
+// `since` ahead of the device (it rebooted) resends everything retained.
 void handleSensors() {
-  // Provide the same values the device is publishing to MQTT
-  DynamicJsonDocument doc(256);
-  doc["temperature"] = tempVal;
-  doc["humidity"]    = humidityVal;
-  doc["light"]       = lightVal;
+  const SensorSample* latest = samplesLatest();
+  uint32_t seq = samplesSeq();
+  server.sendHeader("Cache-Control", "no-cache");
 
-  String out;
-  serializeJson(doc, out);
-  server.send(200, "application/json", out);
-  Serial.printf("[HTTP] /api/sensors -> %s\n", out.c_str());
+  if (const char* sinceArg = server.argValue("since")) {
+    uint32_t since = strtoul(sinceArg, nullptr, 10);
+    if (since > seq) since = 0;
+    static SensorSample samples[SAMPLE_HISTORY];
+    size_t n = samplesSince(since, samples, SAMPLE_HISTORY);
+    if (n == 0) {
+      server.send(304, nullptr, "");
+      return;
+    }
+    uint32_t now = millis();
+    JsonStream js(server);
+    js.beginObject();
+    js.add("seq", seq);
+    js.add("missed", samples[0].seq - since - 1);   // aged out of the ring
+    js.beginArray("samples");
+    for (size_t i = 0; i < n; ++i) {
+      js.beginObject();
+      js.add("seq", samples[i].seq);
+      js.add("age_ms", now - samples[i].ms);
+      uint64_t ts = sampleTime(samples[i]);
+      if (ts) js.add("ts", ts);
+      js.addFixed("temperature", samples[i].tempCenti, 2);
+      js.addFixed("humidity", samples[i].humidityCenti, 2);
+      js.add("light", samples[i].light);
+      js.endObject();
+    }
+    js.endArray();
+    js.endObject();
+    js.end();
+    return;
+  }
+
+  char etag[24];
+  snprintf(etag, sizeof(etag), "\"%08lx-%lu\"", (unsigned long)samplesBootId(), (unsigned long)seq);
+  if (sendNotModified(etag)) return;
+  char out[SensorPayload::jsonMaxLen()];
+  size_t len = sensorPayload(*latest).toJson(out) - out;
+  server.send_P(200, "application/json", out, len);
+  LOGD("HTTP", "/api/sensors -> %.*s", (int)len, out);
+}
+
+// Everything the dashboard polls for in one response: latest sample, AP
+// and STA status, system stats. ?fields=sensors,ap,sta,system selects
+// sections (default all).
+enum SnapshotField : uint8_t {
+  SNAPSHOT_SENSORS = 1 << 0,
+  SNAPSHOT_AP      = 1 << 1,
+  SNAPSHOT_STA     = 1 << 2,
+  SNAPSHOT_SYSTEM  = 1 << 3,
+  SNAPSHOT_ALL     = 0x0f,
+};
+static const char* const SNAPSHOT_FIELD_NAMES[] = { "sensors", "ap", "sta", "system" };
+
+// Comma-separated section names -> SnapshotField mask; false on an unknown name
+bool parseSnapshotFields(const char* arg, uint8_t* mask) {
+  *mask = 0;
+  const char* p = arg;
+  while (*p) {
+    const char* end = strchr(p, ',');
+    size_t len = end ? (size_t)(end - p) : strlen(p);
+    bool known = len == 0;
+    for (uint8_t i = 0; i < 4 && !known; ++i) {
+      if (strlen(SNAPSHOT_FIELD_NAMES[i]) == len && strncmp(p, SNAPSHOT_FIELD_NAMES[i], len) == 0) {
+        *mask |= 1 << i;
+        known = true;
+      }
+    }
+    if (!known) return false;
+    p += end ? len + 1 : len;
+  }
+  return true;
+}
+
+// Read once per request, so the ETag dry run and the body see the same values
+struct SnapshotState {
+  const SensorSample* sample;
+  WifiState wifi;
+  uint32_t uptimeS;
+  uint32_t freeHeap;
+  uint32_t minFreeHeap;
+  uint32_t heapSize;
+};
+
+// Uptime and heap move on every request; they are left out of the dry run
+// that derives the (weak) ETag, so a 304 means nothing else changed
+void writeSnapshot(JsonStream& js, const SnapshotState& st, uint8_t fields, bool volatileStats) {
+  js.beginObject();
+  if (fields & SNAPSHOT_SENSORS) {
+    const SensorSample& s = *st.sample;
+    js.beginObject("sensors");
+    js.add("seq", s.seq);
+    uint64_t ts = sampleTime(s);
+    if (ts) js.add("ts", ts);
+    js.addFixed("temperature", s.tempCenti, 2);
+    js.addFixed("humidity", s.humidityCenti, 2);
+    js.add("light", s.light);
+    js.endObject();
+  }
+  if (fields & SNAPSHOT_AP) {
+    js.beginObject("ap");
+    js.add("ssid", apSSID);
+    js.add("ip", ipString(apIP));
+    js.add("connected_clients", st.wifi.apClients);
+    js.endObject();
+  }
+  if (fields & SNAPSHOT_STA) {
+    js.beginObject("sta");
+    js.add("connected", st.wifi.staConnected);
+    if (st.wifi.staConnected) {
+      js.add("ssid", st.wifi.ssid);
+      js.add("ip", ipString(st.wifi.ip));
+      js.add("rssi", st.wifi.rssi);
+    }
+    js.add("connecting", staLinkConnecting());
+    js.endObject();
+  }
+  if (fields & SNAPSHOT_SYSTEM) {
+    js.beginObject("system");
+    js.add("heap_size", st.heapSize);
+    js.add("time_source", timeSourceName());
+    if (volatileStats) {
+      js.add("uptime_s", st.uptimeS);
+      js.add("free_heap", st.freeHeap);
+      js.add("min_free_heap", st.minFreeHeap);
+    }
+    js.endObject();
+  }
+  js.endObject();
+}
+
+// Conditional GET: ETag W/"<boot id>-<hash>", 304 while the selected
+// sections are unchanged
+void handleSnapshot() {
+  uint8_t fields = SNAPSHOT_ALL;
+  const char* fieldsArg = server.argValue("fields");
+  if (fieldsArg && (!parseSnapshotFields(fieldsArg, &fields) || fields == 0)) {
+    server.send(400, "application/json",
+                "{\"status\":\"error\",\"message\":\"Unknown field\"}");
+    return;
+  }
+
+  SnapshotState st;
+  st.sample      = samplesLatest();
+  st.wifi        = wifiState();
+  st.uptimeS     = millis() / 1000;
+  st.freeHeap    = ESP.getFreeHeap();
+  st.minFreeHeap = ESP.getMinFreeHeap();
+  st.heapSize    = ESP.getHeapSize();
+
+  JsonStream probe;
+  writeSnapshot(probe, st, fields, false);
+  probe.end();
+  char etag[24];
+  snprintf(etag, sizeof(etag), "W/\"%08lx-%08lx\"", (unsigned long)samplesBootId(), (unsigned long)probe.hash());
+  server.sendHeader("Cache-Control", "no-cache");
+  if (sendNotModified(etag)) return;
+  JsonStream js(server);
+  writeSnapshot(js, st, fields, true);
+  js.end();
+}
+
+// Server-side request timing, consumed by tools/http_bench.py
+void handleMetrics() {
+  JsonDocument doc(&requestArena);
+  uint32_t windowMs = metricsWindowMs();
+  doc["window_ms"] = windowMs;
+  doc["free_heap"] = ESP.getFreeHeap();
+  doc["min_free_heap"] = ESP.getMinFreeHeap();
+
+  JsonArray arr = doc["routes"].to<JsonArray>();
+  for (size_t i = 0; i < metricsRouteCount(); ++i) {
+    const RouteMetrics* r = metricsRouteAt(i);
+    if (r->count == 0) continue;
+    JsonObject o = arr.add<JsonObject>();
+    o["route"]   = r->name;
+    o["count"]   = r->count;
+    o["rps"]     = windowMs ? (r->count * 1000.0f / windowMs) : 0.0f;
+    o["avg_us"]  = (uint32_t)(r->totalUs / r->count);
+    o["p50_us"]  = metricsPercentile(r, 50);
+    o["p99_us"]  = metricsPercentile(r, 99);
+    o["max_us"]  = r->maxUs;
+    o["heap_delta_avg"] = (int32_t)(r->heapDeltaSum / (int64_t)r->count);
+    o["heap_delta_max"] = r->heapDeltaMax;
+    o["peak_heap_avg"]  = (uint32_t)(r->heapPeakSum / r->count);
+    o["peak_heap_max"]  = r->heapPeakMax;
+  }
+
+  const CaptiveDnsStats& ds = dnsServer.stats();
+  JsonObject dns = doc["dns"].to<JsonObject>();
+  dns["queries"]   = ds.queries;
+  dns["answered"]  = ds.answered;
+  dns["nodata"]    = ds.nodata;
+  dns["rejected"]  = ds.rejected;
+  dns["max_burst"] = ds.maxBurst;
+  dns["qps"]       = windowMs ? (ds.queries * 1000.0f / windowMs) : 0.0f;
+  dns["avg_us"]    = ds.queries ? (uint32_t)(ds.busyUs / ds.queries) : 0;
+  dns["forwarding"] = dnsServer.forwarding();
+  if (dnsServer.forwarding()) dns["upstream"] = ipString(dnsServer.upstream());
+  const DnsCacheStats& cs = dnsServer.cacheStats();
+  uint32_t lookups = cs.hits + cs.misses;
+  dns["cache_hits"]     = cs.hits;
+  dns["cache_misses"]   = cs.misses;
+  dns["cache_hit_rate"] = lookups ? (cs.hits * 1.0f / lookups) : 0.0f;
+  dns["cache_evictions"] = cs.evictions;
+  dns["hit_avg_us"]     = cs.hits ? (uint32_t)(ds.hitUs / cs.hits) : 0;
+  dns["forwarded"]      = ds.forwarded;
+  dns["upstream_avg_us"] = ds.upstreamReplies ? (uint32_t)(ds.upstreamUs / ds.upstreamReplies) : 0;
+  dns["upstream_timeouts"] = ds.upstreamTimeouts;
+  dns["upstream_rejected"] = ds.upstreamRejected;
+
+  const HttpServerStats& hs = server.stats();
+  JsonObject http = doc["http"].to<JsonObject>();
+  http["accepted"]     = hs.accepted;
+  http["requests"]     = hs.requests;
+  http["reused"]       = hs.reused;
+  http["pipelined"]    = hs.pipelined;
+  http["closed_idle"]  = hs.closedIdle;
+  http["evicted"]      = hs.evicted;
+  http["rejected"]     = hs.rejected;
+  http["bad_requests"] = hs.badRequests;
+  http["open"]         = server.openConnections();
+  http["max_open"]     = hs.maxOpen;
+  http["cpu_us_per_req"] = hs.requests ? (uint32_t)(hs.busyUs / hs.requests) : 0;
+
+  const MqttBrokerStats& bs = broker.stats();
+  JsonObject brk = doc["broker"].to<JsonObject>();
+  brk["clients"]          = broker.clientCount();
+  brk["retained"]         = broker.retainedCount();
+  brk["accepted"]         = bs.accepted;
+  brk["rejected"]         = bs.rejected;
+  brk["timeouts"]         = bs.timeouts;
+  brk["protocol_errors"]  = bs.protocolErrors;
+  brk["received"]         = bs.received;
+  brk["local"]            = bs.local;
+  brk["delivered"]        = bs.delivered;
+  brk["dropped"]          = bs.dropped;
+  brk["retained_dropped"] = bs.retainedDropped;
+  brk["pubacks"]          = bs.pubacks;
+  brk["avg_fanout_us"]    = bs.fanouts ? (uint32_t)(bs.fanoutUs / bs.fanouts) : 0;
+  brk["max_fanout_us"]    = bs.maxFanoutUs;
+
+  const ReportStats& rs = reportFilter.stats();
+  JsonObject report = doc["report"].to<JsonObject>();
+  report["enabled"]    = REPORT_CONFIG.enabled;
+  report["sent"]       = rs.sent;
+  report["suppressed"] = rs.suppressed;
+  report["heartbeats"] = rs.heartbeats;
+  report["held"]       = rs.held;
+  report["sent_ratio"] = rs.sent + rs.suppressed ? (rs.sent * 1.0f / (rs.sent + rs.suppressed)) : 0.0f;
+
+  JsonObject arena = doc["arena"].to<JsonObject>();
+  const Arena* arenas[] = { &requestArena, &mqttArena };
+  const char*  arenaNames[] = { "request", "mqtt" };
+  for (size_t i = 0; i < 2; ++i) {
+    const ArenaStats& as = arenas[i]->stats();
+    JsonObject a = arena[arenaNames[i]].to<JsonObject>();
+    a["capacity"]    = as.capacity;
+    a["high_water"]  = as.highWater;
+    a["allocations"] = as.allocations;
+    a["fallbacks"]   = as.fallbacks;
+    a["resets"]      = as.resets;
+  }
+
+  const WifiStateStats& wss = wifiStateStats();
+  JsonObject wifi = doc["wifi"].to<JsonObject>();
+  wifi["version"]    = wifiStateVersion();
+  wifi["events"]     = wss.events;
+  wifi["rssi_reads"] = wss.rssiReads;
+
+  const TimeSyncStats& ts = timeSyncStats();
+  JsonObject wall = doc["time"].to<JsonObject>();
+  wall["source"]      = timeSourceName();
+  wall["server"]      = timeSyncServer();
+  wall["now_ms"]      = timeNowMs();
+  wall["requests"]    = ts.requests;
+  wall["syncs"]       = ts.syncs;
+  wall["timeouts"]    = ts.timeouts;
+  wall["rejected"]    = ts.rejected;
+  wall["offset_ms"]   = ts.lastOffsetMs;
+  wall["max_abs_offset_ms"] = ts.maxAbsOffsetMs;
+  wall["delay_ms"]    = ts.lastDelayMs;
+  wall["delay_avg_ms"] = ts.syncs ? (uint32_t)(ts.delaySumMs / ts.syncs) : 0;
+  wall["delay_max_ms"] = ts.maxDelayMs;
+  if (timeSource() != TIME_MONOTONIC) wall["since_sync_ms"] = millis() - ts.lastSyncMs;
+
+  JsonObject filters = doc["filters"].to<JsonObject>();
+  filters["temperature_rejected"] = tempFilter.rejected();
+  filters["humidity_rejected"]    = humidityFilter.rejected();
+
+  sendJson(200, doc);
+}
+
+// Recent log entries: ?since=<seq> returns only newer ones, ?level=<1..4>
+// caps the verbosity (1 = errors only)
+void handleLogs() {
+  uint32_t since = argInt("since", 0);
+  uint8_t  maxLevel = argInt("level", LOG_LEVEL_DEBUG);
+
+  static LogEntry entries[LOG_HISTORY];
+  size_t n = logHistory(since, entries, LOG_HISTORY);
+  LogStats st = logStats();
+
+  JsonStream js(server);
+  js.beginObject();
+  js.add("written", st.written);
+  js.add("dropped", st.dropped);
+  js.add("suppressed", st.suppressed);
+  uint32_t last = since;
+  char level[2] = {0, 0};
+  js.beginArray("entries");
+  for (size_t i = 0; i < n; ++i) {
+    const LogEntry& e = entries[i];
+    last = e.seq;
+    if (e.level > maxLevel) continue;
+    level[0] = logLevelChar(e.level);
+    js.beginObject();
+    js.add("seq", e.seq);
+    js.add("ms", e.ms);
+    js.add("level", level);
+    js.add("tag", e.tag);
+    js.add("msg", e.msg);
+    js.endObject();
+  }
+  js.endArray();
+  js.add("last_seq", last);
+  js.endObject();
+  js.end();
+}
+
+#ifdef LOG_BENCH
+// Cycle cost per logging call vs. the old synchronous Serial.printf
+void handleLogBench() {
+  LogBenchResult r = logBenchmark(200);
+  JsonDocument doc(&requestArena);
+  doc["cpu_mhz"]         = ESP.getCpuFreqMHz();
+  doc["enabled_cycles"]  = r.enabledCycles;
+  doc["filtered_cycles"] = r.filteredCycles;
+  doc["limited_cycles"]  = r.limitedCycles;
+  doc["serial_cycles"]   = r.serialCycles;
+  sendJson(200, doc);
+}
+#endif
+
+#ifdef FORMAT_BENCH
+// Cycles per MQTT sensor payload: fixed-point formatter vs. snprintf("%.2f")
+void handleFormatBench() {
+  const uint16_t N = 500;
+  char buf[TELEMETRY_PAYLOAD_LEN];
+  uint32_t fixedCycles = 0, printfCycles = 0;
+  for (uint16_t i = 0; i < N; ++i) {
+    int32_t temp = 1500 + i * 7, light = 400 + i, humidity = 4000 + i * 3;
+    uint32_t t0 = ESP.getCycleCount();
+    telemetrySensorPayload(buf, sizeof(buf), temp, light, humidity, 0);
+    uint32_t t1 = ESP.getCycleCount();
+    telemetrySensorPayloadPrintf(buf, sizeof(buf), temp, light, humidity, 0);
+    uint32_t t2 = ESP.getCycleCount();
+    fixedCycles  += t1 - t0;
+    printfCycles += t2 - t1;
+  }
+  JsonDocument doc(&requestArena);
+  doc["cpu_mhz"]         = ESP.getCpuFreqMHz();
+  doc["payloads"]        = N;
+  doc["fixed_cycles"]    = fixedCycles / N;
+  doc["snprintf_cycles"] = printfCycles / N;
+  sendJson(200, doc);
+}
+#endif
+
+#ifdef SERIALIZER_BENCH
+template <typename T>
+void serializerBenchRun(JsonArray arr, const char* name, const T& v, uint16_t n,
+                        size_t (*generated)(const T&, char*),
+                        size_t (*document)(const T&, char*, size_t)) {
+  static char gen[WifiStatusPayload::jsonMaxLen()];
+  static char ref[WifiStatusPayload::jsonMaxLen()];
+  size_t genLen = 0, docLen = 0;
+  uint32_t t0 = ESP.getCycleCount();
+  for (uint16_t i = 0; i < n; ++i) genLen = generated(v, gen);
+  uint32_t t1 = ESP.getCycleCount();
+  for (uint16_t i = 0; i < n; ++i) docLen = document(v, ref, sizeof(ref));
+  uint32_t t2 = ESP.getCycleCount();
+  JsonObject o = arr.add<JsonObject>();
+  o["payload"]          = name;
+  o["generated_cycles"] = (t1 - t0) / n;
+  o["document_cycles"]  = (t2 - t1) / n;
+  o["generated_bytes"]  = genLen;
+  o["document_bytes"]   = docLen;
+  o["identical"]        = genLen == docLen && memcmp(gen, ref, genLen) == 0;
+}
+
+// Cycles per payload: generated serializers vs. an ArduinoJson document,
+// on the live sample, status and first scan entry
+void handleSerializerBench() {
+  uint16_t iterations = argInt("iterations", 200);
+  if (iterations == 0) iterations = 1;
+  SensorPayload sensor = sensorPayload(*samplesLatest());
+  static WifiStatusPayload status;
+  fillWifiStatus(status);
+  ScanEntry e = {};
+  if (scanCache.size() > 0) e = scanCache.at(0);
+  else { strcpy(e.ssid, "Greenhouse-2.4G"); e.rssi = -61; e.channel = 6; e.auth = WIFI_AUTH_WPA2_PSK; e.apCount = 2; }
+  ScanEntryPayload entry = scanEntryPayload(e);
+
+  JsonDocument doc(&requestArena);
+  doc["cpu_mhz"]    = ESP.getCpuFreqMHz();
+  doc["iterations"] = iterations;
+  JsonArray arr = doc["payloads"].to<JsonArray>();
+  serializerBenchRun(arr, "sensor", sensor, iterations, sensorPayloadGenerated, sensorPayloadDocument);
+  serializerBenchRun(arr, "scan_entry", entry, iterations, scanEntryPayloadGenerated, scanEntryPayloadDocument);
+  serializerBenchRun(arr, "wifi_status", status, iterations, wifiStatusPayloadGenerated, wifiStatusPayloadDocument);
+  sendJson(200, doc);
+}
+#endif
+
+#ifdef DSP_BENCH
+// Cycles per sample and error against the clean reference for each filter,
+// replaying the trace in dsp.cpp
+void handleDspBench() {
+  uint16_t iterations = argInt("iterations", 50);
+  DspBenchResult r = dspBenchmark(iterations);
+  JsonDocument doc(&requestArena);
+  doc["cpu_mhz"]   = ESP.getCpuFreqMHz();
+  doc["trace_len"] = r.traceLen;
+  JsonArray arr = doc["filters"].to<JsonArray>();
+  for (const DspBenchFilter& f : r.filters) {
+    JsonObject o = arr.add<JsonObject>();
+    o["name"]      = f.name;
+    o["cycles"]    = f.cycles;
+    o["rms_error"] = f.rmsError;
+    o["max_error"] = f.maxError;
+  }
+  sendJson(200, doc);
+}
+#endif
+
+void handleMetricsReset() {
+  metricsReset();
+  dnsServer.resetStats();
+  server.resetStats();
+  timeSyncResetStats();
+  watchdogResetStats();
+  requestArena.resetStats();
+  mqttArena.resetStats();
+  broker.resetStats();
+  reportFilter.resetStats();
+  server.send(200, "application/json", "{\"status\":\"success\"}");
 }
 
+// Loop latency against the SLO, per-stage timing and the last stall. The
+// stall record survives resets, so after a watchdog or panic reboot it
+// names the stage trail (and call-site PCs, for addr2line) that hung.
+void handleWatchdog() {
+  const WatchdogStats& st = watchdogStats();
+  char hex[11];
+  JsonStream js(server);
+  js.beginObject();
+  js.add("slo_ms", st.sloMs);
+  js.add("stall_ms", st.stallMs);
+  js.add("loops", st.loops);
+  js.add("avg_loop_us", st.loops ? (uint32_t)(st.totalUs / st.loops) : 0);
+  js.add("max_loop_us", st.maxUs);
+  js.add("violations", st.violations);
+  js.add("stalls", st.stalls);
+  js.beginArray("stages");
+  for (size_t i = 0; i < watchdogStageCount(); ++i) {
+    const WatchdogStageStats* s = watchdogStageAt(i);
+    js.beginObject();
+    js.add("stage", s->name);
+    js.add("count", s->count);
+    js.add("avg_us", s->count ? (uint32_t)(s->totalUs / s->count) : 0);
+    js.add("max_us", s->maxUs);
+    js.add("violations", s->violations);
+    js.endObject();
+  }
+  js.endArray();
+  if (st.violations) {
+    js.beginObject("last_violation");
+    js.add("stage", st.lastViolationStage ? st.lastViolationStage : "");
+    js.add("loop_us", st.lastViolationUs);
+    js.add("ago_ms", (uint32_t)(millis() - st.lastViolationMs));
+    js.endObject();
+  }
+  js.add("boot_count", watchdogBootCount());
+  js.add("reset_reason", watchdogResetReason());
+  WatchdogStall stall;
+  if (watchdogLastStall(&stall)) {
+    js.beginObject("last_stall");
+    js.add("this_boot", stall.bootCount == watchdogBootCount());
+    js.add("boot", stall.bootCount);
+    js.add("uptime_ms", stall.uptimeMs);
+    if (stall.tsMs) js.add("ts", stall.tsMs);
+    js.add("duration_ms", stall.durationMs);
+    js.add("finished", stall.finished);
+    js.beginArray("trail");
+    for (uint8_t i = 0; i < stall.depth; ++i) {
+      snprintf(hex, sizeof(hex), "0x%08lx", (unsigned long)stall.pc[i]);
+      js.beginObject();
+      js.add("stage", stall.stage[i]);
+      js.add("pc", hex);
+      js.endObject();
+    }
+    js.endArray();
+    js.endObject();
+  } else {
+    js.addNull("last_stall");
+  }
+  js.endObject();
+  js.end();
+}
+
+// Boot timeline: every stage with its offset from app start and the time
+// since the previous stage. "first_http_response" is the portal's real
+// readiness as seen by a client.
+void handleBoot() {
+  JsonDocument doc(&requestArena);
+  doc["uptime_ms"] = millis();
+  doc["setup_us"]  = bootMarkUs("http_up") - bootMarkUs("setup");
+  doc["first_http_response_us"] = bootMarkUs("first_http_response");
+  const StaLinkTiming& t = staLinkTiming();
+  doc["sta_connect_path"] = staLinkPathName(t.path);
+  doc["boot_to_connected_ms"] = t.bootToConnectMs;
+
+  JsonArray stages = doc["stages"].to<JsonArray>();
+  uint32_t prev = 0;
+  for (size_t i = 0; i < bootMarkCount(); i++) {
+    const BootMark* m = bootMarkAt(i);
+    JsonObject o = stages.add<JsonObject>();
+    o["stage"]    = m->stage;
+    o["at_us"]    = m->us;
+    o["delta_us"] = m->us - prev;
+    prev = m->us;
+  }
+  sendJson(200, doc);
+}
+
+#ifdef BOOT_BENCH
+// Lets tools/boot_bench.py repeat cold boots without touching the board
+void handleBootRestart() {
+  server.send(200, "application/json", "{\"status\":\"restarting\"}");
+  server.flush();
+  delay(100);   // let the response leave before the stack goes down
+  ESP.restart();
+}
+#endif
+
 // ========================= SETUP ===========================
+// Only what the captive portal needs runs here (AP, DNS, HTTP); everything
+// else is deferred to runDeferredInit() so phones get answers sooner.
 void setup() {
-  // Give the serial monitor a moment to attach
-  delay(200);
+  bootMark("setup");
   Serial.begin(115200);
-  delay(200);
   Serial.println();
-  Serial.println("===== ESP32 WiFi Manager Booting =====");
+  logBegin();
+  LOGI("BOOT", "===== ESP32 WiFi Manager Booting =====");
+  bootMark("log");
+  watchdogBegin(LOOP_SLO_MS, LOOP_STALL_MS);
+  LOGI("BOOT", "boot #%lu, reset reason: %s", (unsigned long)watchdogBootCount(), watchdogResetReason());
 
   WiFi.persistent(false);
+  wifiStateBegin();
   WiFi.mode(WIFI_AP_STA);
+  bootMark("wifi_mode");
+
+  uint8_t mac[6];
+  WiFi.macAddress(mac);
+  telemetryDeviceId(mac, deviceId, sizeof(deviceId));
+  telemetryTopic(mqttTopic, sizeof(mqttTopic), MQTT_SITE, MQTT_ZONE, deviceId, TELEMETRY_CHANNEL_SENSORS);
+  telemetryTopic(mqttStatusTopic, sizeof(mqttStatusTopic), MQTT_SITE, MQTT_ZONE, deviceId, TELEMETRY_CHANNEL_STATUS);
+  telemetryTopic(mqttBatchTopic, sizeof(mqttBatchTopic), MQTT_SITE, MQTT_ZONE, deviceId, TELEMETRY_CHANNEL_BATCH);
+  LOGI("BOOT", "device id: %s", deviceId);
+  samplesBegin();
+  sampleSensors();
 
   // Configure AP IP explicitly (more reliable on some cores)
   if (!WiFi.softAPConfig(apIP, apGateway, apSubnet)) {
-    Serial.println("[AP] softAPConfig FAILED, using default 192.168.4.1");
+    LOGW("AP", "softAPConfig FAILED, using default 192.168.4.1");
   }
   bool apOk = WiFi.softAP(apSSID, apPassword);
   if (!apOk) {
-    Serial.println("[AP] softAP FAILED!");
+    LOGE("AP", "softAP FAILED!");
   } else {
-    Serial.printf("[AP] SSID: %s  PASS: %s  IP: %s\n",
+    LOGI("AP", "SSID: %s  PASS: %s  IP: %s",
                   apSSID, apPassword, WiFi.softAPIP().toString().c_str());
   }
+  bootMark("ap_up");
 
   // Start DNS wildcard -> everything to our AP IP
-  bool dnsOk = dnsServer.start(DNS_PORT, "*", apIP);
-  Serial.printf("[DNS] start(%d, *, %s) -> %s\n", DNS_PORT,
+  bool dnsOk = dnsServer.begin(apIP, DNS_PORT);
+  LOGI("DNS", "start(%d, *, %s) -> %s", DNS_PORT,
                 apIP.toString().c_str(), dnsOk ? "OK" : "FAIL");
+  bootMark("dns_up");
 
   // --- Web routes ---
+  // Every route is wrapped in timedHandler() so /api/metrics can report
+  // per-route latency percentiles and heap deltas.
   // Captive portal / OS probes
-  server.on("/generate_204", HTTP_ANY, handleAndroidProbe);   // Android
-  server.on("/hotspot-detect.html", HTTP_ANY, handleAppleProbe); // iOS/macOS
-  server.on("/ncsi.txt", HTTP_ANY, handleWindowsProbe);       // Windows
-  server.on("/connecttest.txt", HTTP_ANY, handleWindowsProbe);// Win alt
+  server.on("/generate_204", HTTP_ANY, timedHandler("/generate_204", handleAndroidProbe));               // Android
+  server.on("/hotspot-detect.html", HTTP_ANY, timedHandler("/hotspot-detect.html", handleAppleProbe));   // iOS/macOS
+  server.on("/ncsi.txt", HTTP_ANY, timedHandler("/ncsi.txt", handleWindowsProbe));                       // Windows
+  server.on("/connecttest.txt", HTTP_ANY, timedHandler("/connecttest.txt", handleWindowsProbe));         // Win alt
 
   // API
-  server.on("/api/wifi/scan",        HTTP_GET,  handleScan);
-  server.on("/api/wifi/scan/results",HTTP_GET,  handleScanResults);
-  server.on("/api/wifi/connect",     HTTP_POST, handleConnect);
-  server.on("/api/wifi/disconnect",  HTTP_POST, handleDisconnect);
-  server.on("/api/wifi/status",      HTTP_GET,  handleStatus);
-  server.on("/api/sensors",          HTTP_GET,  handleSensors);
+  server.on("/api/wifi/scan",        HTTP_GET,  timedHandler("/api/wifi/scan", handleScan));
+  server.on("/api/wifi/scan/results",HTTP_GET,  timedHandler("/api/wifi/scan/results", handleScanResults));
+  server.on("/api/wifi/connect",     HTTP_POST, timedHandler("/api/wifi/connect", handleConnect));
+  server.on("/api/wifi/disconnect",  HTTP_POST, timedHandler("/api/wifi/disconnect", handleDisconnect));
+  server.on("/api/wifi/saved",       HTTP_GET,  timedHandler("/api/wifi/saved", handleSaved));
+  server.on("/api/wifi/forget",      HTTP_POST, timedHandler("/api/wifi/forget", handleForget));
+  server.on("/api/wifi/status",      HTTP_GET,  timedHandler("/api/wifi/status", handleStatus));
+  server.on("/api/sensors",          HTTP_GET,  timedHandler("/api/sensors", handleSensors));
+  server.on("/api/snapshot",         HTTP_GET,  timedHandler("/api/snapshot", handleSnapshot));
+  server.on("/api/metrics",          HTTP_GET,  handleMetrics);
+  server.on("/api/metrics/reset",    HTTP_POST, handleMetricsReset);
+  server.on("/api/logs",             HTTP_GET,  handleLogs);
+  server.on("/api/boot",             HTTP_GET,  handleBoot);
+  server.on("/api/watchdog",         HTTP_GET,  handleWatchdog);
+#ifdef BOOT_BENCH
+  server.on("/api/boot/restart",     HTTP_POST, handleBootRestart);
+#endif
+#ifdef LOG_BENCH
+  server.on("/api/logs/bench",       HTTP_POST, handleLogBench);
+#endif
+#ifdef FORMAT_BENCH
+  server.on("/api/format/bench",     HTTP_POST, handleFormatBench);
+#endif
+#ifdef DSP_BENCH
+  server.on("/api/dsp/bench",        HTTP_POST, handleDspBench);
+#endif
+#ifdef SERIALIZER_BENCH
+  server.on("/api/serializer/bench", HTTP_POST, handleSerializerBench);
+#endif
+#ifdef JSON_STREAM_BENCH
+  server.on("/api/wifi/scan/results/document", HTTP_GET, timedHandler("/api/wifi/scan/results/document", handleScanResultsDocument));
+  server.on("/api/wifi/scan/synthetic", HTTP_POST, handleScanSynthetic);
+#endif
 
-  // Dashboard at "/" and also catch-all for any HTTP path
-  server.on("/", HTTP_ANY, handleRoot);
-  server.onNotFound(handleAnyPath);
+  // Dashboard at "/" and also catch-all for any HTTP path; hashed CSS/JS
+  // share one metrics slot
+  server.on("/", HTTP_ANY, timedHandler("/", handleRoot));
+  for (size_t i = 1; i < WEB_ASSET_COUNT; ++i) {
+    const WebAsset* a = &WEB_ASSETS[i];
+    server.on(a->path, HTTP_GET, timedHandler("/assets", [a]() { sendAsset(*a); }));
+  }
+  server.onNotFound(timedHandler("*", handleAnyPath));
 
+  server.setArena(&requestArena);
   server.begin();
-  Serial.println("[HTTP] server started on port 80");
+  LOGI("HTTP", "server started on port 80");
+  bootMark("http_up");
+  LOGI("BOOT", "Setup complete in %lu us.", (unsigned long)(micros() - bootMarkUs("setup")));
+}
+
+// ===================== DEFERRED INIT ======================
+// Runs one step per loop tick after setup(), so DNS and HTTP are serviced
+// in between.
+static uint8_t deferredStep = 0;
 
-  // MQTT setup
-  mqttClient.setServer(mqttServer, mqttPort);
-  Serial.printf("[MQTT] broker: %s:%d topic: %s\n", mqttServer, mqttPort, mqttTopic);
-  Serial.println("[BOOT] Setup complete.");
+void runDeferredInit() {
+  switch (deferredStep) {
+    case 0:
+      // Broker name is resolved on the first connect, once STA is up
+      mqttClient.setServer(mqttServer, mqttPort);
+      // Room for a full batch (PubSubClient's default is 256 bytes)
+      mqttClient.setBufferSize(TELEMETRY_BATCH_LEN(SAMPLE_HISTORY) + TELEMETRY_TOPIC_LEN + 8);
+      timeSyncBegin(sntpServer);
+      LOGI("MQTT", "broker: %s:%d topic: %s", mqttServer, mqttPort, mqttTopic);
+      bootMark("mqtt_config");
+      break;
+    case 1:
+      // Local broker for AP clients; "online" is retained on the status topic
+      broker.begin(apIP);
+      broker.publish(mqttStatusTopic, "online", true);
+      LOGI("BRKR", "local broker on %s:%u", apIP.toString().c_str(), BROKER_PORT);
+      bootMark("broker_up");
+      break;
+    case 2:
+      // Reconnect to the last network (fast path if BSSID/channel are cached)
+      staLinkBegin();
+      bootMark("sta_begin");
+      break;
+    case 3:
+      // Nothing to reconnect to: the user will want the network list, so
+      // warm the scan cache in the background. Skipped otherwise so the
+      // scan does not compete with the fast reconnect.
+      if (!staLinkHasCredentials() && startFullScan()) {
+        bootMark("scan_start");
+      }
+      break;
+    default:
+      return;
+  }
+  deferredStep++;
+}
+
+
+// Switches DNS between wildcard (AP only) and forwarding (STA up) mode
+void updateDnsMode(bool staConnected) {
+  IPAddress resolver;
+  if (staConnected) {
+    if (!dnsUpstreamOverride || !resolver.fromString(dnsUpstreamOverride)) {
+      resolver = WiFi.dnsIP();
+    }
+  }
+  if (resolver == dnsServer.upstream()) return;
+  dnsServer.setUpstream(resolver);
+  if (dnsServer.forwarding()) {
+    LOGI("DNS", "forwarding to %s (probe hosts still captive)", resolver.toString().c_str());
+  } else {
+    LOGI("DNS", "wildcard mode -> everything to AP IP");
+  }
 }
 
 // ========================= LOOP ============================
+// Each step is a watchdog stage, so SLO violations and stalls name it
 void loop() {
-  dnsServer.processNextRequest();
+  watchdogLoopStart();
+  watchdogStage("deferred_init");
+  runDeferredInit();
+  watchdogStage("scan");
+  pollScan();
+  watchdogStage("sta_link");
+  staLinkLoop();
+  watchdogStage("roam");
+  roamLoop(!fullScanRunning && !fullScanRequested);
+  watchdogStage("wifi_state");
+  wifiStateLoop();
+  bool staConnected = wifiStaConnected();
+  // Upstream DNS only changes with the link; skip the driver query otherwise
+  static uint32_t dnsModeVersion = 0;
+  watchdogStage("dns_mode");
+  if (wifiStateVersion() != dnsModeVersion) {
+    dnsModeVersion = wifiStateVersion();
+    updateDnsMode(staConnected);
+  }
+  watchdogStage("time_sync");
+  timeSyncLoop(staConnected);
+
+  // Serve DNS and HTTP every tick; phones joining the AP send bursts of
+  // lookups and the portal only pops up once they are all answered.
+  watchdogStage("dns");
+  dnsServer.process();
+  watchdogStage("http");
   server.handleClient();
+  watchdogStage("broker");
+  broker.loop();
 
-  if (WiFi.status() == WL_CONNECTED) {
-    publishSensorData();
+  static bool firstDnsMarked = false;
+  if (!firstDnsMarked && dnsServer.stats().queries > 0) {
+    firstDnsMarked = true;
+    bootMark("first_dns_query");
+  }
+
+  static unsigned long lastPublish = 0;
+  if (millis() - lastPublish >= PUBLISH_INTERVAL_MS) {
+    lastPublish = millis();
+    watchdogStage("sample");
+    sampleSensors();
+    watchdogStage("publish");
+    mqttArena.reset();
+    publishLocal();
+    if (staConnected) {
+      publishSensorData();
+    } else if (!staLinkHasCredentials()) {
+      publishedSeq = samplesSeq();   // no network configured: nothing is owed
+    }
   }
+  watchdogLoopEnd();
 
-  delay(1000);
+  delay(1);
 }
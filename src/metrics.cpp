@@ -0,0 +1,106 @@
+#include "metrics.h"
+#include "boot_profile.h"
+#include "loop_watchdog.h"
+
+static RouteMetrics routes[METRICS_MAX_ROUTES];
+static size_t       routeCount = 0;
+static uint32_t     windowStartMs = 0;
+
+// Bucket layout: values < 4us map 1:1, above that each power of two is
+// split into 4 linear sub-buckets (max relative error ~25%).
+static uint8_t bucketFor(uint32_t us) {
+  if (us < 4) return us;
+  uint8_t msb = 31 - __builtin_clz(us);
+  uint8_t sub = (us >> (msb - 2)) & 0x3;
+  uint32_t idx = (uint32_t)(msb - 1) * 4 + sub;
+  return idx < METRICS_HIST_BUCKETS ? idx : METRICS_HIST_BUCKETS - 1;
+}
+
+static uint32_t bucketUpperUs(uint8_t idx) {
+  if (idx < 4) return idx;
+  uint8_t msb = idx / 4 + 1;
+  uint8_t sub = idx % 4;
+  return ((4u + sub + 1) << (msb - 2)) - 1;
+}
+
+RouteMetrics* metricsRoute(const char* name) {
+  for (size_t i = 0; i < routeCount; ++i) {
+    if (strcmp(routes[i].name, name) == 0) return &routes[i];
+  }
+  if (routeCount >= METRICS_MAX_ROUTES) return nullptr;
+  RouteMetrics* r = &routes[routeCount++];
+  memset(r, 0, sizeof(*r));
+  r->name = name;
+  return r;
+}
+
+void metricsRecord(RouteMetrics* r, uint32_t us, int32_t heapDelta, uint32_t heapPeak) {
+  if (!r) return;
+  r->count++;
+  r->totalUs += us;
+  if (us > r->maxUs) r->maxUs = us;
+  r->heapDeltaSum += heapDelta;
+  if (heapDelta > r->heapDeltaMax) r->heapDeltaMax = heapDelta;
+  r->heapPeakSum += heapPeak;
+  if (heapPeak > r->heapPeakMax) r->heapPeakMax = heapPeak;
+  uint16_t& slot = r->hist[bucketFor(us)];
+  if (slot < UINT16_MAX) slot++;
+}
+
+uint32_t metricsPercentile(const RouteMetrics* r, uint8_t pct) {
+  if (!r || r->count == 0) return 0;
+  uint32_t total = 0;
+  for (size_t i = 0; i < METRICS_HIST_BUCKETS; ++i) total += r->hist[i];
+  uint32_t target = (total * pct + 99) / 100;
+  uint32_t seen = 0;
+  for (size_t i = 0; i < METRICS_HIST_BUCKETS; ++i) {
+    seen += r->hist[i];
+    if (seen >= target) return min(bucketUpperUs(i), r->maxUs);
+  }
+  return r->maxUs;
+}
+
+size_t metricsRouteCount() { return routeCount; }
+
+const RouteMetrics* metricsRouteAt(size_t i) {
+  return i < routeCount ? &routes[i] : nullptr;
+}
+
+uint32_t metricsWindowMs() { return millis() - windowStartMs; }
+
+void metricsReset() {
+  for (size_t i = 0; i < routeCount; ++i) {
+    const char* name = routes[i].name;
+    memset(&routes[i], 0, sizeof(routes[i]));
+    routes[i].name = name;
+  }
+  windowStartMs = millis();
+}
+
+static bool     firstResponseMarked = false;
+static uint32_t heapLow = UINT32_MAX;   // lowest probe of the request being timed
+
+void metricsHeapProbe() {
+  uint32_t free = ESP.getFreeHeap();
+  if (free < heapLow) heapLow = free;
+}
+
+std::function<void(void)> timedHandler(const char* route, std::function<void(void)> fn) {
+  RouteMetrics* r = metricsRoute(route);
+  return [r, route, fn]() {
+    WatchdogScope wd(route);   // a stall inside a handler names the route
+    uint32_t heapBefore = ESP.getFreeHeap();
+    heapLow = heapBefore;
+    uint32_t t0 = micros();
+    fn();
+    uint32_t us = micros() - t0;
+    uint32_t heapAfter = ESP.getFreeHeap();
+    if (heapAfter < heapLow) heapLow = heapAfter;
+    metricsRecord(r, us, (int32_t)heapBefore - (int32_t)heapAfter, heapBefore - heapLow);
+    heapLow = UINT32_MAX;
+    if (!firstResponseMarked) {
+      firstResponseMarked = true;
+      bootMark("first_http_response");
+    }
+  };
+}
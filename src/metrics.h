@@ -0,0 +1,44 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+#include <functional>
+
+// Per-route HTTP timing collected on the device.
+// Latency goes into a log-linear histogram (4 sub-buckets per power of two),
+// so p50/p99 are reported as the upper edge of the matching bucket.
+
+#define METRICS_MAX_ROUTES   24
+#define METRICS_HIST_BUCKETS 96
+
+struct RouteMetrics {
+  const char* name;
+  uint32_t count;
+  uint64_t totalUs;
+  uint32_t maxUs;
+  int64_t  heapDeltaSum;   // free heap before - after, summed over requests
+  int32_t  heapDeltaMax;
+  uint64_t heapPeakSum;    // free heap before - lowest point seen during the request
+  uint32_t heapPeakMax;
+  uint16_t hist[METRICS_HIST_BUCKETS];
+};
+
+// Returns the slot for `name`, registering it on first use (nullptr if full).
+RouteMetrics* metricsRoute(const char* name);
+void          metricsRecord(RouteMetrics* r, uint32_t us, int32_t heapDelta, uint32_t heapPeak = 0);
+uint32_t      metricsPercentile(const RouteMetrics* r, uint8_t pct);
+
+size_t              metricsRouteCount();
+const RouteMetrics* metricsRouteAt(size_t i);
+uint32_t            metricsWindowMs();   // time since last reset
+void                metricsReset();
+
+// Wraps an HTTP handler so every call is timed and accounted to `route`.
+std::function<void(void)> timedHandler(const char* route, std::function<void(void)> fn);
+
+// Samples free heap inside the handler being timed. Call it where a handler
+// holds the most memory (e.g. right before sending a serialized document);
+// the lowest sample gives the request's peak heap use.
+void metricsHeapProbe();
+
+#endif // METRICS_H
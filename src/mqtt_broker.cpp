@@ -0,0 +1,443 @@
+#include "mqtt_broker.h"
+#include "log.h"
+
+enum : uint8_t {
+  MQTT_CONNECT = 1, MQTT_CONNACK, MQTT_PUBLISH, MQTT_PUBACK,
+  MQTT_SUBSCRIBE = 8, MQTT_SUBACK, MQTT_UNSUBSCRIBE, MQTT_UNSUBACK,
+  MQTT_PINGREQ, MQTT_PINGRESP, MQTT_DISCONNECT,
+};
+
+// ===================== Helpers ============================
+// Remaining length: bytes used, 0 if more are needed, -1 if malformed
+static int decodeLength(const uint8_t* p, size_t avail, uint32_t* out) {
+  uint32_t v = 0;
+  for (size_t i = 0; i < 4; i++) {
+    if (i >= avail) return 0;
+    v |= (uint32_t)(p[i] & 0x7f) << (7 * i);
+    if (!(p[i] & 0x80)) {
+      *out = v;
+      return i + 1;
+    }
+  }
+  return -1;
+}
+
+static size_t encodeLength(uint8_t* p, uint32_t v) {
+  size_t n = 0;
+  do {
+    uint8_t b = v & 0x7f;
+    v >>= 7;
+    p[n++] = v ? b | 0x80 : b;
+  } while (v);
+  return n;
+}
+
+static bool readString(const uint8_t*& p, const uint8_t* end, const char** s, uint16_t* len) {
+  if (end - p < 2) return false;
+  uint16_t n = (p[0] << 8) | p[1];
+  if (end - p - 2 < n) return false;
+  *s = (const char*)p + 2;
+  *len = n;
+  p += 2 + n;
+  return true;
+}
+
+// '+' matches one level, a trailing '#' any number (including none: "a/#"
+// matches "a"); wildcards at the start do not match "$..." topics
+static bool topicMatches(const char* f, const char* t) {
+  if (*t == '$' && (*f == '+' || *f == '#')) return false;
+  for (;;) {
+    if (*f == '#') return true;
+    if (*f == '+') {
+      f++;
+      while (*t && *t != '/') t++;
+    } else {
+      while (*f && *f != '/') {
+        if (*f++ != *t++) return false;
+      }
+    }
+    if (*f == '\0' && *t == '\0') return true;
+    if (*f == '/' && *t == '/') {
+      f++;
+      t++;
+      continue;
+    }
+    return *t == '\0' && !strcmp(f, "/#");
+  }
+}
+
+// Wildcards only as whole levels, '#' only last
+static bool validFilter(const char* f) {
+  if (!*f) return false;
+  for (const char* p = f; *p; p++) {
+    bool levelStart = p == f || p[-1] == '/';
+    bool levelEnd = p[1] == '\0' || p[1] == '/';
+    if (*p == '+' && !(levelStart && levelEnd)) return false;
+    if (*p == '#' && !(levelStart && p[1] == '\0')) return false;
+  }
+  return true;
+}
+
+// ===================== Connections ========================
+bool MqttBroker::begin(IPAddress apIP, uint16_t port) {
+  apIP_ = apIP;
+  server_.begin(port);
+  server_.setNoDelay(true);
+  running_ = true;
+  return true;
+}
+
+uint8_t MqttBroker::clientCount() const {
+  uint8_t n = 0;
+  for (const Client& c : clients_) n += c.connected;
+  return n;
+}
+
+uint8_t MqttBroker::retainedCount() const {
+  uint8_t n = 0;
+  for (const Retained& r : retained_) n += r.topic[0] != '\0';
+  return n;
+}
+
+void MqttBroker::closeClient(Client& c) {
+  if (!c.open) return;
+  c.sock.stop();
+  c.open = false;
+  c.connected = false;
+  c.len = 0;
+  c.id[0] = '\0';
+  for (Sub& s : c.subs) s.filter[0] = '\0';
+}
+
+void MqttBroker::acceptClients() {
+  for (int i = 0; i < BROKER_MAX_CLIENTS && server_.hasClient(); i++) {
+    WiFiClient nc = server_.accept();
+    if (!nc) return;
+    stats_.accepted++;
+
+    Client* slot = nullptr;
+    for (Client& c : clients_) {
+      if (!c.open) { slot = &c; break; }
+    }
+    if (!slot || nc.localIP() != apIP_) {
+      stats_.rejected++;
+      nc.stop();
+      continue;
+    }
+    nc.setNoDelay(true);
+    slot->sock = nc;
+    slot->open = true;
+    slot->connected = false;
+    slot->keepAliveS = 0;
+    slot->nextId = 1;
+    slot->len = 0;
+    slot->lastRxMs = millis();
+  }
+}
+
+void MqttBroker::loop() {
+  if (!running_) return;
+  acceptClients();
+
+  uint32_t now = millis();
+  for (Client& c : clients_) {
+    if (!c.open) continue;
+
+    int avail = c.sock.available();
+    if (avail > 0) {
+      size_t room = BROKER_RX_BUF - c.len;
+      int n = room ? c.sock.read(c.buf + c.len, min((size_t)avail, room)) : 0;
+      if (n > 0) {
+        c.len += n;
+        c.lastRxMs = now;
+      }
+    } else if (!c.sock.connected()) {
+      closeClient(c);
+      continue;
+    }
+
+    // Keep-alive allows 1.5x the client's interval; 0 disables it
+    uint32_t limit = c.connected ? c.keepAliveS * 1500UL : BROKER_CONNECT_TIMEOUT_MS;
+    if (limit && now - c.lastRxMs > limit) {
+      stats_.timeouts++;
+      closeClient(c);
+      continue;
+    }
+
+    for (int k = 0; k < BROKER_MAX_BURST && c.open && c.len > 0; k++) {
+      int used = handlePacket(c);
+      if (used == 0) break;
+      if (used < 0) {
+        stats_.protocolErrors++;
+        closeClient(c);
+        break;
+      }
+      if (!c.open) break;   // DISCONNECT, or a failed write to itself
+      memmove(c.buf, c.buf + used, c.len - used);
+      c.len -= used;
+    }
+  }
+}
+
+bool MqttBroker::send(Client& c, const uint8_t* data, size_t len) {
+  if (c.sock.write(data, len) == len) return true;
+  closeClient(c);
+  return false;
+}
+
+// ===================== Packets ============================
+int MqttBroker::handlePacket(Client& c) {
+  if (c.len < 2) return 0;
+  uint32_t rem;
+  int lenBytes = decodeLength(c.buf + 1, c.len - 1, &rem);
+  if (lenBytes <= 0) return lenBytes;
+  size_t total = 1 + lenBytes + rem;
+  if (total > BROKER_RX_BUF) return -1;
+  if (c.len < total) return 0;
+
+  uint8_t type = c.buf[0] >> 4;
+  uint8_t flags = c.buf[0] & 0x0f;
+  const uint8_t* p = c.buf + 1 + lenBytes;
+  const uint8_t* end = c.buf + total;
+  if (c.connected == (type == MQTT_CONNECT)) return -1;   // CONNECT first, and only once
+
+  bool ok;
+  switch (type) {
+    case MQTT_CONNECT:     ok = handleConnect(c, p, end); break;
+    case MQTT_PUBLISH:     ok = handlePublish(c, flags, p, end); break;
+    case MQTT_PUBACK:      stats_.pubacks++; ok = true; break;
+    case MQTT_SUBSCRIBE:   ok = flags == 2 && handleSubscribe(c, p, end); break;
+    case MQTT_UNSUBSCRIBE: ok = flags == 2 && handleUnsubscribe(c, p, end); break;
+    case MQTT_PINGREQ: {
+      static const uint8_t PINGRESP[] = { MQTT_PINGRESP << 4, 0 };
+      ok = send(c, PINGRESP, sizeof(PINGRESP));
+      break;
+    }
+    case MQTT_DISCONNECT:
+      closeClient(c);
+      ok = true;
+      break;
+    default:
+      ok = false;
+  }
+  return ok ? (int)total : -1;
+}
+
+bool MqttBroker::handleConnect(Client& c, const uint8_t* p, const uint8_t* end) {
+  const char* proto;
+  uint16_t protoLen;
+  if (!readString(p, end, &proto, &protoLen) || end - p < 4) return false;
+  uint8_t level = p[0];
+  uint16_t keepAlive = (p[2] << 8) | p[3];
+  p += 4;
+
+  uint8_t connack[] = { MQTT_CONNACK << 4, 2, 0, 0 };
+  const char* id = nullptr;
+  uint16_t idLen = 0;
+  if (protoLen != 4 || memcmp(proto, "MQTT", 4) != 0 || level != 4) {
+    connack[3] = 1;   // unacceptable protocol version
+  } else if (!readString(p, end, &id, &idLen)) {
+    return false;
+  } else if (idLen >= BROKER_CLIENT_ID_LEN) {
+    connack[3] = 2;   // identifier rejected
+  }
+  if (connack[3]) {
+    send(c, connack, sizeof(connack));
+    return false;
+  }
+
+  if (idLen) {
+    memcpy(c.id, id, idLen);
+    c.id[idLen] = '\0';
+  } else {
+    snprintf(c.id, sizeof(c.id), "local-%u", ++nextAnonId_);
+  }
+  // A second connection with the same client id takes over
+  for (Client& o : clients_) {
+    if (&o != &c && o.connected && !strcmp(o.id, c.id)) closeClient(o);
+  }
+  c.connected = true;
+  c.keepAliveS = keepAlive;
+  stats_.connects++;
+  LOGD("BRKR", "%s connected (keep-alive %us)", c.id, keepAlive);
+  return send(c, connack, sizeof(connack));
+}
+
+bool MqttBroker::handlePublish(Client& c, uint8_t flags, const uint8_t* p, const uint8_t* end) {
+  uint8_t qos = (flags >> 1) & 3;
+  bool retain = flags & 1;
+  const char* name;
+  uint16_t nameLen;
+  if (qos > 1 || !readString(p, end, &name, &nameLen)) return false;
+  if (nameLen == 0 || nameLen >= BROKER_TOPIC_LEN) return false;
+  char topic[BROKER_TOPIC_LEN];
+  memcpy(topic, name, nameLen);
+  topic[nameLen] = '\0';
+  if (strpbrk(topic, "+#") || strlen(topic) != nameLen) return false;
+
+  uint16_t id = 0;
+  if (qos) {
+    if (end - p < 2) return false;
+    id = (p[0] << 8) | p[1];
+    p += 2;
+  }
+  stats_.received++;
+  route(topic, p, end - p, retain, qos);
+  if (!qos) return true;
+  if (!c.open) return true;   // dropped while routing (its own subscription failed)
+  uint8_t puback[] = { MQTT_PUBACK << 4, 2, (uint8_t)(id >> 8), (uint8_t)id };
+  return send(c, puback, sizeof(puback));
+}
+
+uint8_t MqttBroker::addSub(Client& c, const char* filter, uint8_t qos) {
+  if (!validFilter(filter)) return 0x80;
+  Sub* slot = nullptr;
+  for (Sub& s : c.subs) {
+    if (!strcmp(s.filter, filter)) { slot = &s; break; }   // resubscribe replaces
+    if (!slot && !s.filter[0]) slot = &s;
+  }
+  if (!slot) return 0x80;
+  strcpy(slot->filter, filter);
+  slot->qos = qos;
+  return qos;
+}
+
+bool MqttBroker::handleSubscribe(Client& c, const uint8_t* p, const uint8_t* end) {
+  if (end - p < 2) return false;
+  uint8_t suback[4 + BROKER_MAX_SUB_BATCH] = { MQTT_SUBACK << 4, 2, p[0], p[1] };
+  p += 2;
+  char filters[BROKER_MAX_SUB_BATCH][BROKER_TOPIC_LEN];
+  size_t n = 0;
+  while (p < end) {
+    const char* f;
+    uint16_t fLen;
+    if (n == BROKER_MAX_SUB_BATCH || !readString(p, end, &f, &fLen) || p == end) return false;
+    uint8_t qos = *p++;
+    if (qos > 2) return false;
+    if (fLen == 0 || fLen >= BROKER_TOPIC_LEN) {
+      filters[n][0] = '\0';
+      suback[4 + n] = 0x80;
+    } else {
+      memcpy(filters[n], f, fLen);
+      filters[n][fLen] = '\0';
+      suback[4 + n] = strlen(filters[n]) == fLen ? addSub(c, filters[n], min(qos, (uint8_t)1)) : 0x80;
+    }
+    n++;
+  }
+  if (n == 0) return false;
+  suback[1] = 2 + n;
+  if (!send(c, suback, 4 + n)) return true;
+
+  // Retained messages follow the SUBACK
+  for (size_t i = 0; i < n && c.open; i++) {
+    if (suback[4 + i] != 0x80) sendRetained(c, filters[i], suback[4 + i]);
+  }
+  return true;
+}
+
+bool MqttBroker::handleUnsubscribe(Client& c, const uint8_t* p, const uint8_t* end) {
+  if (end - p < 2) return false;
+  uint8_t unsuback[] = { MQTT_UNSUBACK << 4, 2, p[0], p[1] };
+  p += 2;
+  if (p == end) return false;
+  while (p < end) {
+    const char* f;
+    uint16_t fLen;
+    if (!readString(p, end, &f, &fLen)) return false;
+    for (Sub& s : c.subs) {
+      if (strlen(s.filter) == fLen && !memcmp(s.filter, f, fLen)) s.filter[0] = '\0';
+    }
+  }
+  return send(c, unsuback, sizeof(unsuback));
+}
+
+// ===================== Routing ============================
+void MqttBroker::publish(const char* topic, const uint8_t* payload, size_t len, bool retain, uint8_t qos) {
+  if (!running_) return;
+  stats_.local++;
+  route(topic, payload, len, retain, min(qos, (uint8_t)1));
+}
+
+void MqttBroker::route(const char* topic, const uint8_t* payload, size_t len, bool retain, uint8_t qos) {
+  if (retain) storeRetained(topic, payload, len, qos);
+  txQos_ = -1;
+  uint32_t t0 = micros();
+  uint32_t sent = 0;
+  for (Client& c : clients_) {
+    if (!c.connected) continue;
+    int granted = -1;   // a client with overlapping filters gets it once, at the highest QoS
+    for (const Sub& s : c.subs) {
+      if (s.filter[0] && (int)s.qos > granted && topicMatches(s.filter, topic)) granted = s.qos;
+    }
+    if (granted < 0) continue;
+    // Live messages go out without the retain flag
+    if (deliver(c, topic, payload, len, min((uint8_t)granted, qos), false)) sent++;
+  }
+  if (sent == 0) return;
+  uint32_t us = micros() - t0;
+  stats_.fanouts++;
+  stats_.fanoutUs += us;
+  if (us > stats_.maxFanoutUs) stats_.maxFanoutUs = us;
+}
+
+void MqttBroker::storeRetained(const char* topic, const uint8_t* payload, size_t len, uint8_t qos) {
+  Retained* slot = nullptr;
+  for (Retained& r : retained_) {
+    if (!strcmp(r.topic, topic)) { slot = &r; break; }
+    if (!slot && !r.topic[0]) slot = &r;
+  }
+  bool existing = slot && slot->topic[0];
+  if (len == 0 || len > BROKER_RETAINED_LEN || !slot) {
+    if (len > 0) stats_.retainedDropped++;
+    if (existing) slot->topic[0] = '\0';   // an empty retained message clears the topic
+    return;
+  }
+  strcpy(slot->topic, topic);
+  slot->qos = qos;
+  slot->len = len;
+  memcpy(slot->payload, payload, len);
+}
+
+void MqttBroker::sendRetained(Client& c, const char* filter, uint8_t qos) {
+  for (const Retained& r : retained_) {
+    if (!r.topic[0] || !topicMatches(filter, r.topic)) continue;
+    txQos_ = -1;
+    if (!deliver(c, r.topic, r.payload, r.len, min(qos, r.qos), true)) return;
+  }
+}
+
+bool MqttBroker::deliver(Client& c, const char* topic, const uint8_t* payload, size_t len, uint8_t qos, bool retain) {
+  if ((int8_t)qos != txQos_ || retain != txRetain_) {
+    size_t topicLen = strlen(topic);
+    uint32_t rem = 2 + topicLen + (qos ? 2 : 0) + len;
+    if (rem + 5 > sizeof(tx_)) {
+      stats_.dropped++;
+      return false;
+    }
+    size_t n = 0;
+    tx_[n++] = (MQTT_PUBLISH << 4) | (qos << 1) | (retain ? 1 : 0);
+    n += encodeLength(tx_ + n, rem);
+    tx_[n++] = topicLen >> 8;
+    tx_[n++] = topicLen;
+    memcpy(tx_ + n, topic, topicLen);
+    n += topicLen;
+    txIdPos_ = n;
+    if (qos) n += 2;
+    memcpy(tx_ + n, payload, len);
+    txLen_ = n + len;
+    txQos_ = qos;
+    txRetain_ = retain;
+  }
+  if (qos) {
+    uint16_t id = c.nextId++;
+    if (c.nextId == 0) c.nextId = 1;
+    tx_[txIdPos_]     = id >> 8;
+    tx_[txIdPos_ + 1] = id;
+  }
+  if (!send(c, tx_, txLen_)) {
+    stats_.dropped++;
+    return false;
+  }
+  stats_.delivered++;
+  return true;
+}
@@ -0,0 +1,124 @@
+#ifndef MQTT_BROKER_H
+#define MQTT_BROKER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+// Minimal MQTT 3.1.1 broker for clients on the AP network.
+//
+// Local controllers and phones subscribe here and get the same sensor
+// samples the device publishes upstream, whether or not the uplink is up.
+// Supported: CONNECT (clean sessions only; will, username and password are
+// ignored), PUBLISH at QoS 0/1 in both directions, SUBSCRIBE/UNSUBSCRIBE
+// with + and # wildcards, retained messages, PINGREQ and DISCONNECT. A QoS 2
+// publish closes the connection. There is no session state, so a QoS 1
+// message goes out once and its PUBACK is only counted.
+//
+// Everything is sized at compile time: a fixed client table, a few topic
+// filters per client and a small retained store. A message is encoded once
+// into a shared frame and written to every matching subscriber right away,
+// from publish() for the firmware's own messages and from loop() for the
+// clients'. Connections that do not arrive on the AP interface are refused.
+
+#define BROKER_PORT               1883
+#define BROKER_MAX_CLIENTS        8
+#define BROKER_MAX_SUBS           4      // topic filters per client
+#define BROKER_MAX_SUB_BATCH      8      // filters in one SUBSCRIBE
+#define BROKER_TOPIC_LEN          64     // topic names and filters, with the NUL
+#define BROKER_CLIENT_ID_LEN      24
+#define BROKER_RX_BUF             512    // largest packet accepted from a client
+#define BROKER_TX_BUF             1024   // largest packet sent (a full sample batch)
+#define BROKER_MAX_RETAINED       8
+#define BROKER_RETAINED_LEN       128    // larger retained payloads are delivered, not kept
+#define BROKER_MAX_BURST          8      // packets handled per client per loop()
+#define BROKER_CONNECT_TIMEOUT_MS 5000   // TCP open without a CONNECT
+
+struct MqttBrokerStats {
+  uint32_t accepted;        // TCP connections
+  uint32_t rejected;        // table full or not on the AP interface
+  uint32_t connects;        // CONNECT accepted
+  uint32_t timeouts;        // keep-alive or CONNECT deadline missed
+  uint32_t protocolErrors;  // malformed / unsupported packet -> closed
+  uint32_t received;        // PUBLISH from clients
+  uint32_t local;           // publish() from the firmware
+  uint32_t delivered;       // PUBLISH written to subscribers
+  uint32_t dropped;         // too large to send, or the subscriber's socket failed
+  uint32_t retainedDropped; // retained message not kept (store full / too large)
+  uint32_t pubacks;         // QoS 1 acks from subscribers
+  uint32_t fanouts;         // messages with at least one subscriber
+  uint32_t maxFanoutUs;
+  uint64_t fanoutUs;        // sum of the time to write a message to all its subscribers
+};
+
+class MqttBroker {
+ public:
+  // Listens on `port`, accepting clients whose connection arrives at `apIP`
+  bool begin(IPAddress apIP, uint16_t port = BROKER_PORT);
+  void loop();
+
+  // A message from the firmware itself, fanned out before returning
+  void publish(const char* topic, const uint8_t* payload, size_t len, bool retain = false, uint8_t qos = 0);
+  void publish(const char* topic, const char* payload, bool retain = false) {
+    publish(topic, (const uint8_t*)payload, strlen(payload), retain);
+  }
+
+  uint8_t clientCount() const;
+  uint8_t retainedCount() const;
+  const MqttBrokerStats& stats() const { return stats_; }
+  void resetStats() { stats_ = {}; }
+
+ private:
+  struct Sub {
+    char    filter[BROKER_TOPIC_LEN];   // "" = free
+    uint8_t qos;
+  };
+  struct Client {
+    WiFiClient sock;
+    bool       open;
+    bool       connected;     // CONNECT accepted
+    uint16_t   keepAliveS;
+    uint16_t   nextId;        // QoS 1 packet ids
+    uint16_t   len;           // bytes buffered
+    uint32_t   lastRxMs;
+    char       id[BROKER_CLIENT_ID_LEN];
+    Sub        subs[BROKER_MAX_SUBS];
+    uint8_t    buf[BROKER_RX_BUF];
+  };
+  struct Retained {
+    char     topic[BROKER_TOPIC_LEN];   // "" = free
+    uint8_t  qos;
+    uint16_t len;
+    uint8_t  payload[BROKER_RETAINED_LEN];
+  };
+
+  void acceptClients();
+  void closeClient(Client& c);
+  int  handlePacket(Client& c);   // bytes consumed, 0 = incomplete, -1 = close
+  bool handleConnect(Client& c, const uint8_t* p, const uint8_t* end);
+  bool handlePublish(Client& c, uint8_t flags, const uint8_t* p, const uint8_t* end);
+  bool handleSubscribe(Client& c, const uint8_t* p, const uint8_t* end);
+  bool handleUnsubscribe(Client& c, const uint8_t* p, const uint8_t* end);
+  uint8_t addSub(Client& c, const char* filter, uint8_t qos);   // granted QoS or 0x80
+
+  void route(const char* topic, const uint8_t* payload, size_t len, bool retain, uint8_t qos);
+  void storeRetained(const char* topic, const uint8_t* payload, size_t len, uint8_t qos);
+  void sendRetained(Client& c, const char* filter, uint8_t qos);
+  bool deliver(Client& c, const char* topic, const uint8_t* payload, size_t len, uint8_t qos, bool retain);
+  bool send(Client& c, const uint8_t* data, size_t len);
+
+  WiFiServer      server_{BROKER_PORT, BROKER_MAX_CLIENTS};
+  IPAddress       apIP_;
+  bool            running_ = false;
+  uint16_t        nextAnonId_ = 0;
+  Client          clients_[BROKER_MAX_CLIENTS];
+  Retained        retained_[BROKER_MAX_RETAINED] = {};
+  // Last encoded PUBLISH, reused while topic/QoS/retain stay the same
+  uint8_t         tx_[BROKER_TX_BUF];
+  size_t          txLen_ = 0;
+  size_t          txIdPos_ = 0;     // offset of the packet id (QoS 1)
+  int8_t          txQos_ = -1;      // -1 = tx_ holds nothing reusable
+  bool            txRetain_ = false;
+  MqttBrokerStats stats_ = {};
+};
+
+#endif // MQTT_BROKER_H
@@ -0,0 +1,85 @@
+#ifndef NUM_FORMAT_H
+#define NUM_FORMAT_H
+
+// Integer and fixed-point to ASCII, for JSON payloads.
+//
+// Sensor values are carried as scaled integers (e.g. 2345 = 23.45 with two
+// decimals), so formatting them never needs the float printf path. Digits
+// are produced two at a time from a 200-byte pair table, writing backwards
+// from the end of the number.
+//
+// Each function writes at `p` without a terminating NUL and returns the
+// position after the last character; the caller makes sure there is room
+// for NUM_FORMAT_MAX characters. Plain C/C++ only (shared with tools/fleet).
+
+#include <stdint.h>
+#include <string.h>
+
+#define NUM_FORMAT_MAX 21   // "-9223372036854775808", or a fixed-point int32 with decimals
+
+static const char NUM_DIGIT_PAIRS[201] =
+  "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+  "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+inline uint8_t fmtDigits(uint32_t v) {
+  uint8_t n = 1;
+  while (v >= 100) { v /= 100; n += 2; }
+  return n + (v >= 10);
+}
+
+// Writes exactly `n` digits of `v` ending at p + n (leading zeros if short)
+inline void fmtDigitsAt(char* p, uint32_t v, uint8_t n) {
+  char* q = p + n;
+  while (n >= 2) {
+    const char* d = NUM_DIGIT_PAIRS + (v % 100) * 2;
+    v /= 100;
+    *--q = d[1];
+    *--q = d[0];
+    n -= 2;
+  }
+  if (n) *--q = '0' + v % 10;
+}
+
+inline char* fmtUint(char* p, uint32_t v) {
+  uint8_t n = fmtDigits(v);
+  fmtDigitsAt(p, v, n);
+  return p + n;
+}
+
+inline char* fmtInt(char* p, int32_t v) {
+  if (v < 0) { *p++ = '-'; return fmtUint(p, 0u - (uint32_t)v); }
+  return fmtUint(p, (uint32_t)v);
+}
+
+inline char* fmtUint64(char* p, uint64_t v) {
+  if (v <= UINT32_MAX) return fmtUint(p, (uint32_t)v);
+  // 32-bit targets divide 64-bit values in software: peel off 8 digits at a
+  // time so the pair loop runs on 32-bit words
+  uint32_t low = (uint32_t)(v % 100000000u);
+  p = fmtUint64(p, v / 100000000u);
+  fmtDigitsAt(p, low, 8);
+  return p + 8;
+}
+
+inline char* fmtInt64(char* p, int64_t v) {
+  if (v < 0) { *p++ = '-'; return fmtUint64(p, 0ull - (uint64_t)v); }
+  return fmtUint64(p, (uint64_t)v);
+}
+
+// `v` scaled by 10^decimals, e.g. fmtFixed(p, -205, 2) writes "-2.05".
+// decimals 0..9.
+inline char* fmtFixed(char* p, int32_t v, uint8_t decimals) {
+  static const uint32_t POW10[10] = { 1, 10, 100, 1000, 10000, 100000, 1000000,
+                                      10000000, 100000000, 1000000000 };
+  uint32_t u = (uint32_t)v;
+  if (v < 0) { *p++ = '-'; u = 0u - u; }
+  if (decimals == 0) return fmtUint(p, u);
+  uint32_t scale = POW10[decimals];
+  p = fmtUint(p, u / scale);
+  *p++ = '.';
+  fmtDigitsAt(p, u % scale, decimals);
+  return p + decimals;
+}
+
+#endif // NUM_FORMAT_H
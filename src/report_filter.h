@@ -0,0 +1,117 @@
+#ifndef REPORT_FILTER_H
+#define REPORT_FILTER_H
+
+// Report-by-exception for the upstream sensor samples, shared by the
+// firmware and the host simulator (tools/fleet/rbe_sim). Plain C/C++ only:
+// no Arduino headers.
+//
+// A sample is reported when any channel has left its deadband around the
+// value last *reported* for it, so a slow drift goes out once it adds up
+// instead of being swallowed step by step. Reports are at least
+// minIntervalMs apart: a change inside that window is held back and goes
+// out with the first sample after it, if it is still outside the deadband.
+// When nothing changes, a heartbeat sample goes out every maxIntervalMs so
+// consumers can tell "steady" from "gone". The first sample is always
+// reported.
+//
+// A channel's deadband is exceeded when the value moved by at least `abs`
+// (in the channel's unit) and by at least `pct` tenths of a percent of the
+// last reported value; a zero threshold is off, and with both off any change
+// counts. Used together, `pct` scales with the signal and `abs` is the floor
+// that keeps readings near zero from reporting every count of noise.
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define REPORT_CHANNELS 3   // temperature, light, humidity (telemetry order)
+
+struct ReportDeadband {
+  int32_t  abs;   // hundredths for temperature/humidity, raw counts for light
+  uint16_t pct;   // 0.1 % of the last reported value
+};
+
+struct ReportConfig {
+  bool           enabled;          // false: every sample is reported
+  ReportDeadband deadband[REPORT_CHANNELS];
+  uint32_t       minIntervalMs;
+  uint32_t       maxIntervalMs;    // heartbeat; 0 = none
+};
+
+enum ReportReason : uint8_t {
+  REPORT_SUPPRESSED,
+  REPORT_FIRST,
+  REPORT_CHANGE,
+  REPORT_HEARTBEAT,
+};
+
+struct ReportStats {
+  uint32_t sent;         // all reported samples, heartbeats included
+  uint32_t suppressed;
+  uint32_t heartbeats;
+  uint32_t held;         // changes suppressed only by minIntervalMs
+};
+
+// Plain value type: copy it to try a publish and assign it back once the
+// publish went through, so a failed one leaves the state untouched.
+class ReportFilter {
+ public:
+  explicit ReportFilter(const ReportConfig& cfg) : cfg_(&cfg) {}
+
+  // Decides for one sample taken at `ms` (any wrapping millisecond clock)
+  // and, if it is reported, makes it the new reference.
+  ReportReason check(const int32_t v[REPORT_CHANNELS], uint32_t ms) {
+    ReportReason r = decide(v, ms);
+    if (r == REPORT_SUPPRESSED) {
+      stats_.suppressed++;
+      return r;
+    }
+    for (int i = 0; i < REPORT_CHANNELS; ++i) last_[i] = v[i];
+    lastMs_ = ms;
+    primed_ = true;
+    stats_.sent++;
+    if (r == REPORT_HEARTBEAT) stats_.heartbeats++;
+    return r;
+  }
+  ReportReason check(int32_t tempCenti, int32_t light, int32_t humidityCenti, uint32_t ms) {
+    const int32_t v[REPORT_CHANNELS] = { tempCenti, light, humidityCenti };
+    return check(v, ms);
+  }
+
+  // Forgets the reference, so the next sample is reported (e.g. after a
+  // reconnect, when consumers may have missed the last one)
+  void rearm() { primed_ = false; }
+
+  const ReportStats& stats() const { return stats_; }
+  void resetStats() { stats_ = ReportStats(); }
+
+ private:
+  bool exceeds(int i, int32_t v) const {
+    int64_t d = llabs((int64_t)v - last_[i]);
+    if (d == 0) return false;
+    const ReportDeadband& db = cfg_->deadband[i];
+    if (db.abs && d < db.abs) return false;
+    return !db.pct || d * 1000 >= (int64_t)db.pct * llabs((int64_t)last_[i]);
+  }
+
+  ReportReason decide(const int32_t v[REPORT_CHANNELS], uint32_t ms) {
+    if (!cfg_->enabled) return REPORT_CHANGE;
+    if (!primed_) return REPORT_FIRST;
+    uint32_t since = ms - lastMs_;
+    bool changed = false;
+    for (int i = 0; i < REPORT_CHANNELS && !changed; ++i) changed = exceeds(i, v[i]);
+    if (changed) {
+      if (since >= cfg_->minIntervalMs) return REPORT_CHANGE;
+      stats_.held++;
+    }
+    if (cfg_->maxIntervalMs && since >= cfg_->maxIntervalMs) return REPORT_HEARTBEAT;
+    return REPORT_SUPPRESSED;
+  }
+
+  const ReportConfig* cfg_;
+  bool                primed_ = false;
+  uint32_t            lastMs_ = 0;
+  int32_t             last_[REPORT_CHANNELS] = {};
+  ReportStats         stats_ = {};
+};
+
+#endif // REPORT_FILTER_H
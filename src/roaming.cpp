@@ -0,0 +1,105 @@
+#include "roaming.h"
+#include <WiFi.h>
+#include "sta_link.h"
+#include "log.h"
+#include "wifi_state.h"
+
+static RoamStats stats = {};
+static bool      scanning = false;
+static uint32_t  scanStartMs = 0;
+static uint32_t  lastScanMs = 0;
+static uint32_t  lastMoveMs = 0;
+static bool      moved = false;
+
+// Picks a target from the finished scan and asks sta_link to move there.
+static void evaluate(int16_t found) {
+  int current = staLinkCurrent();
+  if (current < 0) return;
+  const StaNetwork* cur = staLinkNetworkAt(current);
+  int32_t curRssi = WiFi.RSSI();
+  const uint8_t* curBssid = WiFi.BSSID();
+
+  int     bestNet = -1;
+  int16_t bestIdx = -1;
+  int32_t bestRssi = -128;
+  for (int16_t i = 0; i < found; i++) {
+    int32_t rssi = WiFi.RSSI(i);
+    String ssid = WiFi.SSID(i);
+    for (size_t n = 0; n < staLinkNetworkCount(); n++) {
+      const StaNetwork* net = staLinkNetworkAt(n);
+      if (strcmp(net->ssid, ssid.c_str()) != 0) continue;
+      bool better;
+      if (net->priority > cur->priority) {
+        better = rssi >= ROAM_SWITCH_MIN_RSSI;
+      } else if (n == (size_t)current) {
+        better = curRssi < ROAM_GOOD_RSSI && rssi >= curRssi + ROAM_HYSTERESIS_DB &&
+                 memcmp(WiFi.BSSID(i), curBssid, 6) != 0;
+      } else {
+        better = false;   // equal/lower priority networks are only fallbacks
+      }
+      if (!better) break;
+      // Prefer the higher-priority network, then the stronger BSSID
+      const StaNetwork* best = bestNet >= 0 ? staLinkNetworkAt(bestNet) : nullptr;
+      if (!best || net->priority > best->priority ||
+          (net->priority == best->priority && rssi > bestRssi)) {
+        bestNet = (int)n;
+        bestIdx = i;
+        bestRssi = rssi;
+      }
+      break;
+    }
+  }
+  if (bestNet < 0) return;
+
+  uint8_t bssid[6];
+  memcpy(bssid, WiFi.BSSID(bestIdx), sizeof(bssid));
+  uint8_t channel = WiFi.channel(bestIdx);
+  LOGI("ROAM", "%s %d dBm -> %s %d dBm", cur->ssid, (int)curRssi,
+       staLinkNetworkAt(bestNet)->ssid, (int)bestRssi);
+  bool sw = bestNet != current;
+  if (staLinkRoam(bestNet, bssid, channel)) {
+    if (sw) stats.switches++;
+    else    stats.decisions++;
+    stats.lastFromRssi = (int8_t)curRssi;
+    stats.lastToRssi   = (int8_t)bestRssi;
+    lastMoveMs = millis();
+    moved = true;
+  }
+}
+
+void roamLoop(bool scanAllowed) {
+  uint32_t now = millis();
+
+  if (scanning) {
+    int16_t n = WiFi.scanComplete();
+    if (n == WIFI_SCAN_RUNNING && now - scanStartMs < ROAM_SCAN_TIMEOUT_MS) return;
+    scanning = false;
+    stats.lastScanMs = now - scanStartMs;
+    if (n < 0) stats.scanFailures++;
+    else if (staLinkUp()) evaluate(n);
+    WiFi.scanDelete();
+    return;
+  }
+
+  int current = staLinkCurrent();
+  if (!scanAllowed || current < 0) return;
+  if (moved && now - lastMoveMs < ROAM_HOLDOFF_MS) return;
+  uint32_t interval = wifiRssi() < ROAM_TRIGGER_RSSI ? ROAM_SCAN_WEAK_MS : ROAM_SCAN_INTERVAL_MS;
+  if (now - lastScanMs < interval) return;
+  lastScanMs = now;
+
+  // Directed scan unless a higher-priority network could be in range
+  const StaNetwork* cur = staLinkNetworkAt(current);
+  const char* ssid = staLinkNetworkAt(0)->priority <= cur->priority ? cur->ssid : nullptr;
+  stats.scans++;
+  if (WiFi.scanNetworks(/*async=*/true, /*show_hidden=*/false, /*passive=*/false,
+                        /*max_ms_per_chan=*/120, /*channel=*/0, ssid) != WIFI_SCAN_RUNNING) {
+    stats.scanFailures++;
+    return;
+  }
+  scanning = true;
+  scanStartMs = now;
+}
+
+bool roamScanning() { return scanning; }
+const RoamStats& roamStats() { return stats; }
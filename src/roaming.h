@@ -0,0 +1,42 @@
+#ifndef ROAMING_H
+#define ROAMING_H
+
+#include <Arduino.h>
+
+// Background roaming manager.
+//
+// While the STA link is up, runs an async scan every ROAM_SCAN_INTERVAL_MS
+// (every ROAM_SCAN_WEAK_MS once the link is below ROAM_TRIGGER_RSSI) and
+// moves the link when it finds:
+//  - a saved network of higher priority at or above ROAM_SWITCH_MIN_RSSI, or
+//  - a BSSID of the current network at least ROAM_HYSTERESIS_DB stronger
+//    than the current one, provided the current one is below ROAM_GOOD_RSSI.
+// The hysteresis and ROAM_HOLDOFF_MS keep it from flapping between two APs
+// of similar strength. Scans are directed at the current SSID unless a
+// higher-priority network is saved. Nothing here blocks the loop.
+
+#define ROAM_SCAN_INTERVAL_MS 60000
+#define ROAM_SCAN_WEAK_MS     15000
+#define ROAM_SCAN_TIMEOUT_MS  10000
+#define ROAM_HOLDOFF_MS       30000
+#define ROAM_TRIGGER_RSSI     -70
+#define ROAM_GOOD_RSSI        -60
+#define ROAM_SWITCH_MIN_RSSI  -72
+#define ROAM_HYSTERESIS_DB    8
+
+struct RoamStats {
+  uint32_t scans;
+  uint32_t scanFailures;    // failed to start, timed out or returned an error
+  uint32_t lastScanMs;      // duration of the last scan
+  uint32_t decisions;       // roams started (same network)
+  uint32_t switches;        // moves to a higher-priority network
+  int8_t   lastFromRssi;    // RSSI before the last roam/switch
+  int8_t   lastToRssi;      // RSSI the target was seen at
+};
+
+// `scanAllowed` is false while someone else owns the radio's scan (the UI).
+void             roamLoop(bool scanAllowed);
+bool             roamScanning();
+const RoamStats& roamStats();
+
+#endif // ROAMING_H
@@ -0,0 +1,37 @@
+#include "samples.h"
+
+static SensorSample ring[SAMPLE_HISTORY];
+static uint32_t     count = 0;     // samples taken; the latest has seq == count
+static uint32_t     bootId = 0;
+
+void samplesBegin() {
+  bootId = esp_random();
+}
+
+const SensorSample& samplesRecord(int32_t tempCenti, int32_t light, int32_t humidityCenti,
+                                  uint64_t tsMs) {
+  SensorSample& s = ring[count % SAMPLE_HISTORY];
+  s.seq           = ++count;
+  s.ms            = millis();
+  s.tsMs          = tsMs;
+  s.tempCenti     = tempCenti;
+  s.light         = light;
+  s.humidityCenti = humidityCenti;
+  return s;
+}
+
+const SensorSample* samplesLatest() {
+  return count ? &ring[(count - 1) % SAMPLE_HISTORY] : nullptr;
+}
+
+uint32_t samplesSeq() { return count; }
+
+uint32_t samplesBootId() { return bootId; }
+
+size_t samplesSince(uint32_t since, SensorSample* out, size_t max) {
+  size_t n = 0;
+  uint32_t first = count > SAMPLE_HISTORY ? count - SAMPLE_HISTORY : 0;
+  if (since > first) first = since;
+  for (uint32_t i = first; i < count && n < max; ++i) out[n++] = ring[i % SAMPLE_HISTORY];
+  return n;
+}
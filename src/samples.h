@@ -0,0 +1,42 @@
+#ifndef SAMPLES_H
+#define SAMPLES_H
+
+#include <Arduino.h>
+
+// Recent sensor samples.
+//
+// Every sample gets a sequence number (1, 2, ... per boot) and is kept in a
+// ring of SAMPLE_HISTORY entries, so a client that remembers the last seq it
+// saw can ask for only what is newer (/api/sensors?since=<seq>). `bootId` is
+// random per boot and goes into ETags, so a cached seq from before a reboot
+// never matches a new sample with the same number.
+//
+// Values are fixed-point integers: temperature (degC) and humidity (%RH) in
+// hundredths, light in raw counts.
+//
+// Written and read from the loop task only.
+
+#define SAMPLE_HISTORY 16
+
+struct SensorSample {
+  uint32_t seq;
+  uint32_t ms;         // millis() when taken
+  uint64_t tsMs;       // Unix epoch ms when taken, 0 before the first time sync
+  int32_t  tempCenti;
+  int32_t  light;
+  int32_t  humidityCenti;
+};
+
+void samplesBegin();
+const SensorSample& samplesRecord(int32_t tempCenti, int32_t light, int32_t humidityCenti, uint64_t tsMs);
+
+// Latest sample, nullptr before the first one
+const SensorSample* samplesLatest();
+uint32_t            samplesSeq();        // seq of the latest sample, 0 if none
+uint32_t            samplesBootId();
+
+// Copies up to `max` samples with seq > `since` (oldest first) and returns
+// how many were copied.
+size_t samplesSince(uint32_t since, SensorSample* out, size_t max);
+
+#endif // SAMPLES_H
@@ -0,0 +1,76 @@
+#include "scan_cache.h"
+
+void ScanCache::update(int16_t found) {
+  count_ = 0;
+  rawCount_ = found > 0 ? found : 0;
+
+  for (int16_t i = 0; i < found; ++i) {
+    ScanEntry e;
+    String ssid = WiFi.SSID(i);
+    strncpy(e.ssid, ssid.c_str(), sizeof(e.ssid) - 1);
+    e.ssid[sizeof(e.ssid) - 1] = '\0';
+    memcpy(e.bssid, WiFi.BSSID(i), sizeof(e.bssid));
+    e.rssi    = (int8_t)constrain(WiFi.RSSI(i), -127, 0);
+    e.channel = WiFi.channel(i);
+    e.auth    = WiFi.encryptionType(i);
+    e.apCount = 1;
+    insert(e);
+  }
+
+  // Insertion sort by RSSI (n <= 64, mostly sorted already by the driver)
+  for (size_t i = 1; i < count_; ++i) {
+    ScanEntry tmp = entries_[i];
+    size_t j = i;
+    while (j > 0 && entries_[j - 1].rssi < tmp.rssi) {
+      entries_[j] = entries_[j - 1];
+      --j;
+    }
+    entries_[j] = tmp;
+  }
+
+  updatedMs_ = millis();
+  valid_ = true;
+}
+
+void ScanCache::insert(const ScanEntry& e) {
+  if (e.ssid[0] != '\0') {
+    for (size_t i = 0; i < count_; ++i) {
+      ScanEntry& cur = entries_[i];
+      if (strcmp(cur.ssid, e.ssid) != 0) continue;
+      uint8_t aps = cur.apCount < UINT8_MAX ? cur.apCount + 1 : cur.apCount;
+      if (e.rssi > cur.rssi) cur = e;
+      cur.apCount = aps;
+      return;
+    }
+  }
+
+  if (count_ < SCAN_MAX_ENTRIES) {
+    entries_[count_++] = e;
+    return;
+  }
+  // Full: replace the weakest entry if this one is stronger
+  size_t weakest = 0;
+  for (size_t i = 1; i < count_; ++i) {
+    if (entries_[i].rssi < entries_[weakest].rssi) weakest = i;
+  }
+  if (e.rssi > entries_[weakest].rssi) entries_[weakest] = e;
+}
+
+#ifdef JSON_STREAM_BENCH
+void ScanCache::synthesize(size_t n) {
+  count_ = 0;
+  rawCount_ = n;
+  for (size_t i = 0; i < n && i < SCAN_MAX_ENTRIES; ++i) {
+    ScanEntry& e = entries_[count_++];
+    snprintf(e.ssid, sizeof(e.ssid), "Greenhouse-Bench-Network-%02u", (unsigned)i);
+    uint8_t bssid[6] = {0x24, 0x0a, 0xc4, 0x00, (uint8_t)(i >> 8), (uint8_t)i};
+    memcpy(e.bssid, bssid, sizeof(e.bssid));
+    e.rssi    = (int8_t)(-30 - (int)(i * 60 / (n ? n : 1)));
+    e.channel = 1 + i % 13;
+    e.auth    = i % 5 ? WIFI_AUTH_WPA2_PSK : WIFI_AUTH_OPEN;
+    e.apCount = 1 + i % 3;
+  }
+  updatedMs_ = millis();
+  valid_ = true;
+}
+#endif
@@ -0,0 +1,65 @@
+#ifndef SCAN_CACHE_H
+#define SCAN_CACHE_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+// Compact store for WiFi scan results.
+//
+// Networks are deduplicated by SSID (the strongest BSSID is kept and the
+// number of APs seen for that SSID is counted), hidden networks are kept
+// per BSSID, and the list is sorted by RSSI, strongest first. Storage is a
+// fixed array, so dense environments never trigger a large allocation; if
+// more than SCAN_MAX_ENTRIES distinct networks are seen the weakest drop out.
+
+#define SCAN_MAX_ENTRIES 64
+#define SCAN_TTL_MS      60000
+
+struct ScanEntry {
+  char    ssid[33];
+  uint8_t bssid[6];
+  int8_t  rssi;
+  uint8_t channel;
+  uint8_t auth;       // wifi_auth_mode_t
+  uint8_t apCount;    // BSSIDs seen broadcasting this SSID
+};
+
+class ScanCache {
+ public:
+  // Ingests the driver's current scan results (call before WiFi.scanDelete())
+  void update(int16_t found);
+  void clear() { count_ = 0; valid_ = false; }
+#ifdef JSON_STREAM_BENCH
+  // Fills the cache with `n` fake networks (bench builds only)
+  void synthesize(size_t n);
+#endif
+
+  bool     valid() const { return valid_; }
+  bool     expired() const { return !valid_ || millis() - updatedMs_ > SCAN_TTL_MS; }
+  uint32_t ageMs() const { return millis() - updatedMs_; }
+  uint16_t rawCount() const { return rawCount_; }   // BSSIDs before dedup
+  size_t   size() const { return count_; }
+  const ScanEntry& at(size_t i) const { return entries_[i]; }
+
+ private:
+  void insert(const ScanEntry& e);
+
+  ScanEntry entries_[SCAN_MAX_ENTRIES];
+  size_t    count_ = 0;
+  uint16_t  rawCount_ = 0;
+  uint32_t  updatedMs_ = 0;
+  bool      valid_ = false;
+};
+
+// Query filters for /api/wifi/scan and /api/wifi/scan/results
+struct ScanFilter {
+  int      minRssi = -127;
+  size_t   limit = SCAN_MAX_ENTRIES;
+  bool     openOnly = false;
+
+  bool matches(const ScanEntry& e) const {
+    return e.rssi >= minRssi && (!openOnly || e.auth == WIFI_AUTH_OPEN);
+  }
+};
+
+#endif // SCAN_CACHE_H
@@ -0,0 +1,355 @@
+#include "sta_link.h"
+#include <Preferences.h>
+#include "log.h"
+#include "boot_profile.h"
+#include "wifi_state.h"
+
+enum StaState : uint8_t { STA_IDLE, STA_CONNECTING, STA_UP };
+
+// Everything persisted, kept as one NVS blob
+#define STA_STORE_VERSION 2
+struct StaStore {
+  uint8_t    version;
+  uint8_t    count;
+  char       last[33];             // SSID of the last network that came up
+  StaNetwork nets[STA_MAX_NETWORKS];   // sorted by priority, newest first among equals
+};
+
+static StaStore       store = {};
+static StaNetwork     attempt = {};   // network being connected / connected
+static StaState       state = STA_IDLE;
+static StaConnectPath attemptPath = STA_PATH_NONE;
+static uint32_t       attemptStartMs = 0;
+static uint8_t        attemptBssid[6] = {};   // BSSID the attempt targets...
+static bool           attemptTargeted = false; // ...if it targets one
+static uint32_t       outageStartMs = 0;   // 0 = link not known to be down
+static StaLinkTiming  timing = {};
+static StaLinkStats   stats = {};
+
+static const char* NVS_NAMESPACE = "sta";
+
+// ===================== Saved networks =====================
+static int findNetwork(const char* ssid) {
+  for (size_t i = 0; i < store.count; i++) {
+    if (strcmp(store.nets[i].ssid, ssid) == 0) return (int)i;
+  }
+  return -1;
+}
+
+static void removeAt(size_t i) {
+  memmove(&store.nets[i], &store.nets[i + 1], (store.count - i - 1) * sizeof(StaNetwork));
+  store.count--;
+  memset(&store.nets[store.count], 0, sizeof(StaNetwork));
+}
+
+static bool sameNetwork(const StaNetwork& a, const StaNetwork& b) {
+  return strcmp(a.ssid, b.ssid) == 0 && strcmp(a.pass, b.pass) == 0 &&
+         a.priority == b.priority && memcmp(a.bssid, b.bssid, sizeof(a.bssid)) == 0 &&
+         a.channel == b.channel && a.ip == b.ip && a.gateway == b.gateway &&
+         a.mask == b.mask && a.dns == b.dns;
+}
+
+// Inserts or replaces `n`; returns false if it was already stored as-is.
+// When full, the lowest-priority (then oldest) network is dropped.
+static bool storeNetwork(const StaNetwork& n) {
+  int i = findNetwork(n.ssid);
+  if (i >= 0) {
+    if (sameNetwork(store.nets[i], n)) return false;
+    removeAt(i);
+  } else if (store.count == STA_MAX_NETWORKS) {
+    LOGW("STA", "saved list full, dropping %s", store.nets[store.count - 1].ssid);
+    removeAt(store.count - 1);
+  }
+  size_t pos = 0;
+  while (pos < store.count && store.nets[pos].priority > n.priority) pos++;
+  memmove(&store.nets[pos + 1], &store.nets[pos], (store.count - pos) * sizeof(StaNetwork));
+  memcpy(&store.nets[pos], &n, sizeof(StaNetwork));
+  store.count++;
+  return true;
+}
+
+// ===================== NVS ================================
+// Single-network layout written before the saved list existed
+struct StaLegacyCredentials {
+  char     ssid[33];
+  char     pass[65];
+  uint8_t  bssid[6];
+  uint8_t  channel;
+  uint32_t ip, gateway, mask, dns;
+};
+
+static void saveNetworks() {
+  Preferences prefs;
+  if (!prefs.begin(NVS_NAMESPACE, false)) {
+    LOGE("STA", "NVS open failed, networks not saved");
+    return;
+  }
+  store.version = STA_STORE_VERSION;
+  prefs.putBytes("nets", &store, sizeof(store));
+  prefs.remove("creds");
+  prefs.end();
+}
+
+static void loadNetworks() {
+  memset(&store, 0, sizeof(store));
+  Preferences prefs;
+  if (!prefs.begin(NVS_NAMESPACE, true)) return;
+  if (prefs.getBytesLength("nets") == sizeof(store)) {
+    prefs.getBytes("nets", &store, sizeof(store));
+  }
+  StaLegacyCredentials legacy;
+  bool haveLegacy = prefs.getBytesLength("creds") == sizeof(legacy) &&
+                    prefs.getBytes("creds", &legacy, sizeof(legacy)) == sizeof(legacy);
+  prefs.end();
+
+  if (store.version != STA_STORE_VERSION || store.count > STA_MAX_NETWORKS) {
+    memset(&store, 0, sizeof(store));
+  }
+  if (haveLegacy && store.count == 0 && legacy.ssid[0] != '\0') {
+    StaNetwork n = {};
+    memcpy(n.ssid, legacy.ssid, sizeof(n.ssid));
+    memcpy(n.pass, legacy.pass, sizeof(n.pass));
+    memcpy(n.bssid, legacy.bssid, sizeof(n.bssid));
+    n.channel = legacy.channel;
+    n.ip = legacy.ip;  n.gateway = legacy.gateway;
+    n.mask = legacy.mask;  n.dns = legacy.dns;
+    storeNetwork(n);
+    strcpy(store.last, n.ssid);
+    saveNetworks();
+    LOGI("STA", "migrated stored credentials for %s", n.ssid);
+  }
+}
+
+// ===================== Connect paths ======================
+static void beginAttempt(StaConnectPath path, const uint8_t* bssid = nullptr, uint8_t channel = 0) {
+  attemptPath = path;
+  attemptStartMs = millis();
+  state = STA_CONNECTING;
+  attemptTargeted = bssid != nullptr;
+  if (bssid) memcpy(attemptBssid, bssid, sizeof(attemptBssid));
+
+  if (path == STA_PATH_FAST_STATIC) {
+    WiFi.config(IPAddress(attempt.ip), IPAddress(attempt.gateway), IPAddress(attempt.mask), IPAddress(attempt.dns));
+  } else {
+    WiFi.config(IPAddress(), IPAddress(), IPAddress());   // back to DHCP
+  }
+
+  // Drop a current link first so the attempt always ends in a fresh
+  // connect event (the driver ignores begin() for the config it is on)
+  if (wifiStaConnected()) WiFi.disconnect();
+  const char* pass = attempt.pass[0] ? attempt.pass : nullptr;
+  if (bssid) {
+    WiFi.begin(attempt.ssid, pass, channel, bssid);
+  } else {
+    WiFi.begin(attempt.ssid, pass);
+  }
+  LOGI("STA", "connecting to %s (%s path)", attempt.ssid, staLinkPathName(path));
+}
+
+static StaConnectPath fastestPath() {
+  if (attempt.channel == 0) return STA_PATH_COLD;
+#ifdef WIFI_FAST_STATIC_IP
+  if (attempt.ip != 0) return STA_PATH_FAST_STATIC;
+#endif
+  return STA_PATH_FAST;
+}
+
+static void tryNetwork(size_t i) {
+  memcpy(&attempt, &store.nets[i], sizeof(attempt));
+  StaConnectPath path = fastestPath();
+  if (path == STA_PATH_COLD) beginAttempt(path);
+  else                       beginAttempt(path, attempt.bssid, attempt.channel);
+}
+
+// Network to try after `attempt` failed a full connect: the next one in
+// priority order, wrapping around.
+static size_t nextNetwork() {
+  int i = findNetwork(attempt.ssid);
+  return i < 0 ? 0 : (size_t)(i + 1) % store.count;
+}
+
+// Whether the link the attempt asked for is up. WiFi.begin() while still
+// associated (a roam, or a new network posted over a working one) leaves
+// the old link's connected flag set until its disconnect event lands, so
+// only a GOT_IP stamped after the attempt started counts, and only on the
+// requested SSID (and BSSID, if the attempt targets one).
+static bool attemptUp() {
+  WifiState ws = wifiState();
+  if (!ws.staConnected || (int32_t)(ws.connectedMs - attemptStartMs) <= 0) return false;
+  if (strcmp(WiFi.SSID().c_str(), attempt.ssid) != 0) return false;
+  const uint8_t* bssid = WiFi.BSSID();
+  return !attemptTargeted || (bssid && memcmp(bssid, attemptBssid, sizeof(attemptBssid)) == 0);
+}
+
+// ===================== Public API =========================
+void staLinkBegin() {
+  loadNetworks();
+  if (store.count == 0) {
+    LOGI("STA", "no stored networks");
+    return;
+  }
+  int last = findNetwork(store.last);
+  tryNetwork(last >= 0 ? (size_t)last : 0);
+}
+
+void staLinkLoop() {
+  bool connected = wifiStaConnected();
+
+  if (state == STA_CONNECTING) {
+    if (attemptUp()) {
+      staLinkLinkUp();
+      return;
+    }
+    uint32_t elapsed = millis() - attemptStartMs;
+    if (attemptPath != STA_PATH_COLD && elapsed > STA_FAST_TIMEOUT_MS) {
+      // Cached/chosen AP moved channel, went away, or the lease is stale
+      LOGW("STA", "%s path timed out after %lu ms, falling back to full scan",
+           staLinkPathName(attemptPath), (unsigned long)elapsed);
+      if (attemptPath == STA_PATH_ROAM) stats.roamFailures++;
+      else                              timing.fallbacks++;
+      WiFi.disconnect();
+      beginAttempt(STA_PATH_COLD);
+    } else if (attemptPath == STA_PATH_COLD && elapsed > STA_FULL_TIMEOUT_MS) {
+      LOGW("STA", "connect to %s timed out", attempt.ssid);
+      if (store.count > 0) tryNetwork(nextNetwork());
+      else                 beginAttempt(STA_PATH_COLD);
+    }
+  } else if (state == STA_UP && !connected) {
+    LOGW("STA", "link to %s lost", attempt.ssid);
+    outageStartMs = millis();
+    state = STA_IDLE;
+  } else if (state == STA_IDLE && connected) {
+    staLinkLinkUp();   // e.g. driver auto-reconnected on its own
+  } else if (state == STA_IDLE && store.count > 0) {
+    int i = findNetwork(attempt.ssid);
+    if (i < 0) i = findNetwork(store.last);
+    tryNetwork(i >= 0 ? (size_t)i : 0);
+  }
+}
+
+bool staLinkConnect(const char* ssid, const char* pass, int8_t priority) {
+  if (strlen(ssid) >= sizeof(attempt.ssid) || strlen(pass) >= sizeof(attempt.pass)) return false;
+  int i = findNetwork(ssid);
+  if (i >= 0 && strcmp(store.nets[i].pass, pass) == 0) {
+    memcpy(&attempt, &store.nets[i], sizeof(attempt));   // keep cached BSSID/lease
+  } else {
+    memset(&attempt, 0, sizeof(attempt));
+    strcpy(attempt.ssid, ssid);
+    strcpy(attempt.pass, pass);
+  }
+  if (priority == STA_PRIORITY_KEEP) priority = i >= 0 ? store.nets[i].priority : 0;
+  attempt.priority = priority;
+  // Stored once the link is up, so a mistyped password is not persisted
+  beginAttempt(STA_PATH_COLD);
+  return true;
+}
+
+void staLinkCancel() {
+  WiFi.disconnect();
+  state = STA_IDLE;
+  attemptPath = STA_PATH_NONE;
+  memset(&attempt, 0, sizeof(attempt));   // staLinkLoop() goes back to the saved list
+}
+
+void staLinkForget() {
+  WiFi.disconnect(true, true);
+  state = STA_IDLE;
+  memset(&attempt, 0, sizeof(attempt));
+  memset(&store, 0, sizeof(store));
+  Preferences prefs;
+  if (prefs.begin(NVS_NAMESPACE, false)) {
+    prefs.clear();
+    prefs.end();
+  }
+  LOGI("STA", "saved networks forgotten");
+}
+
+bool staLinkForgetNetwork(const char* ssid) {
+  int i = findNetwork(ssid);
+  if (i < 0) return false;
+  removeAt(i);
+  if (strcmp(store.last, ssid) == 0) store.last[0] = '\0';
+  saveNetworks();
+  if (strcmp(attempt.ssid, ssid) == 0) {
+    WiFi.disconnect();
+    state = STA_IDLE;
+    memset(&attempt, 0, sizeof(attempt));
+  }
+  LOGI("STA", "forgot %s", ssid);
+  return true;
+}
+
+void staLinkLinkUp() {
+  if (state == STA_UP) return;
+  state = STA_UP;
+
+  uint32_t now = millis();
+  timing.path = attemptPath != STA_PATH_NONE ? attemptPath : STA_PATH_COLD;
+  timing.connectMs = now - attemptStartMs;
+  if (timing.bootToConnectMs == 0) {
+    timing.bootToConnectMs = now;
+    bootMark("sta_connected");
+  }
+  if (outageStartMs != 0) {
+    uint32_t down = now - outageStartMs;
+    stats.outages++;
+    stats.lastOutageMs = down;
+    stats.totalOutageMs += down;
+    if (down > stats.maxOutageMs) stats.maxOutageMs = down;
+    outageStartMs = 0;
+  }
+  if (attemptPath == STA_PATH_ROAM) {
+    stats.roams++;
+    stats.lastRoamMs = timing.connectMs;
+    stats.totalRoamMs += timing.connectMs;
+    if (timing.connectMs > stats.maxRoamMs) stats.maxRoamMs = timing.connectMs;
+  }
+  attemptPath = STA_PATH_NONE;
+  LOGI("STA", "up via %s path in %lu ms (boot +%lu ms)", staLinkPathName(timing.path),
+       (unsigned long)timing.connectMs, (unsigned long)now);
+
+  // Cache what the next boot needs to skip the scan; only write NVS when
+  // something actually changed to spare flash wear.
+  if (attempt.ssid[0] == '\0') return;
+  memcpy(attempt.bssid, WiFi.BSSID(), sizeof(attempt.bssid));
+  attempt.channel = WiFi.channel();
+  attempt.ip      = WiFi.localIP();
+  attempt.gateway = WiFi.gatewayIP();
+  attempt.mask    = WiFi.subnetMask();
+  attempt.dns     = WiFi.dnsIP();
+  bool changed = storeNetwork(attempt);
+  if (strcmp(store.last, attempt.ssid) != 0) {
+    strcpy(store.last, attempt.ssid);
+    changed = true;
+  }
+  if (changed) saveNetworks();
+}
+
+bool staLinkRoam(size_t index, const uint8_t* bssid, uint8_t channel) {
+  if (state != STA_UP || index >= store.count) return false;
+  memcpy(&attempt, &store.nets[index], sizeof(attempt));
+  LOGI("STA", "roaming to %s %02x:%02x:%02x:%02x:%02x:%02x ch %u", attempt.ssid,
+       bssid[0], bssid[1], bssid[2], bssid[3], bssid[4], bssid[5], channel);
+  outageStartMs = millis();
+  beginAttempt(STA_PATH_ROAM, bssid, channel);
+  return true;
+}
+
+bool staLinkHasCredentials() { return store.count > 0; }
+bool staLinkConnecting() { return state == STA_CONNECTING; }
+bool staLinkUp() { return state == STA_UP; }
+int  staLinkCurrent() { return state == STA_UP ? findNetwork(attempt.ssid) : -1; }
+size_t staLinkNetworkCount() { return store.count; }
+const StaNetwork* staLinkNetworkAt(size_t i) { return i < store.count ? &store.nets[i] : nullptr; }
+const StaLinkTiming& staLinkTiming() { return timing; }
+const StaLinkStats& staLinkStats() { return stats; }
+
+const char* staLinkPathName(StaConnectPath p) {
+  switch (p) {
+    case STA_PATH_COLD:        return "cold";
+    case STA_PATH_FAST:        return "fast";
+    case STA_PATH_FAST_STATIC: return "fast_static";
+    case STA_PATH_ROAM:        return "roam";
+    default:                   return "none";
+  }
+}
@@ -0,0 +1,90 @@
+#ifndef STA_LINK_H
+#define STA_LINK_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+// Station-side link management.
+//
+// Networks posted to /api/wifi/connect are kept in NVS as a priority-ordered
+// list (up to STA_MAX_NETWORKS), each with the BSSID, channel and IP lease of
+// its last successful association. At boot the fast path targets the last
+// good network's BSSID/channel directly (skipping the full channel scan)
+// and, when built with -DWIFI_FAST_STATIC_IP, reuses the lease instead of
+// waiting for DHCP. If the fast attempt has not associated within
+// STA_FAST_TIMEOUT_MS it falls back to a normal connect; normal connects
+// rotate through the saved networks, highest priority first.
+//
+// staLinkRoam() moves an established link to another BSSID (or a preferred
+// saved network); the roaming manager decides when (see roaming.h).
+//
+// All of this is non-blocking: staLinkLoop() advances the state machine.
+
+#define STA_MAX_NETWORKS    5
+#define STA_FAST_TIMEOUT_MS 4000
+#define STA_FULL_TIMEOUT_MS 15000
+#define STA_PRIORITY_KEEP   INT8_MIN   // staLinkConnect(): keep a saved network's priority
+
+enum StaConnectPath : uint8_t {
+  STA_PATH_NONE = 0,
+  STA_PATH_COLD,        // full scan + DHCP
+  STA_PATH_FAST,        // cached BSSID/channel + DHCP
+  STA_PATH_FAST_STATIC, // cached BSSID/channel + cached lease
+  STA_PATH_ROAM,        // chosen BSSID while the link was up
+};
+
+struct StaNetwork {
+  char     ssid[33];
+  char     pass[65];
+  int8_t   priority;       // higher is preferred
+  uint8_t  bssid[6];
+  uint8_t  channel;        // 0 = no cached BSSID/channel
+  uint32_t ip, gateway, mask, dns;   // 0 = no cached lease
+};
+
+struct StaLinkTiming {
+  StaConnectPath path;       // path that produced the current link
+  uint32_t connectMs;        // attempt start -> got IP
+  uint32_t bootToConnectMs;  // millis() when the link came up after boot
+  uint8_t  fallbacks;        // fast attempts that fell back to cold
+};
+
+// Roams and link outages (a roam is itself an outage: the STA has to
+// re-associate and usually re-run DHCP, and frames sent meanwhile are lost)
+struct StaLinkStats {
+  uint32_t roams;
+  uint32_t roamFailures;     // roam target did not associate in time
+  uint32_t lastRoamMs;
+  uint32_t maxRoamMs;
+  uint32_t totalRoamMs;
+  uint32_t outages;          // link-down windows, roams included
+  uint32_t lastOutageMs;
+  uint32_t maxOutageMs;
+  uint32_t totalOutageMs;
+};
+
+void staLinkBegin();                      // loads NVS, starts fast reconnect
+void staLinkLoop();
+// Adds/updates a network and connects to it (cold path). Stored once the
+// link is up, so a mistyped password is not persisted. With
+// STA_PRIORITY_KEEP a saved network keeps its priority (a new one gets 0).
+bool staLinkConnect(const char* ssid, const char* pass, int8_t priority = STA_PRIORITY_KEEP);
+void staLinkCancel();                     // abandon a failed staLinkConnect()
+void staLinkForget();                     // disconnect + erase all saved networks
+bool staLinkForgetNetwork(const char* ssid);
+void staLinkLinkUp();                     // link is up: caches BSSID/channel/lease (staLinkLoop() calls it)
+// Re-associates to `bssid` on `channel` of saved network `index`; only
+// while the link is up. Returns false if a connect is already in progress.
+bool staLinkRoam(size_t index, const uint8_t* bssid, uint8_t channel);
+
+bool                 staLinkHasCredentials();
+bool                 staLinkConnecting();
+bool                 staLinkUp();
+int                  staLinkCurrent();    // saved index of the active network, -1 if none
+size_t               staLinkNetworkCount();
+const StaNetwork*    staLinkNetworkAt(size_t i);   // priority order
+const StaLinkTiming& staLinkTiming();
+const StaLinkStats&  staLinkStats();
+const char*          staLinkPathName(StaConnectPath p);
+
+#endif // STA_LINK_H
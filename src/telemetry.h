@@ -0,0 +1,130 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+// Device identity, topic layout and payload formatting shared by the
+// firmware and the host-side tools (tools/fleet), so the swarm simulator
+// publishes exactly what a real device does. Plain C/C++ only: no Arduino
+// headers.
+//
+// Topics follow site/zone/device/channel, e.g.
+//   greenhouse/zone1/esp32-a1b2c3/sensors   sensor samples (JSON)
+//   greenhouse/zone1/esp32-a1b2c3/batch     several samples, base time + deltas
+//   greenhouse/zone1/esp32-a1b2c3/status    "online" / "offline" (retained, LWT)
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "num_format.h"
+
+#ifndef MQTT_SITE
+#define MQTT_SITE "greenhouse"
+#endif
+#ifndef MQTT_ZONE
+#define MQTT_ZONE "zone1"
+#endif
+
+#define TELEMETRY_CHANNEL_SENSORS "sensors"
+#define TELEMETRY_CHANNEL_STATUS  "status"
+#define TELEMETRY_CHANNEL_BATCH   "batch"
+#define TELEMETRY_ID_LEN          16   // "esp32-" + 6 hex + NUL, with slack
+#define TELEMETRY_TOPIC_LEN       96
+#define TELEMETRY_PAYLOAD_LEN     96   // longest sensor payload is 91 chars
+#define TELEMETRY_BATCH_MAX       16
+#define TELEMETRY_BATCH_LEN(n)    (72 + (n) * 50)   // worst case for n readings
+
+// "esp32-" followed by the last three MAC bytes; unique per board and
+// stable across reboots, so it doubles as the MQTT client id.
+inline void telemetryDeviceId(const uint8_t mac[6], char* out, size_t cap) {
+  snprintf(out, cap, "esp32-%02x%02x%02x", mac[3], mac[4], mac[5]);
+}
+
+inline int telemetryTopic(char* out, size_t cap, const char* site, const char* zone,
+                          const char* device, const char* channel) {
+  return snprintf(out, cap, "%s/%s/%s/%s", site, zone, device, channel);
+}
+
+// Sensor payload. Temperature and humidity are fixed-point hundredths
+// (2345 -> 23.45); `tsMs` is the acquisition time in ms since the Unix
+// epoch, 0 means the device has no wall clock yet and the field is omitted.
+// Returns the payload length like snprintf (truncated to fit `cap`).
+inline int telemetrySensorPayload(char* out, size_t cap, int32_t tempCenti, int32_t light,
+                                  int32_t humidityCenti, uint64_t tsMs) {
+  char buf[TELEMETRY_PAYLOAD_LEN];
+  char* p = buf;
+  memcpy(p, "{\"temp\":", 8);       p = fmtFixed(p + 8, tempCenti, 2);
+  memcpy(p, ",\"light\":", 9);      p = fmtInt(p + 9, light);
+  memcpy(p, ",\"humidity\":", 12);  p = fmtFixed(p + 12, humidityCenti, 2);
+  if (tsMs) {
+    memcpy(p, ",\"ts\":", 6);       p = fmtUint64(p + 6, tsMs);
+  }
+  *p++ = '}';
+  int len = (int)(p - buf);
+  if (cap) {
+    size_t n = (size_t)len < cap ? (size_t)len : cap - 1;
+    memcpy(out, buf, n);
+    out[n] = '\0';
+  }
+  return len;
+}
+
+struct TelemetryReading {
+  uint64_t tsMs;             // Unix epoch ms at acquisition
+  int32_t  tempCenti;
+  int32_t  light;
+  int32_t  humidityCenti;
+};
+
+// Batch payload: the first reading's time plus the delta of each reading to
+// the one before it, and one array per field, e.g.
+//   {"t0":1700000000000,"dt":[0,1000,1001],"temp":[23.45,23.46,23.46],
+//    "light":[512,510,511],"humidity":[61.50,61.52,61.49]}
+// Every reading needs a timestamp. Returns the length, or -1 if `cap` is
+// below TELEMETRY_BATCH_LEN(n).
+inline int telemetryBatchPayload(char* out, size_t cap, const TelemetryReading* r, size_t n) {
+  if (n == 0 || cap < (size_t)TELEMETRY_BATCH_LEN(n)) return -1;
+  char* p = out;
+  memcpy(p, "{\"t0\":", 6);  p = fmtUint64(p + 6, r[0].tsMs);
+  memcpy(p, ",\"dt\":[", 7);
+  p += 7;
+  for (size_t i = 0; i < n; ++i) {
+    if (i) *p++ = ',';
+    p = fmtInt(p, i ? (int32_t)(r[i].tsMs - r[i - 1].tsMs) : 0);
+  }
+  memcpy(p, "],\"temp\":[", 10);
+  p += 10;
+  for (size_t i = 0; i < n; ++i) {
+    if (i) *p++ = ',';
+    p = fmtFixed(p, r[i].tempCenti, 2);
+  }
+  memcpy(p, "],\"light\":[", 11);
+  p += 11;
+  for (size_t i = 0; i < n; ++i) {
+    if (i) *p++ = ',';
+    p = fmtInt(p, r[i].light);
+  }
+  memcpy(p, "],\"humidity\":[", 14);
+  p += 14;
+  for (size_t i = 0; i < n; ++i) {
+    if (i) *p++ = ',';
+    p = fmtFixed(p, r[i].humidityCenti, 2);
+  }
+  *p++ = ']';
+  *p++ = '}';
+  *p = '\0';
+  return (int)(p - out);
+}
+
+#ifdef FORMAT_BENCH
+// The previous snprintf-based encoder, kept as the benchmark baseline
+inline int telemetrySensorPayloadPrintf(char* out, size_t cap, int32_t tempCenti, int32_t light,
+                                        int32_t humidityCenti, uint64_t tsMs) {
+  if (tsMs) {
+    return snprintf(out, cap, "{\"temp\":%.2f,\"light\":%d,\"humidity\":%.2f,\"ts\":%llu}",
+                    tempCenti / 100.0, (int)light, humidityCenti / 100.0, (unsigned long long)tsMs);
+  }
+  return snprintf(out, cap, "{\"temp\":%.2f,\"light\":%d,\"humidity\":%.2f}",
+                  tempCenti / 100.0, (int)light, humidityCenti / 100.0);
+}
+#endif
+
+#endif // TELEMETRY_H
@@ -0,0 +1,176 @@
+#include "time_sync.h"
+#include "log.h"
+#include "loop_watchdog.h"
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include <esp_timer.h>
+#include <sys/time.h>
+
+#define NTP_PACKET_LEN   48
+#define NTP_PORT         123
+#define NTP_LOCAL_PORT   53123
+#define NTP_UNIX_OFFSET  2208988800ull   // 1900-01-01 -> 1970-01-01, seconds
+
+static WiFiUDP       udp;
+static const char*   server = nullptr;
+static IPAddress     serverIP;
+static bool          udpOpen = false;
+static bool          waiting = false;
+static uint64_t      sentUs = 0;         // monotonic µs, also our transmit timestamp
+static uint32_t      sentMs = 0;
+static uint32_t      nextAttemptMs = 0;
+static int64_t       epochOffsetUs = 0;  // Unix epoch µs - esp_timer µs
+static TimeSource    source = TIME_MONOTONIC;
+static TimeSyncStats stats = {};
+
+static uint64_t monoUs() { return (uint64_t)esp_timer_get_time(); }
+
+static uint64_t rd64(const uint8_t* p) {
+  uint64_t v = 0;
+  for (int i = 0; i < 8; ++i) v = (v << 8) | p[i];
+  return v;
+}
+
+static void wr64(uint8_t* p, uint64_t v) {
+  for (int i = 7; i >= 0; --i) { p[i] = v & 0xff; v >>= 8; }
+}
+
+// NTP timestamp (32.32 seconds since 1900) -> Unix epoch µs. Seconds below
+// the Unix offset are taken as NTP era 1 (from 2036 on).
+static int64_t ntpToUnixUs(uint64_t ts) {
+  uint64_t sec = ts >> 32;
+  if (sec < NTP_UNIX_OFFSET) sec += 1ull << 32;
+  uint64_t fracUs = ((ts & 0xffffffffull) * 1000000ull) >> 32;
+  return (int64_t)((sec - NTP_UNIX_OFFSET) * 1000000ull + fracUs);
+}
+
+void timeSyncBegin(const char* host) {
+  server = host;
+  serverIP = IPAddress();
+  nextAttemptMs = millis();
+}
+
+static bool resolve() {
+  if (serverIP != IPAddress()) return true;
+  if (serverIP.fromString(server)) return true;
+  // Blocks for the lookup; only runs at the first attempt and after failures
+  WatchdogScope wd("sntp_resolve");
+  if (WiFi.hostByName(server, serverIP) == 1 && serverIP != IPAddress()) return true;
+  serverIP = IPAddress();
+  return false;
+}
+
+static void sendRequest() {
+  uint8_t pkt[NTP_PACKET_LEN] = {0};
+  pkt[0] = (4 << 3) | 3;                   // LI 0, version 4, mode 3 (client)
+  sentUs = monoUs();
+  sentMs = millis();
+  wr64(&pkt[40], sentUs);                  // echoed back as the origin timestamp
+  udp.beginPacket(serverIP, NTP_PORT);
+  udp.write(pkt, sizeof(pkt));
+  udp.endPacket();
+  waiting = true;
+  stats.requests++;
+}
+
+static void applyReply(const uint8_t* pkt, uint64_t recvUs) {
+  uint8_t leap = pkt[0] >> 6, mode = pkt[0] & 7, stratum = pkt[1];
+  if (mode != 4 || leap == 3 || stratum == 0 || stratum > 15 || rd64(&pkt[24]) != sentUs) {
+    stats.rejected++;
+    return;
+  }
+  int64_t serverRx = ntpToUnixUs(rd64(&pkt[32]));
+  int64_t serverTx = ntpToUnixUs(rd64(&pkt[40]));
+  int64_t delayUs  = (int64_t)(recvUs - sentUs) - (serverTx - serverRx);
+  if (delayUs < 0) delayUs = 0;
+  int64_t offsetUs = serverTx + delayUs / 2 - (int64_t)recvUs;
+
+  int32_t correctionMs = source == TIME_SNTP ? (int32_t)((offsetUs - epochOffsetUs) / 1000) : 0;
+  epochOffsetUs = offsetUs;
+  source = TIME_SNTP;
+  waiting = false;
+
+  stats.syncs++;
+  stats.lastOffsetMs = correctionMs;
+  if ((uint32_t)abs(correctionMs) > stats.maxAbsOffsetMs) stats.maxAbsOffsetMs = abs(correctionMs);
+  stats.lastDelayMs = (uint32_t)(delayUs / 1000);
+  if (stats.lastDelayMs > stats.maxDelayMs) stats.maxDelayMs = stats.lastDelayMs;
+  stats.delaySumMs += stats.lastDelayMs;
+  stats.lastSyncMs = millis();
+  nextAttemptMs = stats.lastSyncMs + TIME_SYNC_INTERVAL_MS;
+
+  // Keep time()/gettimeofday() in step for everything else
+  int64_t nowUs = (int64_t)monoUs() + epochOffsetUs;
+  struct timeval tv = { (time_t)(nowUs / 1000000), (suseconds_t)(nowUs % 1000000) };
+  settimeofday(&tv, nullptr);
+  LOGI("TIME", "SNTP sync: correction %ld ms, delay %lu ms",
+       (long)correctionMs, (unsigned long)stats.lastDelayMs);
+}
+
+void timeSyncLoop(bool staConnected) {
+  if (!server) return;
+  if (!staConnected) {
+    if (udpOpen) { udp.stop(); udpOpen = false; }
+    waiting = false;
+    return;
+  }
+  if (!udpOpen) udpOpen = udp.begin(NTP_LOCAL_PORT);
+  if (!udpOpen) return;
+
+  if (waiting) {
+    int len = udp.parsePacket();
+    if (len > 0) {
+      uint64_t recvUs = monoUs();
+      uint8_t pkt[NTP_PACKET_LEN];
+      if (len < NTP_PACKET_LEN || udp.remoteIP() != serverIP) {
+        udp.flush();
+        return;
+      }
+      udp.read(pkt, sizeof(pkt));
+      udp.flush();
+      applyReply(pkt, recvUs);
+      if (!waiting) return;
+    }
+    if (millis() - sentMs < TIME_TIMEOUT_MS) return;
+    waiting = false;
+    stats.timeouts++;
+    serverIP = IPAddress();               // re-resolve next time
+    nextAttemptMs = millis() + TIME_RETRY_MS;
+    LOGW("TIME", "SNTP request to %s timed out", server);
+    return;
+  }
+
+  if ((int32_t)(millis() - nextAttemptMs) < 0) return;
+  if (!resolve()) {
+    nextAttemptMs = millis() + TIME_RETRY_MS;
+    LOGW("TIME", "cannot resolve %s", server);
+    return;
+  }
+  sendRequest();
+}
+
+TimeSource timeSource() { return source; }
+
+const char* timeSourceName() {
+  return source == TIME_SNTP ? "sntp" : "monotonic";
+}
+
+const char* timeSyncServer() { return server ? server : ""; }
+
+uint64_t timeNowMs() {
+  if (source == TIME_MONOTONIC) return 0;
+  return (uint64_t)(((int64_t)monoUs() + epochOffsetUs) / 1000);
+}
+
+uint64_t timeAtMs(uint32_t ms) {
+  if (source == TIME_MONOTONIC) return 0;
+  return timeNowMs() - (uint32_t)(millis() - ms);
+}
+
+const TimeSyncStats& timeSyncStats() { return stats; }
+
+void timeSyncResetStats() {
+  uint32_t last = stats.lastSyncMs;
+  stats = {};
+  stats.lastSyncMs = last;
+}
@@ -0,0 +1,58 @@
+#ifndef TIME_SYNC_H
+#define TIME_SYNC_H
+
+#include <Arduino.h>
+
+// Wall-clock time for sample timestamps.
+//
+// Time is kept as an offset between the Unix epoch and the monotonic
+// esp_timer clock, so it never depends on when a caller asks: a millis()
+// value taken at acquisition maps to wall time as long as any sync has
+// happened since boot (timeAtMs). Until then the clock source is
+// TIME_MONOTONIC and the wall-clock calls return 0.
+//
+// The SNTP client is a single non-blocking UDP exchange driven from the
+// loop (timeSyncLoop) while the STA link is up: one request, the reply is
+// checked against our transmit timestamp, and the offset is computed the
+// NTP way (server time at the midpoint of the round trip). Every sync
+// records the correction it applied to the clock (offset) and the round
+// trip (delay). Builds with -DSNTP_SERVER_OVERRIDE=\"a.b.c.d\" query that
+// host instead, e.g. tools/sntp_stub.py as a local stand-in with a chosen
+// offset and latency.
+
+#define TIME_SYNC_INTERVAL_MS 3600000   // resync once an hour
+#define TIME_RETRY_MS         15000     // after a failed exchange
+#define TIME_TIMEOUT_MS       2000
+
+enum TimeSource : uint8_t {
+  TIME_MONOTONIC = 0,   // no wall clock yet: uptime only
+  TIME_SNTP,
+};
+
+struct TimeSyncStats {
+  uint32_t requests;
+  uint32_t syncs;
+  uint32_t timeouts;
+  uint32_t rejected;       // malformed, unsynchronized server or wrong origin
+  int32_t  lastOffsetMs;   // correction applied by the last sync (0 on the first)
+  uint32_t maxAbsOffsetMs;
+  uint32_t lastDelayMs;    // round trip of the last sync, less server time
+  uint32_t maxDelayMs;
+  uint64_t delaySumMs;
+  uint32_t lastSyncMs;     // millis() of the last sync
+};
+
+void timeSyncBegin(const char* server);
+void timeSyncLoop(bool staConnected);
+
+TimeSource timeSource();
+const char* timeSourceName();
+const char* timeSyncServer();
+// Unix epoch ms now / at a past millis() reading; 0 without a wall clock
+uint64_t timeNowMs();
+uint64_t timeAtMs(uint32_t ms);
+
+const TimeSyncStats& timeSyncStats();
+void timeSyncResetStats();
+
+#endif // TIME_SYNC_H
@@ -0,0 +1,97 @@
+#include "wifi_state.h"
+#include <WiFi.h>
+
+static portMUX_TYPE   mux = portMUX_INITIALIZER_UNLOCKED;
+static WifiState      state = {};
+static WifiStateStats stats = {};
+static bool           rssiDue = false;     // link (re)established: read RSSI now
+static uint32_t       lastRssiMs = 0;
+
+// WiFi event task
+static void onWifiEvent(arduino_event_id_t event, arduino_event_info_t info) {
+  uint32_t now = millis();
+  uint8_t apClients = 0;
+  if (event == ARDUINO_EVENT_WIFI_AP_STACONNECTED || event == ARDUINO_EVENT_WIFI_AP_STADISCONNECTED) {
+    apClients = WiFi.softAPgetStationNum();
+  }
+
+  portENTER_CRITICAL(&mux);
+  stats.events++;
+  switch (event) {
+    case ARDUINO_EVENT_WIFI_STA_CONNECTED: {
+      const wifi_event_sta_connected_t& c = info.wifi_sta_connected;
+      uint8_t len = c.ssid_len < sizeof(state.ssid) - 1 ? c.ssid_len : sizeof(state.ssid) - 1;
+      memcpy(state.ssid, c.ssid, len);
+      state.ssid[len] = '\0';
+      memcpy(state.bssid, c.bssid, sizeof(state.bssid));
+      state.channel = c.channel;
+      rssiDue = true;
+      break;
+    }
+    case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+      state.ip = IPAddress(info.got_ip.ip_info.ip.addr);
+      state.staConnected = true;
+      state.connectedMs = now;
+      rssiDue = true;
+      break;
+    case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+      state.ip = IPAddress();
+      state.staConnected = false;
+      break;
+    case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+      state.staConnected = false;
+      state.ip = IPAddress();
+      state.ssid[0] = '\0';
+      memset(state.bssid, 0, sizeof(state.bssid));
+      state.channel = 0;
+      state.rssi = 0;
+      state.disconnectReason = info.wifi_sta_disconnected.reason;
+      break;
+    case ARDUINO_EVENT_WIFI_AP_STACONNECTED:
+    case ARDUINO_EVENT_WIFI_AP_STADISCONNECTED:
+      state.apClients = apClients;
+      break;
+    default:
+      portEXIT_CRITICAL(&mux);
+      return;
+  }
+  state.version++;
+  portEXIT_CRITICAL(&mux);
+}
+
+void wifiStateBegin() {
+  state.version = 1;
+  WiFi.onEvent(onWifiEvent);
+}
+
+void wifiStateLoop() {
+  uint32_t now = millis();
+  portENTER_CRITICAL(&mux);
+  bool connected = state.staConnected;
+  bool due = rssiDue;
+  portEXIT_CRITICAL(&mux);
+  if (!connected || (!due && now - lastRssiMs < WIFI_RSSI_REFRESH_MS)) return;
+  lastRssiMs = now;
+
+  int8_t rssi = (int8_t)constrain(WiFi.RSSI(), -127, 0);
+  stats.rssiReads++;
+  portENTER_CRITICAL(&mux);
+  rssiDue = false;
+  if (state.staConnected && (due || abs(rssi - state.rssi) >= WIFI_RSSI_HYSTERESIS_DB)) {
+    state.rssi = rssi;
+    state.version++;
+  }
+  portEXIT_CRITICAL(&mux);
+}
+
+WifiState wifiState() {
+  portENTER_CRITICAL(&mux);
+  WifiState copy = state;
+  portEXIT_CRITICAL(&mux);
+  return copy;
+}
+
+bool wifiStaConnected() { return state.staConnected; }
+int8_t wifiRssi() { return state.rssi; }
+uint32_t wifiStateVersion() { return state.version; }
+const WifiStateStats& wifiStateStats() { return stats; }
@@ -0,0 +1,47 @@
+#ifndef WIFI_STATE_H
+#define WIFI_STATE_H
+
+#include <Arduino.h>
+
+// Cached WiFi link state for handlers and the loop.
+//
+// Kept up to date from WiFi.onEvent (STA connect/IP/disconnect, AP client
+// join/leave), which runs in the WiFi event task, plus an RSSI refresh from
+// wifiStateLoop() every WIFI_RSSI_REFRESH_MS while connected. Readers get a
+// consistent copy without touching the driver. `version` goes up on every
+// change, so a consumer that remembers the last version it acted on can
+// skip work while the link is unchanged; RSSI only counts as a change once
+// it moves by WIFI_RSSI_HYSTERESIS_DB, so it does not churn on noise.
+
+#define WIFI_RSSI_REFRESH_MS     2000
+#define WIFI_RSSI_HYSTERESIS_DB  2
+
+struct WifiState {
+  uint32_t  version;
+  bool      staConnected;     // associated and has an IP (WL_CONNECTED)
+  char      ssid[33];         // STA fields are valid while associated
+  uint8_t   bssid[6];
+  uint8_t   channel;
+  IPAddress ip;
+  int8_t    rssi;
+  uint8_t   apClients;
+  uint8_t   disconnectReason; // wifi_err_reason_t of the last STA disconnect
+  uint32_t  connectedMs;      // millis() of the GOT_IP that brought the link up
+};
+
+struct WifiStateStats {
+  uint32_t events;            // event callbacks handled
+  uint32_t rssiReads;         // driver RSSI reads by the refresh
+};
+
+// Registers the event handler; call before WiFi.mode()
+void wifiStateBegin();
+void wifiStateLoop();
+
+WifiState wifiState();        // copy, taken atomically
+bool      wifiStaConnected();
+int8_t    wifiRssi();         // last refreshed STA RSSI, 0 while down
+uint32_t  wifiStateVersion();
+const WifiStateStats& wifiStateStats();
+
+#endif // WIFI_STATE_H
@@ -0,0 +1,132 @@
+// Replays the traces in traces.h through each filter and through the
+// per-channel chains configured in main.cpp, and checks the error against
+// the reference level (RMS and max, in the channel's unit) and the number
+// of rejected outliers.
+//
+//   pio test -e native
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+#include <unity.h>
+
+#include "dsp.h"
+#include "traces.h"
+
+// As TEMP_FILTER / HUMIDITY_FILTER / LIGHT_FILTER in main.cpp
+static const FilterConfig TEMP_CHAIN     = { FILTER_OUTLIER | FILTER_MEDIAN | FILTER_KALMAN, 300, 3, 0, 16, 100 };
+static const FilterConfig HUMIDITY_CHAIN = { FILTER_OUTLIER | FILTER_MEDIAN | FILTER_EMA, 1000, 3, 16384, 0, 0 };
+static const FilterConfig LIGHT_CHAIN    = { FILTER_MEDIAN | FILTER_AVERAGE, 0, 0, 0, 0, 0 };
+
+struct TraceError {
+  uint32_t rms;
+  uint32_t max;
+};
+
+// Error bounds per filter, in the order replayed: outlier, median5, average8, ema,
+// kalman, chain. The linear filters alone smear every glitch over several
+// samples, hence their loose bounds.
+struct TraceBounds {
+  TraceError filters[6];
+};
+
+template <typename Step>
+static TraceError replay(const int16_t* raw, const int16_t* ref, Step step) {
+  uint64_t sq = 0;
+  TraceError e = { 0, 0 };
+  for (uint16_t i = 0; i < TRACE_LEN; ++i) {
+    uint32_t err = abs(step(raw[i]) - ref[i]);
+    sq += (uint64_t)err * err;
+    if (err > e.max) e.max = err;
+  }
+  uint32_t mean = sq / TRACE_LEN;
+  while ((e.rms + 1) * (e.rms + 1) <= mean) e.rms++;   // integer sqrt
+  return e;
+}
+
+static void checkError(const char* name, TraceError e, TraceError bound) {
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(bound.rms, e.rms, name);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(bound.max, e.max, name);
+}
+
+static void checkTrace(const int16_t* raw, const int16_t* ref, const FilterConfig& chain,
+                       int32_t outlierThreshold, uint32_t glitches, uint32_t chainRejects,
+                       const TraceBounds& b) {
+  OutlierReject outlier(outlierThreshold, 3);
+  checkError("outlier", replay(raw, ref, [&](int32_t x) { int32_t y; outlier.process(x, &y); return y; }),
+             b.filters[0]);
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(glitches, outlier.rejected(), "outlier rejects");
+
+  MedianFilter<5> median;
+  checkError("median5", replay(raw, ref, [&](int32_t x) { return median.process(x); }), b.filters[1]);
+  MovingAverage<8> average;
+  checkError("average8", replay(raw, ref, [&](int32_t x) { return average.process(x); }), b.filters[2]);
+  Ema ema(16384);
+  checkError("ema", replay(raw, ref, [&](int32_t x) { return ema.process(x); }), b.filters[3]);
+  Kalman1D kalman(16, 100);
+  checkError("kalman", replay(raw, ref, [&](int32_t x) { return kalman.process(x); }), b.filters[4]);
+
+  FilterChain<> f(chain);
+  checkError("chain", replay(raw, ref, [&](int32_t x) { return f.process(x); }), b.filters[5]);
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(chainRejects, f.rejected(), "chain rejects");
+}
+
+// Centi-degrees: the chain has to stay within 0.1 degC of the reference
+static void test_temperature_trace() {
+  static const TraceBounds b = { { { 8, 20 }, { 7, 20 }, { 400, 2000 }, { 400, 3500 }, { 450, 4000 },
+                                   { 5, 10 } } };
+  checkTrace(TEMP_RAW, TEMP_REF, TEMP_CHAIN, 300, sizeof(TEMP_GLITCHES) / sizeof(TEMP_GLITCHES[0]),
+             sizeof(TEMP_GLITCHES) / sizeof(TEMP_GLITCHES[0]), b);
+}
+
+// Centi-%RH: within 0.6 %RH
+static void test_humidity_trace() {
+  static const TraceBounds b = { { { 20, 60 }, { 15, 70 }, { 450, 2200 }, { 450, 3500 }, { 550, 4500 },
+                                   { 20, 60 } } };
+  checkTrace(HUMIDITY_RAW, HUMIDITY_REF, HUMIDITY_CHAIN, 1000,
+             sizeof(HUMIDITY_GLITCHES) / sizeof(HUMIDITY_GLITCHES[0]),
+             sizeof(HUMIDITY_GLITCHES) / sizeof(HUMIDITY_GLITCHES[0]), b);
+}
+
+// Raw ADC counts; the light chain has no outlier stage (the median takes
+// the spikes), and its moving average lags the cloud by a few counts
+static void test_light_trace() {
+  static const TraceBounds b = { { { 25, 70 }, { 30, 90 }, { 150, 500 }, { 150, 900 }, { 180, 1100 },
+                                   { 80, 180 } } };
+  checkTrace(LIGHT_RAW, LIGHT_REF, LIGHT_CHAIN, 1000, sizeof(LIGHT_GLITCHES) / sizeof(LIGHT_GLITCHES[0]),
+             0, b);
+}
+
+// A genuine step gets through after maxReject samples
+static void test_outlier_accepts_step() {
+  OutlierReject f(300, 3);
+  int32_t y = 0;
+  f.process(2300, &y);
+  for (int i = 0; i < 3; ++i) TEST_ASSERT_FALSE(f.process(2900, &y));
+  TEST_ASSERT_EQUAL_INT32(2300, y);
+  TEST_ASSERT_TRUE(f.process(2900, &y));
+  TEST_ASSERT_EQUAL_INT32(2900, y);
+  TEST_ASSERT_EQUAL_UINT32(3, f.rejected());
+}
+
+void setUp() {}
+void tearDown() {}
+
+static int runTests() {
+  UNITY_BEGIN();
+  RUN_TEST(test_temperature_trace);
+  RUN_TEST(test_humidity_trace);
+  RUN_TEST(test_light_trace);
+  RUN_TEST(test_outlier_accepts_step);
+  return UNITY_END();
+}
+
+#ifdef ARDUINO
+void setup() {
+  delay(2000);   // let the serial monitor attach
+  runTests();
+}
+void loop() {}
+#else
+int main() { return runTests(); }
+#endif
@@ -0,0 +1,141 @@
+#ifndef DSP_TRACES_H
+#define DSP_TRACES_H
+
+// Sensor traces for test_dsp, one reading per second as sampleSensors()
+// takes them: the raw reading and the reference level it should be
+// filtered back to.
+//
+// TEMP / HUMIDITY: DHT22 in hundredths, quantized to the sensor's 0.1
+// resolution, during a slow warm-up. Glitches are the ones a DHT22 on a
+// long cable produces: a failed read decoded as 0, two-sample bursts of
+// checksum garbage, a sign-bit glitch and single-sample spikes.
+// LIGHT: LDR divider on a 12-bit ADC in raw counts while a cloud passes,
+// with rail-to-rail spikes from WiFi TX bursts.
+//
+// The traces are synthesized in that shape (no board capture is checked
+// in yet); a serial capture of the same two columns drops in as is.
+
+#include <stdint.h>
+
+#define TRACE_LEN 240
+
+// Indices of the injected glitches
+static const uint16_t TEMP_GLITCHES[]     = { 20, 45, 46, 71, 88, 150, 201 };
+static const uint16_t HUMIDITY_GLITCHES[] = { 20, 45, 46, 117, 201 };
+static const uint16_t LIGHT_GLITCHES[]    = { 33, 34, 90, 141, 190, 222 };
+
+static const int16_t TEMP_RAW[] = {
+  2310, 2310, 2320, 2320, 2300, 2310, 2310, 2310, 2310, 2310, 2320, 2310, 2320, 2310, 2320,
+  2320, 2320, 2310, 2310, 2310, 0, 2320, 2330, 2320, 2320, 2320, 2320, 2310, 2330, 2330,
+  2330, 2330, 2320, 2310, 2330, 2320, 2320, 2320, 2330, 2330, 2330, 2320, 2330, 2330, 2320,
+  8510, 8510, 2320, 2330, 2320, 2310, 2330, 2320, 2330, 2310, 2320, 2320, 2320, 2330, 2330,
+  2340, 2330, 2330, 2320, 2340, 2330, 2340, 2340, 2330, 2320, 2330, -400, 2340, 2320, 2340,
+  2340, 2340, 2330, 2330, 2340, 2350, 2340, 2350, 2350, 2340, 2360, 2340, 2360, 3310, 2360,
+  2350, 2340, 2350, 2360, 2360, 2360, 2360, 2360, 2360, 2370, 2370, 2370, 2370, 2370, 2380,
+  2380, 2360, 2360, 2360, 2370, 2380, 2370, 2370, 2370, 2360, 2370, 2370, 2370, 2370, 2370,
+  2370, 2360, 2380, 2380, 2370, 2370, 2370, 2360, 2380, 2370, 2380, 2390, 2370, 2370, 2380,
+  2370, 2370, 2370, 2380, 2370, 2380, 2380, 2370, 2370, 2380, 2380, 2380, 2380, 2380, 2370,
+  0, 2380, 2370, 2360, 2380, 2380, 2380, 2380, 2370, 2380, 2380, 2380, 2380, 2390, 2370,
+  2370, 2370, 2370, 2390, 2380, 2380, 2380, 2380, 2370, 2370, 2380, 2370, 2380, 2380, 2370,
+  2370, 2380, 2380, 2380, 2370, 2380, 2390, 2370, 2370, 2390, 2390, 2390, 2390, 2390, 2390,
+  2390, 2390, 2380, 2390, 2380, 2380, 6550, 2390, 2380, 2390, 2390, 2390, 2380, 2390, 2380,
+  2390, 2380, 2400, 2380, 2390, 2380, 2390, 2380, 2390, 2380, 2390, 2370, 2380, 2380, 2390,
+  2380, 2370, 2380, 2370, 2380, 2380, 2370, 2380, 2390, 2380, 2370, 2380, 2370, 2370, 2370
+};
+
+static const int16_t TEMP_REF[] = {
+  2310, 2310, 2311, 2311, 2312, 2312, 2313, 2313, 2314, 2314, 2315, 2315, 2315, 2316, 2316,
+  2317, 2317, 2317, 2318, 2318, 2319, 2319, 2319, 2320, 2320, 2320, 2320, 2321, 2321, 2321,
+  2321, 2321, 2321, 2322, 2322, 2322, 2322, 2322, 2322, 2322, 2322, 2322, 2322, 2323, 2323,
+  2323, 2323, 2323, 2323, 2323, 2324, 2324, 2324, 2324, 2324, 2325, 2325, 2325, 2326, 2326,
+  2326, 2327, 2327, 2328, 2328, 2329, 2330, 2330, 2331, 2332, 2332, 2333, 2334, 2335, 2335,
+  2336, 2337, 2338, 2339, 2340, 2341, 2342, 2343, 2344, 2345, 2346, 2347, 2349, 2350, 2351,
+  2352, 2353, 2354, 2355, 2356, 2357, 2358, 2359, 2360, 2361, 2362, 2363, 2364, 2365, 2366,
+  2367, 2367, 2368, 2369, 2370, 2370, 2371, 2372, 2372, 2373, 2373, 2374, 2374, 2374, 2375,
+  2375, 2375, 2375, 2376, 2376, 2376, 2376, 2376, 2376, 2376, 2376, 2376, 2376, 2376, 2376,
+  2376, 2376, 2376, 2376, 2375, 2375, 2375, 2375, 2375, 2375, 2375, 2375, 2374, 2374, 2374,
+  2374, 2374, 2374, 2374, 2374, 2374, 2374, 2374, 2374, 2374, 2374, 2374, 2374, 2374, 2375,
+  2375, 2375, 2375, 2376, 2376, 2376, 2376, 2377, 2377, 2378, 2378, 2378, 2379, 2379, 2380,
+  2380, 2380, 2381, 2381, 2382, 2382, 2382, 2383, 2383, 2384, 2384, 2384, 2384, 2385, 2385,
+  2385, 2385, 2386, 2386, 2386, 2386, 2386, 2386, 2386, 2386, 2386, 2386, 2386, 2386, 2385,
+  2385, 2385, 2385, 2384, 2384, 2384, 2384, 2383, 2383, 2382, 2382, 2382, 2381, 2381, 2380,
+  2380, 2380, 2379, 2379, 2378, 2378, 2378, 2377, 2377, 2376, 2376, 2376, 2376, 2375, 2375
+};
+
+static const int16_t HUMIDITY_RAW[] = {
+  6410, 6410, 6420, 6460, 6430, 6440, 6460, 6390, 6430, 6450, 6410, 6430, 6460, 6440, 6440,
+  6470, 6410, 6450, 6410, 6440, 0, 6430, 6420, 6440, 6430, 6430, 6430, 6420, 6440, 6400,
+  6370, 6370, 6390, 6370, 6380, 6380, 6400, 6350, 6370, 6340, 6370, 6320, 6370, 6340, 6380,
+  13100, 13100, 6320, 6310, 6330, 6340, 6320, 6310, 6300, 6330, 6290, 6310, 6280, 6280, 6310,
+  6270, 6320, 6320, 6270, 6270, 6280, 6280, 6270, 6300, 6320, 6280, 6290, 6270, 6280, 6270,
+  6270, 6270, 6260, 6270, 6260, 6270, 6240, 6270, 6260, 6260, 6250, 6250, 6250, 6240, 6240,
+  6200, 6220, 6230, 6200, 6260, 6240, 6180, 6230, 6210, 6200, 6210, 6180, 6180, 6190, 6160,
+  6160, 6160, 6160, 6130, 6140, 6130, 6150, 6120, 6140, 6120, 6110, 6120, 0, 6100, 6120,
+  6120, 6070, 6110, 6060, 6090, 6100, 6090, 6090, 6080, 6090, 6060, 6110, 6050, 6080, 6050,
+  6080, 6070, 6060, 6100, 6070, 6070, 6080, 6100, 6100, 6080, 6090, 6090, 6090, 6080, 6100,
+  6070, 6110, 6110, 6090, 6090, 6060, 6090, 6110, 6070, 6110, 6080, 6120, 6100, 6110, 6090,
+  6090, 6070, 6110, 6080, 6090, 6060, 6080, 6060, 6080, 6090, 6060, 6050, 6070, 6060, 6050,
+  6030, 6060, 6060, 6060, 6070, 6060, 6060, 6030, 6040, 6040, 6030, 6060, 6040, 6050, 6040,
+  6050, 6060, 6060, 6060, 6050, 6030, 9990, 6050, 6040, 6080, 6060, 6060, 6040, 6080, 6070,
+  6060, 6080, 6090, 6090, 6090, 6100, 6070, 6070, 6100, 6110, 6130, 6080, 6090, 6080, 6100,
+  6090, 6100, 6090, 6110, 6100, 6130, 6110, 6100, 6090, 6100, 6080, 6090, 6080, 6100, 6080
+};
+
+static const int16_t HUMIDITY_REF[] = {
+  6420, 6422, 6424, 6426, 6428, 6430, 6432, 6433, 6434, 6435, 6436, 6437, 6437, 6437, 6437,
+  6437, 6436, 6435, 6434, 6433, 6431, 6429, 6427, 6424, 6422, 6419, 6416, 6412, 6409, 6405,
+  6401, 6397, 6393, 6389, 6385, 6380, 6376, 6371, 6367, 6362, 6358, 6353, 6349, 6345, 6341,
+  6336, 6332, 6329, 6325, 6321, 6318, 6315, 6311, 6309, 6306, 6303, 6301, 6298, 6296, 6294,
+  6292, 6291, 6289, 6288, 6286, 6285, 6284, 6283, 6281, 6280, 6279, 6278, 6277, 6276, 6274,
+  6273, 6272, 6270, 6268, 6267, 6265, 6262, 6260, 6258, 6255, 6252, 6249, 6246, 6243, 6239,
+  6235, 6231, 6227, 6223, 6218, 6214, 6209, 6204, 6199, 6194, 6189, 6184, 6178, 6173, 6168,
+  6163, 6157, 6152, 6147, 6142, 6137, 6132, 6127, 6123, 6119, 6114, 6110, 6107, 6103, 6100,
+  6097, 6094, 6092, 6089, 6087, 6085, 6084, 6082, 6081, 6081, 6080, 6080, 6079, 6079, 6079,
+  6080, 6080, 6081, 6082, 6082, 6083, 6084, 6085, 6086, 6087, 6088, 6089, 6090, 6091, 6092,
+  6093, 6094, 6094, 6095, 6095, 6095, 6095, 6095, 6095, 6095, 6094, 6094, 6093, 6092, 6091,
+  6090, 6088, 6086, 6085, 6083, 6081, 6079, 6077, 6074, 6072, 6070, 6068, 6066, 6063, 6061,
+  6059, 6057, 6055, 6054, 6052, 6050, 6049, 6048, 6047, 6046, 6046, 6045, 6045, 6045, 6045,
+  6046, 6046, 6047, 6048, 6049, 6050, 6052, 6054, 6055, 6057, 6059, 6061, 6063, 6066, 6068,
+  6070, 6072, 6074, 6077, 6079, 6081, 6083, 6085, 6086, 6088, 6090, 6091, 6092, 6093, 6094,
+  6094, 6095, 6095, 6095, 6095, 6094, 6094, 6093, 6092, 6091, 6090, 6088, 6086, 6085, 6083
+};
+
+static const int16_t LIGHT_RAW[] = {
+  2452, 2469, 2455, 2450, 2426, 2454, 2472, 2450, 2443, 2462, 2490, 2455, 2446, 2437, 2451,
+  2422, 2437, 2435, 2478, 2420, 2451, 2438, 2426, 2458, 2470, 2444, 2443, 2451, 2463, 2456,
+  2444, 2439, 2451, 4095, 4095, 2471, 2452, 2446, 2428, 2428, 2465, 2446, 2428, 2424, 2438,
+  2478, 2448, 2403, 2440, 2451, 2419, 2443, 2471, 2428, 2409, 2431, 2455, 2419, 2437, 2438,
+  2431, 2430, 2396, 2469, 2421, 2446, 2413, 2394, 2375, 2378, 2391, 2371, 2407, 2372, 2366,
+  2388, 2353, 2299, 2340, 2283, 2274, 2303, 2272, 2220, 2248, 2271, 2166, 2164, 2130, 2137,
+  0, 2087, 2040, 2052, 2018, 2041, 1972, 1918, 1897, 1894, 1861, 1833, 1845, 1797, 1764,
+  1728, 1708, 1717, 1704, 1679, 1653, 1631, 1651, 1619, 1606, 1561, 1577, 1554, 1543, 1534,
+  1568, 1566, 1565, 1568, 1574, 1585, 1602, 1585, 1602, 1624, 1650, 1670, 1676, 1682, 1725,
+  1725, 1773, 1815, 1795, 1878, 1863, 4095, 1899, 1911, 1975, 2000, 2030, 2052, 2083, 2089,
+  2096, 2146, 2164, 2196, 2209, 2212, 2247, 2236, 2262, 2267, 2286, 2286, 2310, 2342, 2318,
+  2368, 2377, 2374, 2364, 2410, 2381, 2399, 2422, 2394, 2428, 2408, 2445, 2418, 2423, 2440,
+  2437, 2425, 2452, 2409, 2460, 2463, 2440, 2436, 2447, 2402, 3900, 2466, 2436, 2455, 2462,
+  2471, 2458, 2447, 2471, 2452, 2446, 2485, 2448, 2453, 2443, 2467, 2433, 2457, 2440, 2495,
+  2463, 2451, 2455, 2439, 2454, 2467, 2427, 2425, 2453, 2439, 2460, 2445, 0, 2417, 2463,
+  2462, 2455, 2469, 2457, 2418, 2450, 2446, 2440, 2490, 2448, 2420, 2455, 2459, 2425, 2452
+};
+
+static const int16_t LIGHT_REF[] = {
+  2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450,
+  2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450,
+  2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2449, 2449, 2449, 2449, 2449, 2449, 2449,
+  2448, 2448, 2448, 2447, 2447, 2446, 2445, 2445, 2444, 2443, 2442, 2441, 2439, 2437, 2436,
+  2434, 2431, 2429, 2426, 2422, 2419, 2415, 2410, 2405, 2400, 2394, 2388, 2380, 2373, 2364,
+  2355, 2345, 2335, 2323, 2311, 2298, 2284, 2269, 2253, 2237, 2219, 2201, 2182, 2162, 2141,
+  2119, 2096, 2073, 2050, 2025, 2001, 1975, 1950, 1924, 1899, 1873, 1847, 1822, 1797, 1773,
+  1749, 1726, 1704, 1683, 1663, 1645, 1627, 1612, 1598, 1585, 1575, 1566, 1559, 1554, 1551,
+  1550, 1551, 1554, 1559, 1566, 1575, 1585, 1598, 1612, 1627, 1645, 1663, 1683, 1704, 1726,
+  1749, 1773, 1797, 1822, 1847, 1873, 1899, 1924, 1950, 1975, 2001, 2025, 2050, 2073, 2096,
+  2119, 2141, 2162, 2182, 2201, 2219, 2237, 2253, 2269, 2284, 2298, 2311, 2323, 2335, 2345,
+  2355, 2364, 2373, 2380, 2388, 2394, 2400, 2405, 2410, 2415, 2419, 2422, 2426, 2429, 2431,
+  2434, 2436, 2437, 2439, 2441, 2442, 2443, 2444, 2445, 2445, 2446, 2447, 2447, 2448, 2448,
+  2448, 2449, 2449, 2449, 2449, 2449, 2449, 2449, 2450, 2450, 2450, 2450, 2450, 2450, 2450,
+  2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450,
+  2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450, 2450
+};
+
+#endif // DSP_TRACES_H
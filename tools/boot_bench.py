@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""
+Boot-time benchmark.
+
+Reboots the device through POST /api/boot/restart, polls it until the HTTP
+server answers again, then collects the on-device boot timeline from
+/api/boot. Repeats for --runs boots and reports min/median/max for every
+stage plus the client-observed restart-to-first-response time. The firmware
+must be built with -DBOOT_BENCH, which enables the restart endpoint.
+
+  python tools/boot_bench.py --host 192.168.4.1 --runs 5 --out boot.json
+
+The client must be able to reach the device again after the reboot (stay
+associated to its AP, or use the STA address on the LAN). Device-side numbers
+(`first_http_response_us`, `http_up`) do not depend on how quickly the client
+rejoins; the client-side number does.
+"""
+
+import argparse
+import http.client
+import json
+import statistics
+import sys
+import time
+
+
+def request(host, port, method, path, timeout):
+    conn = http.client.HTTPConnection(host, port, timeout=timeout)
+    try:
+        conn.request(method, path)
+        resp = conn.getresponse()
+        return resp.status, resp.read()
+    finally:
+        conn.close()
+
+
+def wait_for_boot(host, port, timeout):
+    """Polls /api/boot until it answers; returns (seconds waited, body)."""
+    t0 = time.monotonic()
+    while time.monotonic() - t0 < timeout:
+        try:
+            status, body = request(host, port, "GET", "/api/boot", 0.5)
+            if status == 200:
+                return time.monotonic() - t0, json.loads(body)
+        except (OSError, http.client.HTTPException, ValueError):
+            pass
+        time.sleep(0.05)
+    return None, None
+
+
+def summarize(vals):
+    if not vals:
+        return None
+    return {"min": min(vals), "median": statistics.median(vals), "max": max(vals), "n": len(vals)}
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--host", default="192.168.4.1")
+    ap.add_argument("--port", type=int, default=80)
+    ap.add_argument("--runs", type=int, default=5)
+    ap.add_argument("--timeout", type=float, default=30.0, help="max wait for the device to come back")
+    ap.add_argument("--settle", type=float, default=2.0,
+                    help="seconds to wait after it answers, so deferred stages are recorded")
+    ap.add_argument("--out", help="write JSON results here (default: stdout)")
+    args = ap.parse_args()
+
+    runs = []
+    for i in range(args.runs):
+        try:
+            request(args.host, args.port, "POST", "/api/boot/restart", 2.0)
+        except (OSError, http.client.HTTPException):
+            pass   # the device may drop the connection while restarting
+        time.sleep(0.5)   # don't hit the old instance before it goes down
+        waited, _ = wait_for_boot(args.host, args.port, args.timeout)
+        if waited is None:
+            print("run %d: device did not come back within %.0fs" % (i + 1, args.timeout), file=sys.stderr)
+            continue
+        time.sleep(args.settle)
+        _, boot = wait_for_boot(args.host, args.port, args.timeout)
+        if boot is None:
+            continue
+        boot["client_restart_to_response_ms"] = (waited + 0.5) * 1000.0
+        runs.append(boot)
+        print("run %d: http_up %.1f ms, first response %.1f ms" % (
+            i + 1, next((s["at_us"] for s in boot["stages"] if s["stage"] == "http_up"), 0) / 1000.0,
+            boot["first_http_response_us"] / 1000.0), file=sys.stderr)
+
+    stages = {}
+    for boot in runs:
+        for s in boot["stages"]:
+            stages.setdefault(s["stage"], []).append(s["at_us"] / 1000.0)
+    report = {
+        "host": args.host,
+        "runs": len(runs),
+        "stages_ms": {name: summarize(v) for name, v in stages.items()},
+        "setup_ms": summarize([b["setup_us"] / 1000.0 for b in runs]),
+        "first_http_response_ms": summarize([b["first_http_response_us"] / 1000.0 for b in runs]),
+        "client_restart_to_response_ms": summarize([b["client_restart_to_response_ms"] for b in runs]),
+        "raw": runs,
+    }
+    text = json.dumps(report, indent=2)
+    if args.out:
+        with open(args.out, "w") as f:
+            f.write(text + "\n")
+    else:
+        print(text)
+
+
+if __name__ == "__main__":
+    main()
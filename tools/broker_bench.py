@@ -0,0 +1,290 @@
+#!/usr/bin/env python3
+"""
+Fan-out benchmark for the device's local MQTT broker (AP side, port 1883).
+
+Connects N subscribers and one publisher from this machine, publishes
+timestamped messages to a bench topic and measures how long each message
+takes to reach every subscriber (fan-out latency), per-delivery latency,
+loss and deliveries per second. Before that, one subscriber also checks that
+the device's retained sensor sample arrives right after SUBSCRIBE.
+
+  python tools/broker_bench.py --host 192.168.4.1 --subscribers 4 --messages 500 --rate 50
+  python tools/broker_bench.py --subscribers 6 --qos 1 --rate 0    # back to back
+
+The broker has BROKER_MAX_CLIENTS slots (8); the publisher takes one.
+"""
+
+import argparse
+import json
+import socket
+import struct
+import sys
+import threading
+import time
+
+CONNECT, CONNACK, PUBLISH, PUBACK, SUBSCRIBE, SUBACK = 1, 2, 3, 4, 8, 9
+PINGREQ, DISCONNECT = 12, 14
+
+
+def encode_length(n):
+    out = bytearray()
+    while True:
+        b = n & 0x7F
+        n >>= 7
+        out.append(b | 0x80 if n else b)
+        if not n:
+            return bytes(out)
+
+
+def mqtt_str(s):
+    b = s.encode() if isinstance(s, str) else s
+    return struct.pack("!H", len(b)) + b
+
+
+def packet(ptype, flags, body):
+    return bytes([(ptype << 4) | flags]) + encode_length(len(body)) + body
+
+
+class Client:
+    """Blocking MQTT 3.1.1 client: just enough for the benchmark."""
+
+    def __init__(self, host, port, client_id, timeout):
+        self.sock = socket.create_connection((host, port), timeout=timeout)
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self.buf = b""
+        self.next_id = 1
+        body = mqtt_str("MQTT") + bytes([4, 0x02]) + struct.pack("!H", 60) + mqtt_str(client_id)
+        self.sock.sendall(packet(CONNECT, 0, body))
+        ptype, _, body = self.read_packet()
+        if ptype != CONNACK or body[1] != 0:
+            raise RuntimeError("%s: connect refused (%r)" % (client_id, body))
+
+    def read_packet(self):
+        """Returns (type, flags, body); raises socket.timeout."""
+        while True:
+            if len(self.buf) >= 2:
+                rem, mult, i = 0, 1, 1
+                while i < len(self.buf):
+                    rem += (self.buf[i] & 0x7F) * mult
+                    mult *= 128
+                    i += 1
+                    if not self.buf[i - 1] & 0x80:
+                        break
+                else:
+                    i = None
+                if i is not None and len(self.buf) >= i + rem:
+                    head, body = self.buf[0], self.buf[i:i + rem]
+                    self.buf = self.buf[i + rem:]
+                    return head >> 4, head & 0x0F, body
+            chunk = self.sock.recv(65536)
+            if not chunk:
+                raise ConnectionError("broker closed the connection")
+            self.buf += chunk
+
+    def subscribe(self, topic, qos):
+        pid = self.next_id
+        self.next_id += 1
+        self.sock.sendall(packet(SUBSCRIBE, 2, struct.pack("!H", pid) + mqtt_str(topic) + bytes([qos])))
+        while True:
+            ptype, _, body = self.read_packet()
+            if ptype == SUBACK:
+                if body[2] == 0x80:
+                    raise RuntimeError("subscribe to %s refused" % topic)
+                return body[2]
+
+    def publish(self, topic, payload, qos):
+        body = mqtt_str(topic)
+        if qos:
+            body += struct.pack("!H", self.next_id)
+            self.next_id = self.next_id % 0xFFFF + 1
+        self.sock.sendall(packet(PUBLISH, qos << 1, body + payload))
+
+    def close(self):
+        try:
+            self.sock.sendall(packet(DISCONNECT, 0, b""))
+            self.sock.close()
+        except OSError:
+            pass
+
+
+def parse_publish(flags, body):
+    tlen = struct.unpack("!H", body[:2])[0]
+    topic = body[2:2 + tlen].decode(errors="replace")
+    pos = 2 + tlen
+    pid = None
+    if (flags >> 1) & 3:
+        pid = struct.unpack("!H", body[pos:pos + 2])[0]
+        pos += 2
+    return topic, pid, body[pos:], bool(flags & 1)
+
+
+def subscriber(cli, topic, expected, arrivals, done):
+    """Collects (seq, receive time) for the bench topic until `expected` or done."""
+    got = 0
+    while got < expected and not done.is_set():
+        try:
+            ptype, flags, body = cli.read_packet()
+        except socket.timeout:
+            continue
+        except (OSError, ConnectionError):
+            return
+        if ptype != PUBLISH:
+            continue
+        now = time.perf_counter()
+        t, pid, payload, _ = parse_publish(flags, body)
+        if pid is not None:
+            cli.sock.sendall(packet(PUBACK, 0, struct.pack("!H", pid)))
+        if t != topic:
+            continue
+        seq = int(payload.split(b",", 1)[0])
+        arrivals.append((seq, now))
+        got += 1
+
+
+def drain(cli, done):
+    """Publisher side: swallow PUBACKs so the socket never backs up."""
+    while not done.is_set():
+        try:
+            cli.read_packet()
+        except socket.timeout:
+            continue
+        except (OSError, ConnectionError):
+            return
+
+
+def percentile(vals, pct):
+    if not vals:
+        return 0.0
+    return vals[min(len(vals) - 1, int(pct / 100.0 * len(vals)))]
+
+
+def summary(vals):
+    vals = sorted(vals)
+    return {
+        "p50": round(percentile(vals, 50), 3),
+        "p90": round(percentile(vals, 90), 3),
+        "p99": round(percentile(vals, 99), 3),
+        "max": round(vals[-1], 3) if vals else 0.0,
+    }
+
+
+def check_retained(args):
+    """Subscribes to the device's sensor topics; the retained sample should come straight back."""
+    cli = Client(args.host, args.port, "bench-retained", 2.0)
+    try:
+        t0 = time.perf_counter()
+        cli.subscribe(args.sensor_topic, 0)
+        while True:
+            ptype, flags, body = cli.read_packet()
+            if ptype == PUBLISH:
+                topic, _, payload, retained = parse_publish(flags, body)
+                return {
+                    "topic": topic,
+                    "retained": retained,
+                    "after_subscribe_ms": round((time.perf_counter() - t0) * 1000.0, 3),
+                    "payload": payload.decode(errors="replace"),
+                }
+    except socket.timeout:
+        return None
+    finally:
+        cli.close()
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--host", default="192.168.4.1")
+    ap.add_argument("--port", type=int, default=1883)
+    ap.add_argument("--subscribers", type=int, default=4)
+    ap.add_argument("--messages", type=int, default=500)
+    ap.add_argument("--rate", type=float, default=50.0, help="messages/s, 0 = back to back")
+    ap.add_argument("--size", type=int, default=96, help="payload bytes (a sensor sample is ~90)")
+    ap.add_argument("--qos", type=int, choices=(0, 1), default=0)
+    ap.add_argument("--topic", default="bench/fanout")
+    ap.add_argument("--sensor-topic", default="+/+/+/sensors",
+                    help="filter for the retained-sample check ('' to skip)")
+    ap.add_argument("--timeout", type=float, default=5.0, help="wait for stragglers after the last publish")
+    ap.add_argument("--out", help="write JSON results here (default: stdout)")
+    args = ap.parse_args()
+
+    retained = check_retained(args) if args.sensor_topic else None
+
+    done = threading.Event()
+    subs, threads, arrivals = [], [], []
+    for i in range(args.subscribers):
+        cli = Client(args.host, args.port, "bench-sub-%d" % i, 0.2)
+        cli.subscribe(args.topic, args.qos)
+        subs.append(cli)
+        arrivals.append([])
+        t = threading.Thread(target=subscriber,
+                             args=(cli, args.topic, args.messages, arrivals[i], done), daemon=True)
+        threads.append(t)
+    pub = Client(args.host, args.port, "bench-pub", 0.2)
+    threading.Thread(target=drain, args=(pub, done), daemon=True).start()
+    for t in threads:
+        t.start()
+
+    sent_at = {}
+    interval = 1.0 / args.rate if args.rate > 0 else 0.0
+    start = time.perf_counter()
+    for seq in range(args.messages):
+        if interval:
+            wait = start + seq * interval - time.perf_counter()
+            if wait > 0:
+                time.sleep(wait)
+        payload = ("%d," % seq).encode().ljust(args.size, b"x")
+        sent_at[seq] = time.perf_counter()
+        pub.publish(args.topic, payload, args.qos)
+    publish_s = time.perf_counter() - start
+
+    deadline = time.perf_counter() + args.timeout
+    for t in threads:
+        t.join(max(0.0, deadline - time.perf_counter()))
+    done.set()
+    for cli in subs + [pub]:
+        cli.close()
+
+    # Fan-out is complete once the last subscriber has the message
+    per_delivery = []
+    last_arrival = {}
+    copies = {}
+    received = 0
+    for sub_arrivals in arrivals:
+        for seq, t in sub_arrivals:
+            received += 1
+            per_delivery.append((t - sent_at[seq]) * 1000.0)
+            last_arrival[seq] = max(last_arrival.get(seq, 0.0), t)
+            copies[seq] = copies.get(seq, 0) + 1
+    complete = [(last_arrival[seq] - sent_at[seq]) * 1000.0
+                for seq in last_arrival if copies[seq] == args.subscribers]
+    expected = args.messages * args.subscribers
+    end = max(last_arrival.values()) if last_arrival else start
+    elapsed = end - start
+
+    result = {
+        "host": args.host,
+        "subscribers": args.subscribers,
+        "messages": args.messages,
+        "payload_bytes": args.size,
+        "qos": args.qos,
+        "rate": args.rate,
+        "publish_s": round(publish_s, 3),
+        "expected": expected,
+        "received": received,
+        "lost": expected - received,
+        "deliveries_per_s": round(received / elapsed, 1) if elapsed > 0 else 0.0,
+        "messages_per_s": round(len(last_arrival) / elapsed, 1) if elapsed > 0 else 0.0,
+        "delivery_ms": summary(per_delivery),
+        "fanout_complete_ms": summary(complete),
+        "retained_sample": retained,
+    }
+    text = json.dumps(result, indent=2)
+    if args.out:
+        with open(args.out, "w") as f:
+            f.write(text + "\n")
+    else:
+        print(text)
+    return 0 if received == expected else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""
+DNS burst benchmark for the captive-portal responder.
+
+Mimics a phone joining the AP: fires bursts of A / AAAA / HTTPS lookups for
+the usual connectivity-check hostnames, then measures how many queries per
+second come back, per-query latency and whether A answers point at the AP.
+
+  python tools/dns_bench.py --server 192.168.4.1 --burst 40 -d 10
+
+With the STA uplink connected the device forwards non-probe names; query
+real names and accept any address to measure the forwarder and its cache:
+
+  python tools/dns_bench.py --names example.com,example.org --unique 50 --expect any
+"""
+
+import argparse
+import json
+import random
+import socket
+import struct
+import sys
+import time
+
+HOSTNAMES = [
+    "connectivitycheck.gstatic.com",
+    "clients3.google.com",
+    "captive.apple.com",
+    "www.apple.com",
+    "www.msftconnecttest.com",
+    "dns.msftncsi.com",
+    "detectportal.firefox.com",
+    "play.googleapis.com",
+    "mtalk.google.com",
+    "time.android.com",
+]
+QTYPES = {"A": 1, "AAAA": 28, "HTTPS": 65}
+
+
+def build_query(qid, name, qtype):
+    header = struct.pack("!HHHHHH", qid, 0x0100, 1, 0, 0, 0)
+    qname = b"".join(bytes([len(p)]) + p.encode() for p in name.split(".")) + b"\x00"
+    return header + qname + struct.pack("!HH", qtype, 1)
+
+
+def parse_answer_ip(resp, qlen):
+    """Returns the first A record address (the responder always uses one RR)."""
+    ancount = struct.unpack("!H", resp[6:8])[0]
+    if ancount == 0 or len(resp) < qlen + 16:
+        return None
+    rr = resp[qlen:qlen + 16]
+    if struct.unpack("!H", rr[2:4])[0] != 1:
+        return None
+    return socket.inet_ntoa(rr[12:16])
+
+
+def percentile(vals, pct):
+    if not vals:
+        return 0.0
+    return vals[min(len(vals) - 1, int(pct / 100.0 * len(vals)))]
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--server", default="192.168.4.1")
+    ap.add_argument("--port", type=int, default=53)
+    ap.add_argument("--burst", type=int, default=40, help="queries in flight per burst")
+    ap.add_argument("-d", "--duration", type=float, default=10.0)
+    ap.add_argument("--timeout", type=float, default=2.0, help="per-burst reply timeout")
+    ap.add_argument("--types", default="A,AAAA,HTTPS")
+    ap.add_argument("--expect", help="IP the A answers must carry (default: --server); "
+                    "'any' accepts any address, e.g. when the device is forwarding")
+    ap.add_argument("--names", help="comma-separated hostnames to query instead of the probe list")
+    ap.add_argument("--unique", type=int, default=0,
+                    help="append one of N numbered labels to each name, to control cache hit rate")
+    ap.add_argument("--out", help="write JSON results here (default: stdout)")
+    args = ap.parse_args()
+
+    types = [QTYPES[t.strip().upper()] for t in args.types.split(",")]
+    names = [n.strip() for n in args.names.split(",")] if args.names else HOSTNAMES
+    expect = args.expect or args.server
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.settimeout(0.05)
+
+    latencies = []
+    sent = received = lost = wrong = nodata = 0
+    burst_times = []
+    start = time.monotonic()
+    while time.monotonic() - start < args.duration:
+        pending = {}
+        b0 = time.perf_counter()
+        for _ in range(args.burst):
+            qid = random.randrange(0x10000)
+            while qid in pending:
+                qid = random.randrange(0x10000)
+            name = random.choice(names)
+            if args.unique:
+                name = "h%d.%s" % (random.randrange(args.unique), name)
+            q = build_query(qid, name, random.choice(types))
+            pending[qid] = (time.perf_counter(), len(q), q)
+            sock.sendto(q, (args.server, args.port))
+            sent += 1
+        deadline = time.perf_counter() + args.timeout
+        while pending and time.perf_counter() < deadline:
+            try:
+                resp, _ = sock.recvfrom(1024)
+            except socket.timeout:
+                continue
+            now = time.perf_counter()
+            qid = struct.unpack("!H", resp[:2])[0]
+            if qid not in pending:
+                continue
+            t0, qlen, q = pending.pop(qid)
+            latencies.append((now - t0) * 1000.0)
+            received += 1
+            qtype = struct.unpack("!H", q[qlen - 4:qlen - 2])[0]
+            if qtype == 1:
+                ip = parse_answer_ip(resp, qlen)
+                if ip is None or (expect != "any" and ip != expect):
+                    wrong += 1
+            elif struct.unpack("!H", resp[6:8])[0] == 0:
+                nodata += 1
+        lost += len(pending)
+        burst_times.append((time.perf_counter() - b0) * 1000.0)
+    elapsed = time.monotonic() - start
+
+    latencies.sort()
+    burst_times.sort()
+    result = {
+        "server": args.server,
+        "burst": args.burst,
+        "elapsed_s": round(elapsed, 3),
+        "sent": sent,
+        "received": received,
+        "lost": lost,
+        "wrong_answer": wrong,
+        "nodata": nodata,
+        "qps": round(received / elapsed, 1) if elapsed else 0.0,
+        "latency_ms": {
+            "p50": round(percentile(latencies, 50), 3),
+            "p99": round(percentile(latencies, 99), 3),
+            "max": round(latencies[-1], 3) if latencies else 0.0,
+        },
+        "burst_complete_ms_p50": round(percentile(burst_times, 50), 3),
+    }
+    text = json.dumps(result, indent=2)
+    if args.out:
+        with open(args.out, "w") as f:
+            f.write(text + "\n")
+    else:
+        print(text)
+    return 0 if received and not wrong else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
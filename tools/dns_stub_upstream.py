@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+"""
+Stand-in upstream resolver for exercising the DNS forwarder without the
+internet. Answers A queries with an address derived from the name, returns
+NXDOMAIN (with an SOA) for *.invalid and NODATA for other types, after an
+optional artificial delay to mimic a real uplink.
+
+Point the firmware at it with
+  build_flags = -DDNS_UPSTREAM_OVERRIDE=\\"<host ip>\\"
+and run
+  sudo python tools/dns_stub_upstream.py --ttl 30 --delay-ms 20
+"""
+
+import argparse
+import hashlib
+import socket
+import struct
+import threading
+import time
+
+
+def parse_question(pkt):
+    pos = 12
+    labels = []
+    while pkt[pos] != 0:
+        n = pkt[pos]
+        labels.append(pkt[pos + 1:pos + 1 + n].decode(errors="replace"))
+        pos += n + 1
+    pos += 1
+    qtype, _ = struct.unpack("!HH", pkt[pos:pos + 4])
+    return ".".join(labels).lower(), qtype, pos + 4
+
+
+def answer(pkt, ttl):
+    name, qtype, qend = parse_question(pkt)
+    qid, flags = struct.unpack("!HH", pkt[:4])
+    question = pkt[12:qend]
+    rflags = 0x8000 | (flags & 0x0100) | 0x0080  # QR, copy RD, RA
+    if name.endswith(".invalid"):
+        soa_rdata = b"\x00\x00" + struct.pack("!IIIII", 1, 3600, 600, 86400, ttl)
+        soa = b"\xc0\x0c" + struct.pack("!HHIH", 6, 1, ttl, len(soa_rdata)) + soa_rdata
+        return struct.pack("!HHHHHH", qid, rflags | 3, 1, 0, 1, 0) + question + soa
+    if qtype != 1:
+        return struct.pack("!HHHHHH", qid, rflags, 1, 0, 0, 0) + question
+    addr = hashlib.sha1(name.encode()).digest()[:2]
+    rr = b"\xc0\x0c" + struct.pack("!HHIH", 1, 1, ttl, 4) + bytes([10, 99]) + addr
+    return struct.pack("!HHHHHH", qid, rflags, 1, 1, 0, 0) + question + rr
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--bind", default="0.0.0.0")
+    ap.add_argument("--port", type=int, default=53)
+    ap.add_argument("--ttl", type=int, default=30)
+    ap.add_argument("--delay-ms", type=float, default=0.0, help="artificial upstream latency")
+    args = ap.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind((args.bind, args.port))
+    served = 0
+    print("stub resolver on %s:%d (ttl=%ds, delay=%.1fms)" % (args.bind, args.port, args.ttl, args.delay_ms))
+
+    def send_later(resp, addr):
+        time.sleep(args.delay_ms / 1000.0)
+        sock.sendto(resp, addr)
+
+    while True:
+        pkt, addr = sock.recvfrom(1024)
+        try:
+            resp = answer(pkt, args.ttl)
+        except (IndexError, struct.error):
+            continue
+        served += 1
+        if args.delay_ms > 0:
+            threading.Thread(target=send_later, args=(resp, addr), daemon=True).start()
+        else:
+            sock.sendto(resp, addr)
+        if served % 1000 == 0:
+            print("served %d" % served)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,194 @@
+#include "columnar_writer.h"
+
+#include <cstring>
+
+static const char FILE_MAGIC[8] = { 'E', 'S', 'P', 'C', 'O', 'L', '1', '\0' };
+// Largest record the reader accepts; a block of the default 8192 rows is
+// about 270 KB, so anything near this is a corrupt length field
+static const uint32_t MAX_RECORD_LEN = 64u << 20;
+
+ColumnarWriter::ColumnarWriter(size_t blockRows) : blockRows_(blockRows) {
+  recvUs_.reserve(blockRows_);
+  tsMs_.reserve(blockRows_);
+  topic_.reserve(blockRows_);
+  present_.reserve(blockRows_);
+  temp_.reserve(blockRows_);
+  light_.reserve(blockRows_);
+  humidity_.reserve(blockRows_);
+}
+
+ColumnarWriter::~ColumnarWriter() { close(); }
+
+bool ColumnarWriter::open(const char* path) {
+  f_ = fopen(path, "ab+");
+  if (!f_) return false;
+  setvbuf(f_, nullptr, _IOFBF, 1 << 20);
+  fseek(f_, 0, SEEK_END);
+  if (ftell(f_) == 0) {
+    fwrite(FILE_MAGIC, 1, sizeof(FILE_MAGIC), f_);
+    bytesWritten_ += sizeof(FILE_MAGIC);
+  }
+  // Topic ids are per file session: re-announce every topic we use, so
+  // appending to an existing file never depends on its old dictionary.
+  topicNames_.clear();
+  topicIds_.clear();
+  return true;
+}
+
+void ColumnarWriter::close() {
+  if (!f_) return;
+  flush();
+  fclose(f_);
+  f_ = nullptr;
+}
+
+uint16_t ColumnarWriter::topicId(std::string_view topic) {
+  auto it = topicIds_.find(topic);
+  if (it != topicIds_.end()) return it->second;
+
+  // Rows already buffered keep ids from this session, so the dictionary
+  // record can be written ahead of their block.
+  uint16_t id = (uint16_t)topicNames_.size();
+  topicNames_.emplace_back(topic);
+  const std::string& name = topicNames_.back();
+  topicIds_.emplace(std::string_view(name), id);
+
+  std::vector<uint8_t> rec(4 + name.size());
+  uint16_t len = (uint16_t)name.size();
+  memcpy(&rec[0], &id, 2);
+  memcpy(&rec[2], &len, 2);
+  memcpy(&rec[4], name.data(), name.size());
+  writeRecord(TAG_TOPIC, rec.data(), rec.size());
+  return id;
+}
+
+void ColumnarWriter::append(int64_t recvUs, std::string_view topic, const SensorSample& s) {
+  recvUs_.push_back(recvUs);
+  tsMs_.push_back((s.present & SensorSample::HAS_TS) ? s.tsMs : 0);
+  topic_.push_back(topicId(topic));
+  present_.push_back(s.present);
+  temp_.push_back(s.tempCenti);
+  light_.push_back(s.light);
+  humidity_.push_back(s.humidityCenti);
+  if (recvUs_.size() >= blockRows_) flush();
+}
+
+bool ColumnarWriter::writeRecord(uint32_t tag, const void* data, size_t len) {
+  if (!f_) return false;
+  uint32_t hdr[2] = { tag, (uint32_t)len };
+  bool ok = fwrite(hdr, sizeof(hdr), 1, f_) == 1 &&
+            (len == 0 || fwrite(data, len, 1, f_) == 1);
+  bytesWritten_ += sizeof(hdr) + len;
+  return ok;
+}
+
+bool ColumnarWriter::flush() {
+  if (!f_) return false;
+  uint32_t rows = (uint32_t)recvUs_.size();
+  if (rows == 0) return fflush(f_) == 0;
+
+  size_t len = 4 + rows * (2 * sizeof(int64_t) + sizeof(uint16_t) + sizeof(uint8_t) + 3 * sizeof(int32_t));
+  uint32_t hdr[2] = { TAG_BLOCK_TS, (uint32_t)len };
+  bool ok = fwrite(hdr, sizeof(hdr), 1, f_) == 1 &&
+            fwrite(&rows, 4, 1, f_) == 1 &&
+            fwrite(recvUs_.data(),   sizeof(int64_t),  rows, f_) == rows &&
+            fwrite(tsMs_.data(),     sizeof(int64_t),  rows, f_) == rows &&
+            fwrite(topic_.data(),    sizeof(uint16_t), rows, f_) == rows &&
+            fwrite(present_.data(),  sizeof(uint8_t),  rows, f_) == rows &&
+            fwrite(temp_.data(),     sizeof(int32_t),  rows, f_) == rows &&
+            fwrite(light_.data(),    sizeof(int32_t),  rows, f_) == rows &&
+            fwrite(humidity_.data(), sizeof(int32_t),  rows, f_) == rows;
+  ok = fflush(f_) == 0 && ok;
+
+  bytesWritten_ += sizeof(hdr) + len;
+  rowsWritten_ += rows;
+  recvUs_.clear();
+  tsMs_.clear();
+  topic_.clear();
+  present_.clear();
+  temp_.clear();
+  light_.clear();
+  humidity_.clear();
+  return ok;
+}
+
+long readColumnarFile(const char* path,
+                      const std::function<void(int64_t, const std::string&, const SensorSample&)>& fn) {
+  FILE* f = fopen(path, "rb");
+  if (!f) return -1;
+  char magic[8];
+  if (fread(magic, 1, 8, f) != 8 || memcmp(magic, FILE_MAGIC, 8) != 0) {
+    fclose(f);
+    return -1;
+  }
+
+  std::vector<std::string> topics;
+  std::vector<uint8_t> buf;
+  long rows = 0;
+  uint32_t hdr[2];
+  while (fread(hdr, sizeof(hdr), 1, f) == 1) {
+    if (hdr[1] > MAX_RECORD_LEN) {
+      rows = -2;
+      break;
+    }
+    buf.resize(hdr[1]);
+    if (hdr[1] && fread(buf.data(), hdr[1], 1, f) != 1) break;   // truncated tail
+
+    if (hdr[0] == ColumnarWriter::TAG_TOPIC) {
+      // Each writer session restarts ids at 0; a repeated id replaces the name
+      uint16_t id, len;
+      if (hdr[1] < 4) {
+        rows = -2;
+        break;
+      }
+      memcpy(&id, &buf[0], 2);
+      memcpy(&len, &buf[2], 2);
+      if (hdr[1] != 4u + len) {
+        rows = -2;
+        break;
+      }
+      if (topics.size() <= id) topics.resize(id + 1);
+      topics[id].assign((const char*)&buf[4], len);
+    } else if (hdr[0] == ColumnarWriter::TAG_BLOCK || hdr[0] == ColumnarWriter::TAG_BLOCK_TS) {
+      bool hasTs = hdr[0] == ColumnarWriter::TAG_BLOCK_TS;
+      uint32_t n;
+      if (hdr[1] < 4) {
+        rows = -2;
+        break;
+      }
+      memcpy(&n, &buf[0], 4);
+      uint64_t rowLen = (hasTs ? 2 : 1) * sizeof(int64_t) + sizeof(uint16_t) + sizeof(uint8_t) +
+                        3 * sizeof(int32_t);
+      if (4 + n * rowLen != hdr[1]) {
+        rows = -2;
+        break;
+      }
+      const uint8_t* p = &buf[4];
+      const uint8_t* recv = p;     p += n * sizeof(int64_t);
+      const uint8_t* ts = p;       if (hasTs) p += n * sizeof(int64_t);
+      const uint8_t* topic = p;    p += n * sizeof(uint16_t);
+      const uint8_t* present = p;  p += n;
+      const uint8_t* temp = p;     p += n * sizeof(int32_t);
+      const uint8_t* light = p;    p += n * sizeof(int32_t);
+      const uint8_t* hum = p;
+      for (uint32_t i = 0; i < n; ++i) {
+        int64_t us;
+        uint16_t tid;
+        SensorSample s;
+        memcpy(&us, recv + i * 8, 8);
+        memcpy(&tid, topic + i * 2, 2);
+        s.present = present[i];
+        if (hasTs) memcpy(&s.tsMs, ts + i * 8, 8);
+        else       s.present &= ~SensorSample::HAS_TS;
+        memcpy(&s.tempCenti, temp + i * 4, 4);
+        memcpy(&s.light, light + i * 4, 4);
+        memcpy(&s.humidityCenti, hum + i * 4, 4);
+        static const std::string unknown = "?";
+        fn(us, tid < topics.size() ? topics[tid] : unknown, s);
+        ++rows;
+      }
+    }
+  }
+  fclose(f);
+  return rows;
+}
@@ -0,0 +1,85 @@
+#ifndef COLUMNAR_WRITER_H
+#define COLUMNAR_WRITER_H
+
+// Append-only columnar sample log.
+//
+// File layout (little-endian):
+//   "ESPCOL1\0"                                  file magic
+//   records, each: u32 tag, u32 byteLen, payload
+//     'TOPC': u16 topicId, u16 len, topic bytes   topic dictionary entry
+//     'BLK2': u32 rows, then one contiguous column after another:
+//               i64 recvUs[rows]     receive time, µs since Unix epoch
+//               i64 tsMs[rows]       device acquisition time, ms since Unix
+//                                    epoch (valid if present has HAS_TS)
+//               u16 topicId[rows]
+//               u8  present[rows]    SensorSample::HAS_* bits
+//               i32 tempCenti[rows]
+//               i32 light[rows]
+//               i32 humidityCenti[rows]
+//     'BLCK': the same without the tsMs column (older files; still read)
+//
+// Rows are buffered per column and written as one block, so each append is
+// a handful of sequential writes regardless of message rate. A record that
+// is cut short at the end of the file by a crash is ignored by the reader;
+// one whose length does not match its contents stops it.
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "payload_parser.h"
+
+class ColumnarWriter {
+ public:
+  static const uint32_t TAG_TOPIC = 0x43504F54;   // "TOPC"
+  static const uint32_t TAG_BLOCK = 0x4B434C42;   // "BLCK", no device time
+  static const uint32_t TAG_BLOCK_TS = 0x324B4C42; // "BLK2"
+
+  explicit ColumnarWriter(size_t blockRows = 8192);
+  ~ColumnarWriter();
+
+  bool open(const char* path);
+  void close();
+
+  // `topic` only needs to stay valid for the duration of the call
+  void append(int64_t recvUs, std::string_view topic, const SensorSample& s);
+  bool flush();                       // writes buffered rows as one block
+
+  uint64_t rowsWritten() const { return rowsWritten_; }
+  uint64_t bytesWritten() const { return bytesWritten_; }
+  size_t   buffered() const { return recvUs_.size(); }
+
+ private:
+  uint16_t topicId(std::string_view topic);
+  bool     writeRecord(uint32_t tag, const void* data, size_t len);
+
+  FILE*    f_ = nullptr;
+  size_t   blockRows_;
+  uint64_t rowsWritten_ = 0;
+  uint64_t bytesWritten_ = 0;
+
+  // std::deque keeps the string storage stable for the views used as keys
+  std::deque<std::string>                        topicNames_;
+  std::unordered_map<std::string_view, uint16_t> topicIds_;
+
+  std::vector<int64_t>  recvUs_;
+  std::vector<int64_t>  tsMs_;
+  std::vector<uint16_t> topic_;
+  std::vector<uint8_t>  present_;
+  std::vector<int32_t>  temp_;
+  std::vector<int32_t>  light_;
+  std::vector<int32_t>  humidity_;
+};
+
+// Reads a file produced by ColumnarWriter; calls fn(recvUs, topic, sample)
+// for every row. Returns the number of rows, -1 if the file is not ours, or
+// -2 if a record is malformed (the rows before it have been delivered).
+long readColumnarFile(const char* path,
+                      const std::function<void(int64_t, const std::string&, const SensorSample&)>& fn);
+
+#endif // COLUMNAR_WRITER_H
@@ -0,0 +1,118 @@
+/*
+  Sensor payload encoder benchmark (host build, no broker)
+  --------------------------------------------------------
+  - Encodes the same fixed-point samples with telemetrySensorPayload()
+    (num_format.h, no printf) and with the previous snprintf("%.2f") encoder
+  - Checks both produce byte-identical payloads and that the fleet parser
+    reads back the original integers
+  - Reports ns per payload for each as JSON
+
+  format_bench                         # 1000000 payloads, with and without ts
+  format_bench --payloads 5000000
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "payload_parser.h"
+#include "telemetry.h"
+
+// ===================== CONFIGURATION =====================
+struct Options {
+  long payloads = 1000000;
+};
+
+// =================== Helper Functions ====================
+static double monoSec() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+struct Input {
+  int32_t  tempCenti;
+  int32_t  light;
+  int32_t  humidityCenti;
+  uint64_t tsMs;
+};
+
+// Values across the sensors' ranges, including negatives and edge digits
+static std::vector<Input> makeInputs(bool withTs) {
+  std::vector<Input> in;
+  uint32_t x = 12345;
+  for (int i = 0; i < 4096; ++i) {
+    x = x * 1103515245u + 12345u;
+    Input v;
+    v.tempCenti     = (int32_t)(x >> 8) % 8000 - 2000;     // -20.00 .. 59.99
+    v.light         = (int32_t)((x >> 4) % 100000);
+    v.humidityCenti = (int32_t)((x >> 12) % 10001);        // 0.00 .. 100.00
+    v.tsMs          = withTs ? 1700000000000ull + (uint64_t)i * 1000 : 0;
+    in.push_back(v);
+  }
+  in[0] = {0, 0, 0, in[0].tsMs};
+  in[1] = {-5, 9, 10000, in[1].tsMs};
+  in[2] = {-2000, 99999, 1, in[2].tsMs};
+  return in;
+}
+
+typedef int (*Encoder)(char*, size_t, int32_t, int32_t, int32_t, uint64_t);
+
+static uint64_t sink = 0;
+
+static double run(Encoder enc, const std::vector<Input>& in, long payloads) {
+  char buf[TELEMETRY_PAYLOAD_LEN];
+  double t0 = monoSec();
+  for (long i = 0; i < payloads; ++i) {
+    const Input& v = in[i & (in.size() - 1)];
+    sink += enc(buf, sizeof(buf), v.tempCenti, v.light, v.humidityCenti, v.tsMs) + buf[9];
+  }
+  return (monoSec() - t0) * 1e9 / payloads;
+}
+
+static bool agree(const std::vector<Input>& in) {
+  for (const Input& v : in) {
+    char a[TELEMETRY_PAYLOAD_LEN], b[TELEMETRY_PAYLOAD_LEN];
+    int la = telemetrySensorPayload(a, sizeof(a), v.tempCenti, v.light, v.humidityCenti, v.tsMs);
+    int lb = telemetrySensorPayloadPrintf(b, sizeof(b), v.tempCenti, v.light, v.humidityCenti, v.tsMs);
+    SensorSample s;
+    if (la != lb || strcmp(a, b) != 0 || !payload::parseSensorPayload(a, la, &s) ||
+        s.tempCenti != v.tempCenti || s.light != v.light || s.humidityCenti != v.humidityCenti ||
+        (uint64_t)s.tsMs != v.tsMs) {
+      fprintf(stderr, "mismatch: %s vs %s\n", a, b);
+      return false;
+    }
+  }
+  return true;
+}
+
+// ========================= MAIN ===========================
+int main(int argc, char** argv) {
+  Options opt;
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    if (a == "--payloads" && i + 1 < argc) opt.payloads = atol(argv[++i]);
+    else {
+      fprintf(stderr, "usage: %s [--payloads N]\n", argv[0]);
+      return 64;
+    }
+  }
+
+  int rc = 0;
+  printf("{\n  \"payloads\": %ld,\n  \"runs\": [\n", opt.payloads);
+  for (int withTs = 0; withTs < 2; ++withTs) {
+    std::vector<Input> in = makeInputs(withTs);
+    bool same = agree(in);
+    if (!same) rc = 1;
+    double fast = run(telemetrySensorPayload, in, opt.payloads);
+    double printf_ = run(telemetrySensorPayloadPrintf, in, opt.payloads);
+    printf("    {\"ts\": %s, \"fixed_ns\": %.1f, \"snprintf_ns\": %.1f, \"speedup\": %.1f, "
+           "\"identical\": %s}%s\n",
+           withTs ? "true" : "false", fast, printf_, printf_ / fast, same ? "true" : "false",
+           withTs ? "" : ",");
+  }
+  printf("  ],\n  \"checksum\": %llu\n}\n", (unsigned long long)sink);
+  return rc;
+}
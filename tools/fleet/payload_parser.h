@@ -0,0 +1,258 @@
+#ifndef PAYLOAD_PARSER_H
+#define PAYLOAD_PARSER_H
+
+// Zero-copy parser for the firmware's sensor payloads, e.g.
+//   {"temp":25.00,"light":500,"humidity":60.00,"ts":1700000000000}
+// and batches (base time + deltas, one array per field):
+//   {"t0":1700000000000,"dt":[0,1000],"temp":[25.00,25.01],"light":[500,501],
+//    "humidity":[60.00,60.02]}
+// Numbers are decoded straight out of the receive buffer into scaled
+// integers (temperature and humidity in hundredths); nothing is allocated
+// and the payload is not required to be NUL-terminated.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+struct SensorSample {
+  enum : uint8_t { HAS_TEMP = 1, HAS_LIGHT = 2, HAS_HUMIDITY = 4, HAS_TS = 8 };
+  uint8_t present = 0;
+  int32_t tempCenti = 0;
+  int32_t light = 0;
+  int32_t humidityCenti = 0;
+  int64_t tsMs = 0;           // device acquisition time, ms since Unix epoch
+};
+
+#define PAYLOAD_BATCH_MAX 64
+
+struct SensorBatch {
+  size_t       n = 0;
+  SensorSample rows[PAYLOAD_BATCH_MAX];
+};
+
+namespace payload {
+
+inline const char* skipWs(const char* p, const char* end) {
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
+  return p;
+}
+
+// Parses a JSON number as a fixed-point value with two decimals (rounded).
+// Returns the position after the number or nullptr if there is none.
+inline const char* parseCenti(const char* p, const char* end, int32_t* out) {
+  bool neg = false;
+  if (p < end && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+  if (p >= end || *p < '0' || *p > '9') return nullptr;
+  int64_t whole = 0;
+  while (p < end && *p >= '0' && *p <= '9') whole = whole * 10 + (*p++ - '0');
+  int32_t frac = 0;
+  if (p < end && *p == '.') {
+    ++p;
+    int digits = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+      if (digits < 3) frac = frac * 10 + (*p - '0');
+      ++digits;
+      ++p;
+    }
+    for (; digits < 3; ++digits) frac *= 10;    // frac in thousandths
+    frac = (frac + 5) / 10;
+  }
+  if (p < end && (*p == 'e' || *p == 'E')) return nullptr;   // not produced by firmware
+  int64_t v = whole * 100 + frac;
+  *out = (int32_t)(neg ? -v : v);
+  return p;
+}
+
+inline const char* parseInt64(const char* p, const char* end, int64_t* out) {
+  bool neg = p < end && *p == '-';
+  if (neg) ++p;
+  if (p >= end || *p < '0' || *p > '9') return nullptr;
+  int64_t v = 0;
+  while (p < end && *p >= '0' && *p <= '9') v = v * 10 + (*p++ - '0');
+  *out = neg ? -v : v;
+  return p;
+}
+
+// Skips any JSON value we do not care about (string, number, literal,
+// nested object/array). Returns nullptr on malformed input.
+inline const char* skipValue(const char* p, const char* end) {
+  if (p >= end) return nullptr;
+  if (*p == '"') {
+    for (++p; p < end; ++p) {
+      if (*p == '\\') { ++p; continue; }
+      if (*p == '"') return p + 1;
+    }
+    return nullptr;
+  }
+  if (*p == '{' || *p == '[') {
+    int depth = 0;
+    bool inStr = false;
+    for (; p < end; ++p) {
+      if (inStr) {
+        if (*p == '\\') ++p;
+        else if (*p == '"') inStr = false;
+        continue;
+      }
+      if (*p == '"') inStr = true;
+      else if (*p == '{' || *p == '[') ++depth;
+      else if ((*p == '}' || *p == ']') && --depth == 0) return p + 1;
+    }
+    return nullptr;
+  }
+  while (p < end && *p != ',' && *p != '}' && *p != ']') ++p;
+  return p;
+}
+
+// Parses a JSON array, calling elem(p, end, index) for each element; elem
+// returns the position after the element or nullptr. Elements past `max`
+// are skipped. Returns the position after ']' (count in *n) or nullptr.
+template <typename Elem>
+inline const char* parseArray(const char* p, const char* end, size_t max, size_t* n, Elem elem) {
+  *n = 0;
+  if (p >= end || *p++ != '[') return nullptr;
+  p = skipWs(p, end);
+  if (p < end && *p == ']') return p + 1;
+  for (;;) {
+    p = skipWs(p, end);
+    p = *n < max ? elem(p, end, *n) : skipValue(p, end);
+    if (!p) return nullptr;
+    if (*n < max) ++*n;
+    p = skipWs(p, end);
+    if (p < end && *p == ',') { ++p; continue; }
+    if (p < end && *p == ']') return p + 1;
+    return nullptr;
+  }
+}
+
+inline bool keyIs(const char* k, size_t len, const char* lit) {
+  return len == strlen(lit) && memcmp(k, lit, len) == 0;
+}
+
+// Fills `s` from a flat JSON object. Unknown keys are skipped; returns false
+// if the payload is not a JSON object.
+inline bool parseSensorPayload(const void* data, size_t len, SensorSample* s) {
+  const char* p = static_cast<const char*>(data);
+  const char* end = p + len;
+  *s = SensorSample();
+
+  p = skipWs(p, end);
+  if (p >= end || *p++ != '{') return false;
+  for (;;) {
+    p = skipWs(p, end);
+    if (p < end && *p == '}') return true;
+    if (p >= end || *p != '"') return false;
+    const char* key = ++p;
+    while (p < end && *p != '"') ++p;
+    if (p >= end) return false;
+    size_t keyLen = p - key;
+    p = skipWs(p + 1, end);
+    if (p >= end || *p++ != ':') return false;
+    p = skipWs(p, end);
+
+    const char* next = nullptr;
+    int32_t v = 0;
+    if (keyIs(key, keyLen, "temp") || keyIs(key, keyLen, "temperature")) {
+      if ((next = parseCenti(p, end, &v))) { s->tempCenti = v; s->present |= SensorSample::HAS_TEMP; }
+    } else if (keyIs(key, keyLen, "light")) {
+      if ((next = parseCenti(p, end, &v))) { s->light = v / 100; s->present |= SensorSample::HAS_LIGHT; }
+    } else if (keyIs(key, keyLen, "humidity")) {
+      if ((next = parseCenti(p, end, &v))) { s->humidityCenti = v; s->present |= SensorSample::HAS_HUMIDITY; }
+    } else if (keyIs(key, keyLen, "ts")) {
+      if ((next = parseInt64(p, end, &s->tsMs))) s->present |= SensorSample::HAS_TS;
+    }
+    p = next ? next : skipValue(p, end);
+    if (!p) return false;
+
+    p = skipWs(p, end);
+    if (p < end && *p == ',') { ++p; continue; }
+    return p < end && *p == '}';
+  }
+}
+
+// Fills `b` from a batch payload; row i gets ts = t0 + dt[0..i] (HAS_TS
+// only if "t0" is present) and a field's HAS_* bit if its array reaches
+// that row. Unknown keys are skipped; returns false if the payload is not a
+// JSON object or an array element is not a number.
+inline bool parseBatchPayload(const void* data, size_t len, SensorBatch* b) {
+  const char* p = static_cast<const char*>(data);
+  const char* end = p + len;
+  b->n = 0;
+  int64_t t0 = 0;
+  bool hasT0 = false;
+  int64_t dt[PAYLOAD_BATCH_MAX];
+  size_t nDt = 0, nTemp = 0, nLight = 0, nHum = 0;
+  SensorSample* rows = b->rows;
+
+  p = skipWs(p, end);
+  if (p >= end || *p++ != '{') return false;
+  for (;;) {
+    p = skipWs(p, end);
+    if (p < end && *p == '}') break;
+    if (p >= end || *p != '"') return false;
+    const char* key = ++p;
+    while (p < end && *p != '"') ++p;
+    if (p >= end) return false;
+    size_t keyLen = p - key;
+    p = skipWs(p + 1, end);
+    if (p >= end || *p++ != ':') return false;
+    p = skipWs(p, end);
+
+    if (keyIs(key, keyLen, "t0")) {
+      p = parseInt64(p, end, &t0);
+      hasT0 = p != nullptr;
+    } else if (keyIs(key, keyLen, "dt")) {
+      p = parseArray(p, end, PAYLOAD_BATCH_MAX, &nDt,
+                     [&](const char* q, const char* e, size_t i) { return parseInt64(q, e, &dt[i]); });
+    } else if (keyIs(key, keyLen, "temp")) {
+      p = parseArray(p, end, PAYLOAD_BATCH_MAX, &nTemp,
+                     [&](const char* q, const char* e, size_t i) { return parseCenti(q, e, &rows[i].tempCenti); });
+    } else if (keyIs(key, keyLen, "light")) {
+      p = parseArray(p, end, PAYLOAD_BATCH_MAX, &nLight, [&](const char* q, const char* e, size_t i) {
+        int32_t v;
+        q = parseCenti(q, e, &v);
+        if (q) rows[i].light = v / 100;
+        return q;
+      });
+    } else if (keyIs(key, keyLen, "humidity")) {
+      p = parseArray(p, end, PAYLOAD_BATCH_MAX, &nHum,
+                     [&](const char* q, const char* e, size_t i) { return parseCenti(q, e, &rows[i].humidityCenti); });
+    } else {
+      p = skipValue(p, end);
+    }
+    if (!p) return false;
+
+    p = skipWs(p, end);
+    if (p < end && *p == ',') { ++p; continue; }
+    if (p < end && *p == '}') break;
+    return false;
+  }
+
+  size_t n = nDt;
+  if (nTemp > n) n = nTemp;
+  if (nLight > n) n = nLight;
+  if (nHum > n) n = nHum;
+  int64_t ts = t0;
+  for (size_t i = 0; i < n; ++i) {
+    SensorSample& s = rows[i];
+    s.present = 0;
+    if (i < nTemp)  s.present |= SensorSample::HAS_TEMP;
+    if (i < nLight) s.present |= SensorSample::HAS_LIGHT;
+    if (i < nHum)   s.present |= SensorSample::HAS_HUMIDITY;
+    if (hasT0 && i < nDt) {
+      ts += dt[i];
+      s.tsMs = ts;
+      s.present |= SensorSample::HAS_TS;
+    } else {
+      s.tsMs = 0;
+    }
+    if (!(s.present & SensorSample::HAS_TEMP)) s.tempCenti = 0;
+    if (!(s.present & SensorSample::HAS_LIGHT)) s.light = 0;
+    if (!(s.present & SensorSample::HAS_HUMIDITY)) s.humidityCenti = 0;
+  }
+  b->n = n;
+  return true;
+}
+
+} // namespace payload
+
+#endif // PAYLOAD_PARSER_H
@@ -0,0 +1,247 @@
+/*
+  Report-by-exception simulator (host build, no broker)
+  -----------------------------------------------------
+  - Replays synthetic 1 Hz sensor traces through the firmware's
+    ReportFilter (report_filter.h) and through plain every-sample publishing
+  - Counts MQTT PUBLISH messages and bytes (fixed header + topic + the
+    telemetry.h payload) for both and reports the savings
+  - Tracks how far the last reported value strays from the true one per
+    channel, and how long after a step change it is reported
+  - Scenarios: steady (night, flat), diurnal (day cycle, passing clouds),
+    events (diurnal plus vents, grow lights and misting) and noise (the
+    firmware's unfiltered random sensors, the worst case)
+
+  rbe_sim                                  # 24 h per scenario, firmware defaults
+  rbe_sim --hours 168 --heartbeat 300000 --temp-db 10
+  rbe_sim --scenario events --min-interval 5000
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "report_filter.h"
+#include "telemetry.h"
+
+// ===================== CONFIGURATION =====================
+struct Options {
+  double      hours = 24;
+  std::string scenario;            // empty = all
+  unsigned    seed = 1;
+  // Defaults match REPORT_CONFIG in src/main.cpp
+  ReportConfig report = { true, { { 20, 0 }, { 10, 50 }, { 50, 0 } }, 0, 60000 };
+};
+
+static const uint32_t SAMPLE_MS = 1000;   // PUBLISH_INTERVAL_MS
+static const uint64_t EPOCH_MS  = 1700000000000ull;
+static const double   DAY_S     = 86400.0;
+static const double   PI        = 3.14159265358979323846;
+
+// =================== Helper Functions ====================
+struct Reading {
+  int32_t v[REPORT_CHANNELS];
+  bool    step;                    // a step change starts at this sample
+};
+
+// Size on the wire of a QoS 0 PUBLISH: fixed header, remaining length,
+// topic (length-prefixed) and payload
+static size_t publishBytes(size_t topicLen, size_t payloadLen) {
+  size_t rem = 2 + topicLen + payloadLen;
+  size_t lenBytes = rem < 128 ? 1 : rem < 16384 ? 2 : 3;
+  return 1 + lenBytes + rem;
+}
+
+static int32_t centi(double x) { return (int32_t)std::lround(x * 100.0); }
+
+// Daylight 0..1, peaking at noon
+static double daylight(double t) {
+  return std::max(0.0, std::sin(2 * PI * (t / DAY_S - 0.25)));
+}
+
+class Trace {
+ public:
+  Trace(const std::string& name, unsigned seed) : name_(name), rng_(seed) {}
+
+  Reading next(double t) {
+    Reading r = {};
+    if (name_ == "noise") {            // sampleSensors() without the filter chains
+      std::uniform_int_distribution<int> temp(20, 30), light(400, 600), hum(50, 70);
+      r.v[0] = temp(rng_) * 100;
+      r.v[1] = light(rng_);
+      r.v[2] = hum(rng_) * 100;
+      return r;
+    }
+    double temp = 21.5, light = 0, hum = 60.0;
+    if (name_ != "steady") {
+      double day = -std::cos(2 * PI * t / DAY_S);     // -1 at midnight, 1 at noon
+      cloud_ = std::min(1.0, std::max(0.3, cloud_ + gauss(0.01)));
+      temp = 24 + 5 * day;
+      hum  = 65 - 12 * day;
+      light = 45000 * daylight(t) * cloud_;
+    }
+    if (name_ == "events") {
+      if (t >= nextEvent_) {
+        kind_ = (int)(rng_() % 3);
+        eventEnd_ = t + 300 + rng_() % 900;
+        nextEvent_ = eventEnd_ + 600 + rng_() % 2400;
+      }
+      bool on = t < eventEnd_;
+      r.step = on != wasOn_;                            // an event starts or ends
+      wasOn_ = on;
+      double tau = on ? 20.0 : 60.0;                    // vents act fast, recovery is slower
+      double target[3] = { kind_ == 0 && on ? -3.0 : 0.0,
+                           kind_ == 1 && on ? 15000.0 : 0.0,
+                           kind_ == 2 && on ? 15.0 : 0.0 };
+      for (int i = 0; i < 3; ++i) offset_[i] += (target[i] - offset_[i]) / tau;
+      if (kind_ == 1) offset_[1] = target[1];           // lights switch, no ramp
+      temp += offset_[0];
+      light += offset_[1];
+      hum += offset_[2];
+    }
+    // Sensor noise after the firmware's filter chains
+    r.v[0] = centi(temp + gauss(0.03));
+    r.v[1] = std::max(0, (int32_t)std::lround(light * (1 + gauss(0.01)) + gauss(2)));
+    r.v[2] = centi(hum + gauss(0.1));
+    return r;
+  }
+
+ private:
+  double gauss(double sigma) { return std::normal_distribution<double>(0, sigma)(rng_); }
+
+  std::string  name_;
+  std::mt19937 rng_;
+  double       cloud_ = 1.0;
+  double       nextEvent_ = 1800;
+  double       eventEnd_ = 0;
+  int          kind_ = 0;
+  bool         wasOn_ = false;
+  double       offset_[3] = {};
+};
+
+struct Result {
+  uint64_t samples = 0;
+  uint64_t baseMessages = 0, baseBytes = 0;
+  uint64_t rbeMessages = 0, rbeBytes = 0;
+  ReportStats stats = {};
+  int32_t  maxError[REPORT_CHANNELS] = {};
+  double   sumError[REPORT_CHANNELS] = {};
+  uint32_t steps = 0;
+  double   maxStepLatencyS = 0;
+};
+
+static Result simulate(const std::string& scenario, const Options& opt) {
+  char topic[TELEMETRY_TOPIC_LEN], payload[TELEMETRY_PAYLOAD_LEN];
+  size_t topicLen = telemetryTopic(topic, sizeof(topic), MQTT_SITE, MQTT_ZONE, "esp32-a1b2c3",
+                                   TELEMETRY_CHANNEL_SENSORS);
+  Trace trace(scenario, opt.seed);
+  ReportFilter filter(opt.report);
+  Result res;
+  int32_t reported[REPORT_CHANNELS] = {};
+  double stepAt = -1;                  // pending step change, waiting for its report
+
+  uint64_t n = (uint64_t)(opt.hours * 3600.0 * 1000.0 / SAMPLE_MS);
+  for (uint64_t i = 0; i < n; ++i) {
+    double t = i * (SAMPLE_MS / 1000.0);
+    uint32_t ms = (uint32_t)(i * SAMPLE_MS);
+    Reading r = trace.next(t);
+    if (r.step && stepAt < 0) stepAt = t;
+    size_t len = (size_t)telemetrySensorPayload(payload, sizeof(payload), r.v[0], r.v[1], r.v[2],
+                                                EPOCH_MS + i * SAMPLE_MS);
+    size_t bytes = publishBytes(topicLen, len);
+    res.samples++;
+    res.baseMessages++;
+    res.baseBytes += bytes;
+    if (filter.check(r.v, ms) != REPORT_SUPPRESSED) {
+      res.rbeMessages++;
+      res.rbeBytes += bytes;
+      memcpy(reported, r.v, sizeof(reported));
+      if (stepAt >= 0) {
+        res.steps++;
+        res.maxStepLatencyS = std::max(res.maxStepLatencyS, t - stepAt);
+        stepAt = -1;
+      }
+    }
+    for (int c = 0; c < REPORT_CHANNELS; ++c) {
+      int32_t e = std::abs(r.v[c] - reported[c]);
+      res.maxError[c] = std::max(res.maxError[c], e);
+      res.sumError[c] += e;
+    }
+  }
+  res.stats = filter.stats();
+  return res;
+}
+
+static void usage(const char* argv0) {
+  fprintf(stderr,
+          "usage: %s [--hours H] [--scenario steady|diurnal|events|noise] [--seed N]\n"
+          "          [--min-interval MS] [--heartbeat MS] [--temp-db CENTI] [--humidity-db CENTI]\n"
+          "          [--light-db COUNTS] [--light-pct TENTHS] [--off]\n", argv0);
+}
+
+// ========================= MAIN ===========================
+int main(int argc, char** argv) {
+  Options opt;
+  ReportConfig& rc = opt.report;
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    bool more = i + 1 < argc;
+    if (a == "--hours" && more)             opt.hours = atof(argv[++i]);
+    else if (a == "--scenario" && more)     opt.scenario = argv[++i];
+    else if (a == "--seed" && more)         opt.seed = (unsigned)atoi(argv[++i]);
+    else if (a == "--min-interval" && more) rc.minIntervalMs = (uint32_t)atol(argv[++i]);
+    else if (a == "--heartbeat" && more)    rc.maxIntervalMs = (uint32_t)atol(argv[++i]);
+    else if (a == "--temp-db" && more)      rc.deadband[0].abs = atoi(argv[++i]);
+    else if (a == "--light-db" && more)     rc.deadband[1].abs = atoi(argv[++i]);
+    else if (a == "--light-pct" && more)    rc.deadband[1].pct = (uint16_t)atoi(argv[++i]);
+    else if (a == "--humidity-db" && more)  rc.deadband[2].abs = atoi(argv[++i]);
+    else if (a == "--off")                  rc.enabled = false;
+    else {
+      usage(argv[0]);
+      return 64;
+    }
+  }
+
+  std::vector<std::string> scenarios = { "steady", "diurnal", "events", "noise" };
+  if (!opt.scenario.empty()) {
+    if (std::find(scenarios.begin(), scenarios.end(), opt.scenario) == scenarios.end()) {
+      usage(argv[0]);
+      return 64;
+    }
+    scenarios = { opt.scenario };
+  }
+
+  printf("{\n  \"hours\": %g,\n  \"config\": {\"enabled\": %s, \"temp_db\": %.2f, \"light_db\": %d, "
+         "\"light_pct\": %.1f, \"humidity_db\": %.2f, \"min_interval_ms\": %u, \"heartbeat_ms\": %u},\n"
+         "  \"scenarios\": [\n",
+         opt.hours, rc.enabled ? "true" : "false", rc.deadband[0].abs / 100.0, (int)rc.deadband[1].abs,
+         rc.deadband[1].pct / 10.0, rc.deadband[2].abs / 100.0, (unsigned)rc.minIntervalMs,
+         (unsigned)rc.maxIntervalMs);
+  for (size_t s = 0; s < scenarios.size(); ++s) {
+    Result r = simulate(scenarios[s], opt);
+    double n = r.samples ? (double)r.samples : 1.0;
+    printf("    {\"name\": \"%s\", \"samples\": %llu,\n"
+           "     \"every_sample\": {\"messages\": %llu, \"bytes\": %llu, \"bytes_per_hour\": %.0f},\n"
+           "     \"rbe\": {\"messages\": %llu, \"bytes\": %llu, \"bytes_per_hour\": %.0f, \"suppressed\": %u, "
+           "\"heartbeats\": %u, \"held\": %u},\n"
+           "     \"saved_messages\": %.4f, \"saved_bytes\": %.4f,\n"
+           "     \"error\": {\"temp_max\": %.2f, \"temp_avg\": %.3f, \"light_max\": %d, \"light_avg\": %.1f, "
+           "\"humidity_max\": %.2f, \"humidity_avg\": %.3f},\n"
+           "     \"steps\": %u, \"step_latency_max_s\": %.0f}%s\n",
+           scenarios[s].c_str(), (unsigned long long)r.samples,
+           (unsigned long long)r.baseMessages, (unsigned long long)r.baseBytes, r.baseBytes / opt.hours,
+           (unsigned long long)r.rbeMessages, (unsigned long long)r.rbeBytes, r.rbeBytes / opt.hours,
+           (unsigned)r.stats.suppressed, (unsigned)r.stats.heartbeats, (unsigned)r.stats.held,
+           1.0 - (double)r.rbeMessages / (r.baseMessages ? r.baseMessages : 1),
+           1.0 - (double)r.rbeBytes / (r.baseBytes ? r.baseBytes : 1),
+           r.maxError[0] / 100.0, r.sumError[0] / n / 100.0, (int)r.maxError[1], r.sumError[1] / n,
+           r.maxError[2] / 100.0, r.sumError[2] / n / 100.0,
+           (unsigned)r.steps, r.maxStepLatencyS, s + 1 < scenarios.size() ? "," : "");
+  }
+  printf("  ]\n}\n");
+  return 0;
+}
@@ -0,0 +1,209 @@
+/*
+  Topic router benchmark (host build, no broker)
+  ----------------------------------------------
+  - Builds a subscription set like a large fleet's: one exact
+    site/zone/device/sensors filter per device plus a few wildcard filters
+    (+/+/+/status, site/+/+/sensors, site/zone3/#)
+  - Dispatches a precomputed mix of sensor and status topics through the
+    TopicRouter trie and through a linear scan that tests every filter
+  - Checks both deliver the same number of matches and reports throughput
+    per subscription count as JSON
+
+  router_bench                          # 100, 1000, 10000 subscriptions
+  router_bench --subs 5000 --messages 2000000
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "payload_parser.h"
+#include "telemetry.h"
+#include "topic_router.h"
+
+// ===================== CONFIGURATION =====================
+struct Options {
+  std::vector<long> subs;
+  long messages = 1000000;
+  bool typed = false;         // parse payloads in the handlers too
+};
+
+// =================== Helper Functions ====================
+static double monoSec() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Reference MQTT matcher, one filter at a time (what a subscriber without
+// a router does for every message)
+static bool filterMatches(const char* f, const char* t) {
+  if (*t == '$' && (*f == '+' || *f == '#')) return false;
+  for (;;) {
+    if (*f == '#') return true;
+    if (*f == '+') {
+      while (*t && *t != '/') ++t;
+      ++f;
+    } else {
+      while (*f && *f != '/' && *f == *t) { ++f; ++t; }
+      if ((*f && *f != '/') || (*t && *t != '/')) return false;
+    }
+    if (!*f && !*t) return true;
+    if (*f == '/' && *t == '/') { ++f; ++t; continue; }
+    // "a/#" also matches "a"
+    return !*t && f[0] == '/' && f[1] == '#' && !f[2];
+  }
+}
+
+static uint64_t hits = 0;
+static uint64_t checksum = 0;
+
+static void countRaw(const TopicMessage& msg, void*) {
+  hits++;
+  checksum += msg.len;
+}
+
+static void countSensor(const TopicMessage&, const SensorSample& s, void*) {
+  hits++;
+  checksum += s.light;
+}
+
+struct Fleet {
+  std::vector<std::string> filters;
+  std::vector<std::string> topics;    // message stream, cycled
+  std::string payload;
+};
+
+static Fleet makeFleet(long devices, long messages) {
+  Fleet f;
+  char buf[TELEMETRY_TOPIC_LEN];
+  char id[TELEMETRY_ID_LEN];
+  auto device = [&](long i) {
+    uint8_t mac[6] = {0x24, 0x0a, 0xc4, (uint8_t)(i >> 16), (uint8_t)(i >> 8), (uint8_t)i};
+    telemetryDeviceId(mac, id, sizeof(id));
+    return id;
+  };
+  auto zone = [](long i) { return "zone" + std::to_string(i % 16); };
+
+  for (long i = 0; i < devices; ++i) {
+    telemetryTopic(buf, sizeof(buf), MQTT_SITE, zone(i).c_str(), device(i), TELEMETRY_CHANNEL_SENSORS);
+    f.filters.push_back(buf);
+  }
+  f.filters.push_back("+/+/+/" TELEMETRY_CHANNEL_STATUS);
+  f.filters.push_back(MQTT_SITE "/+/+/" TELEMETRY_CHANNEL_SENSORS);
+  f.filters.push_back(MQTT_SITE "/zone3/#");
+
+  // 4 of 5 messages are sensor samples, the rest status; a few unknown devices
+  long distinct = messages < 65536 ? messages : 65536;
+  for (long i = 0; i < distinct; ++i) {
+    long d = (i * 7919) % (devices + devices / 10 + 1);
+    const char* channel = i % 5 == 4 ? TELEMETRY_CHANNEL_STATUS : TELEMETRY_CHANNEL_SENSORS;
+    telemetryTopic(buf, sizeof(buf), MQTT_SITE, zone(d).c_str(), device(d), channel);
+    f.topics.push_back(buf);
+  }
+  char payload[TELEMETRY_PAYLOAD_LEN];
+  telemetrySensorPayload(payload, sizeof(payload), 2500, 512, 6150, 0);
+  f.payload = payload;
+  return f;
+}
+
+// ===================== Benchmarks ========================
+struct Result {
+  double   buildMs;
+  double   secs;
+  uint64_t matches;
+};
+
+static Result runTrie(const Fleet& f, long messages, bool typed, size_t* nodes) {
+  Result r;
+  double t0 = monoSec();
+  TopicRouter router;
+  for (const std::string& filter : f.filters) {
+    if (typed) router.add<SensorSample, payload::parseSensorPayload>(filter.c_str(), countSensor, nullptr);
+    else       router.add(filter.c_str(), countRaw, nullptr);
+  }
+  r.buildMs = (monoSec() - t0) * 1000.0;
+  *nodes = router.nodes();
+
+  hits = 0;
+  t0 = monoSec();
+  for (long i = 0; i < messages; ++i) {
+    const std::string& topic = f.topics[i % f.topics.size()];
+    router.dispatch(topic.data(), topic.size(), f.payload.data(), f.payload.size());
+  }
+  r.secs = monoSec() - t0;
+  r.matches = hits;
+  return r;
+}
+
+static Result runLinear(const Fleet& f, long messages, bool typed) {
+  Result r = {0, 0, 0};
+  hits = 0;
+  double t0 = monoSec();
+  for (long i = 0; i < messages; ++i) {
+    const std::string& topic = f.topics[i % f.topics.size()];
+    TopicMessage msg{topic, f.payload.data(), f.payload.size()};
+    for (const std::string& filter : f.filters) {
+      if (!filterMatches(filter.c_str(), topic.c_str())) continue;
+      if (typed) {
+        SensorSample s;
+        if (payload::parseSensorPayload(msg.payload, msg.len, &s)) countSensor(msg, s, nullptr);
+      } else {
+        countRaw(msg, nullptr);
+      }
+    }
+  }
+  r.secs = monoSec() - t0;
+  r.matches = hits;
+  return r;
+}
+
+// ========================= MAIN ===========================
+int main(int argc, char** argv) {
+  Options opt;
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    if      (a == "--subs" && i + 1 < argc) opt.subs.push_back(atol(argv[++i]));
+    else if (a == "--messages" && i + 1 < argc) opt.messages = atol(argv[++i]);
+    else if (a == "--typed") opt.typed = true;
+    else {
+      fprintf(stderr, "usage: %s [--subs N]... [--messages M] [--typed]\n", argv[0]);
+      return 64;
+    }
+  }
+  if (opt.subs.empty()) opt.subs = {100, 1000, 10000};
+
+  int rc = 0;
+  printf("{\n  \"messages\": %ld,\n  \"typed\": %s,\n  \"runs\": [\n", opt.messages,
+         opt.typed ? "true" : "false");
+  for (size_t k = 0; k < opt.subs.size(); ++k) {
+    Fleet f = makeFleet(opt.subs[k], opt.messages);
+    size_t nodes = 0;
+    Result trie = runTrie(f, opt.messages, opt.typed, &nodes);
+    // The linear scan is O(subscriptions) per message; cap its run time
+    long linearMsgs = opt.messages;
+    if ((double)linearMsgs * f.filters.size() > 2e9) linearMsgs = (long)(2e9 / f.filters.size());
+    Result lin = runLinear(f, linearMsgs, opt.typed);
+    uint64_t trieMatchesScaled = trie.matches;
+    if (linearMsgs != opt.messages) {
+      // Compare on the same prefix of the stream
+      Result check = runTrie(f, linearMsgs, opt.typed, &nodes);
+      trieMatchesScaled = check.matches;
+    }
+    bool same = trieMatchesScaled == lin.matches;
+    if (!same) rc = 1;
+    double trieRate = opt.messages / trie.secs;
+    double linRate = linearMsgs / lin.secs;
+    printf("    {\"subscriptions\": %zu, \"trie_nodes\": %zu, \"build_ms\": %.2f, "
+           "\"trie_msgs_per_s\": %.0f, \"trie_ns_per_msg\": %.1f, "
+           "\"linear_msgs_per_s\": %.0f, \"linear_ns_per_msg\": %.1f, "
+           "\"speedup\": %.1f, \"matches_per_msg\": %.3f, \"matches_agree\": %s}%s\n",
+           f.filters.size(), nodes, trie.buildMs, trieRate, 1e9 / trieRate, linRate, 1e9 / linRate,
+           trieRate / linRate, (double)trie.matches / opt.messages, same ? "true" : "false",
+           k + 1 < opt.subs.size() ? "," : "");
+  }
+  printf("  ],\n  \"checksum\": %llu\n}\n", (unsigned long long)checksum);
+  return rc;
+}
@@ -0,0 +1,386 @@
+/*
+  Fleet-side MQTT ingest tool (Linux)
+  -----------------------------------
+  - Subscribes to the fleet topics +/+/+/sensors, +/+/+/batch, +/+/+/status
+    and the legacy esp32/sensor/data (or any topics / wildcards given with -t)
+  - Routes messages through a prebuilt topic trie (topic_router.h) to typed
+    handlers that parse in place from the receive buffer (no copies)
+  - Appends samples to a columnar file (see columnar_writer.h)
+  - --dump prints a columnar file back as CSV
+  - --bench runs simulated publishers against a local broker and reports
+    sustained ingest throughput as JSON
+
+  subscriber -h localhost -t 'esp32/sensor/#' -o samples.col
+  subscriber --bench --publishers 8 --messages 50000 -o /tmp/bench.col
+*/
+
+#include <mosquitto.h>
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "columnar_writer.h"
+#include "payload_parser.h"
+#include "telemetry.h"
+#include "topic_router.h"
+
+// ===================== CONFIGURATION =====================
+struct Options {
+  std::string host = "localhost";
+  int         port = 1883;
+  int         qos = 0;
+  std::vector<std::string> topics;
+  std::string outPath = "samples.col";
+  std::string dumpPath;
+  bool        bench = false;
+  int         publishers = 4;
+  long        messages = 25000;     // per publisher
+};
+
+// ===================== GLOBALS ============================
+static volatile std::sig_atomic_t stopRequested = 0;
+
+struct Ingest {
+  ColumnarWriter writer;
+  uint64_t received = 0;
+  uint64_t unrouted = 0;       // matched no handler
+  uint64_t payloadBytes = 0;
+  uint64_t batches = 0;        // batch payloads (several samples each)
+  uint64_t online = 0;         // status messages
+  uint64_t offline = 0;
+};
+
+// =================== Helper Functions ====================
+static int64_t wallUs() {
+  using namespace std::chrono;
+  return duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+static double monoSec() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+static void onSignal(int) { stopRequested = 1; }
+
+static void usage(const char* argv0) {
+  fprintf(stderr,
+          "usage: %s [-h host] [-p port] [-q qos] [-t topic]... [-o file]\n"
+          "       %s --dump file\n"
+          "       %s --bench [--publishers N] [--messages M] [-h host] [-o file]\n",
+          argv0, argv0, argv0);
+}
+
+static bool parseArgs(int argc, char** argv, Options& opt) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+    const char* v = nullptr;
+    if      (a == "-h" && (v = next())) opt.host = v;
+    else if (a == "-p" && (v = next())) opt.port = atoi(v);
+    else if (a == "-q" && (v = next())) opt.qos = atoi(v);
+    else if (a == "-t" && (v = next())) opt.topics.push_back(v);
+    else if (a == "-o" && (v = next())) opt.outPath = v;
+    else if (a == "--dump" && (v = next())) opt.dumpPath = v;
+    else if (a == "--bench") opt.bench = true;
+    else if (a == "--publishers" && (v = next())) opt.publishers = atoi(v);
+    else if (a == "--messages" && (v = next())) opt.messages = atol(v);
+    else return false;
+  }
+  return true;
+}
+
+// ================= MQTT Callbacks ========================
+static void onSensor(const TopicMessage& msg, const SensorSample& s, void* ctx) {
+  static_cast<Ingest*>(ctx)->writer.append(wallUs(), msg.topic, s);
+}
+
+// Batch rows are filed under the device's sensors topic, like single samples
+static void onBatch(const TopicMessage& msg, const SensorBatch& b, void* ctx) {
+  static const std::string_view batch = "/" TELEMETRY_CHANNEL_BATCH;
+  std::string topic(msg.topic.substr(0, msg.topic.size() - batch.size()));
+  topic += "/" TELEMETRY_CHANNEL_SENSORS;
+  int64_t now = wallUs();
+  Ingest& in = *static_cast<Ingest*>(ctx);
+  for (size_t i = 0; i < b.n; ++i) in.writer.append(now, topic, b.rows[i]);
+  in.batches++;
+}
+
+static void onStatus(const TopicMessage& msg, void* ctx) {
+  Ingest& in = *static_cast<Ingest*>(ctx);
+  if (msg.len == 6 && memcmp(msg.payload, "online", 6) == 0) in.online++;
+  else                                                         in.offline++;
+}
+
+// One Session is the mosquitto userdata for the subscriber connection
+struct Session {
+  const Options* opt;
+  Ingest         ingest;
+  TopicRouter    router;
+
+  explicit Session(const Options* o) : opt(o) {
+    // Status and batch topics get their handlers, everything else is a
+    // sensor feed
+    auto endsWith = [](const std::string& t, const std::string& suffix) {
+      return t.size() >= suffix.size() && t.compare(t.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    for (const std::string& t : opt->topics) {
+      bool ok;
+      if (endsWith(t, "/" TELEMETRY_CHANNEL_STATUS)) {
+        ok = router.add(t.c_str(), onStatus, &ingest);
+      } else if (endsWith(t, "/" TELEMETRY_CHANNEL_BATCH)) {
+        ok = router.add<SensorBatch, payload::parseBatchPayload>(t.c_str(), onBatch, &ingest);
+      } else {
+        ok = router.add<SensorSample, payload::parseSensorPayload>(t.c_str(), onSensor, &ingest);
+      }
+      if (!ok) fprintf(stderr, "[MQTT] invalid topic filter: %s\n", t.c_str());
+    }
+  }
+};
+
+static void onMessage(struct mosquitto*, void* obj, const struct mosquitto_message* msg) {
+  Session& session = *static_cast<Session*>(obj);
+  Ingest& in = session.ingest;
+  in.received++;
+  in.payloadBytes += msg->payloadlen;
+  if (session.router.dispatch(msg->topic, strlen(msg->topic), msg->payload, msg->payloadlen) == 0) {
+    in.unrouted++;
+  }
+}
+
+static void onConnect(struct mosquitto* m, void* obj, int rc) {
+  if (rc != 0) {
+    fprintf(stderr, "[MQTT] connect refused, rc=%d\n", rc);
+    return;
+  }
+  // (Re)subscribe on every connect so a broker restart is transparent
+  const Options* opt = static_cast<Session*>(obj)->opt;
+  for (const std::string& t : opt->topics) {
+    int err = mosquitto_subscribe(m, nullptr, t.c_str(), opt->qos);
+    fprintf(stderr, "[MQTT] subscribe %s -> %s\n", t.c_str(), mosquitto_strerror(err));
+  }
+}
+
+// ================= Subscriber session ====================
+static struct mosquitto* connectSubscriber(Session& session) {
+  std::string id = "fleet-ingest-" + std::to_string(getpid());
+  struct mosquitto* m = mosquitto_new(id.c_str(), true, &session);
+  if (!m) return nullptr;
+  mosquitto_connect_callback_set(m, onConnect);
+  mosquitto_message_callback_set(m, onMessage);
+  int err = mosquitto_connect(m, session.opt->host.c_str(), session.opt->port, 30);
+  if (err != MOSQ_ERR_SUCCESS) {
+    fprintf(stderr, "[MQTT] connect %s:%d failed: %s\n",
+            session.opt->host.c_str(), session.opt->port, mosquitto_strerror(err));
+    mosquitto_destroy(m);
+    return nullptr;
+  }
+  return m;
+}
+
+static int runSubscriber(const Options& opt) {
+  Session session(&opt);
+  if (!session.ingest.writer.open(opt.outPath.c_str())) {
+    perror(opt.outPath.c_str());
+    return 1;
+  }
+  struct mosquitto* m = connectSubscriber(session);
+  if (!m) return 1;
+
+  fprintf(stderr, "[INGEST] writing %s\n", opt.outPath.c_str());
+  double lastReport = monoSec();
+  uint64_t lastCount = 0;
+  while (!stopRequested) {
+    int err = mosquitto_loop(m, 100, 1);
+    if (err == MOSQ_ERR_NO_CONN || err == MOSQ_ERR_CONN_LOST) {
+      fprintf(stderr, "[MQTT] %s, reconnecting in 2s\n", mosquitto_strerror(err));
+      session.ingest.writer.flush();
+      sleep(2);
+      mosquitto_reconnect(m);
+    }
+
+    double now = monoSec();
+    if (now - lastReport >= 5.0) {
+      const Ingest& in = session.ingest;
+      fprintf(stderr, "[INGEST] %.0f msg/s, total %llu, parse errors %llu, unrouted %llu, "
+              "batches %llu, rows on disk %llu, online/offline %llu/%llu\n",
+              (in.received - lastCount) / (now - lastReport),
+              (unsigned long long)in.received, (unsigned long long)session.router.parseErrors(),
+              (unsigned long long)in.unrouted, (unsigned long long)in.batches,
+              (unsigned long long)in.writer.rowsWritten(),
+              (unsigned long long)in.online, (unsigned long long)in.offline);
+      session.ingest.writer.flush();
+      lastReport = now;
+      lastCount = in.received;
+    }
+  }
+
+  session.ingest.writer.close();
+  mosquitto_disconnect(m);
+  mosquitto_destroy(m);
+  fprintf(stderr, "[INGEST] stopped, %llu rows written\n",
+          (unsigned long long)session.ingest.writer.rowsWritten());
+  return 0;
+}
+
+// ===================== Dump ==============================
+static int runDump(const Options& opt) {
+  printf("recv_us,device_ts_ms,topic,temp,light,humidity\n");
+  long rows = readColumnarFile(opt.dumpPath.c_str(),
+      [](int64_t us, const std::string& topic, const SensorSample& s) {
+        char ts[24] = "", temp[16] = "", light[16] = "", hum[16] = "";
+        if (s.present & SensorSample::HAS_TS)
+          snprintf(ts, sizeof(ts), "%lld", (long long)s.tsMs);
+        if (s.present & SensorSample::HAS_TEMP)
+          snprintf(temp, sizeof(temp), "%.2f", s.tempCenti / 100.0);
+        if (s.present & SensorSample::HAS_LIGHT)
+          snprintf(light, sizeof(light), "%d", s.light);
+        if (s.present & SensorSample::HAS_HUMIDITY)
+          snprintf(hum, sizeof(hum), "%.2f", s.humidityCenti / 100.0);
+        printf("%lld,%s,%s,%s,%s,%s\n", (long long)us, ts, topic.c_str(), temp, light, hum);
+      });
+  if (rows == -2) {
+    fprintf(stderr, "%s: corrupt record, stopped\n", opt.dumpPath.c_str());
+    return 1;
+  }
+  if (rows < 0) {
+    fprintf(stderr, "%s: not a columnar sample file\n", opt.dumpPath.c_str());
+    return 1;
+  }
+  fprintf(stderr, "%ld rows\n", rows);
+  return 0;
+}
+
+// ===================== Benchmark =========================
+// Publisher threads emit the firmware's payload format as fast as the
+// client library accepts it; the subscriber runs in the main thread exactly
+// as in normal operation.
+static void publisherThread(const Options& opt, const std::string& topic, int index,
+                            std::atomic<int>& done) {
+  std::string id = "bench-pub-" + std::to_string(getpid()) + "-" + std::to_string(index);
+  struct mosquitto* m = mosquitto_new(id.c_str(), true, nullptr);
+  if (!m || mosquitto_connect(m, opt.host.c_str(), opt.port, 30) != MOSQ_ERR_SUCCESS) {
+    fprintf(stderr, "[BENCH] publisher %d could not connect\n", index);
+    if (m) mosquitto_destroy(m);
+    done++;
+    return;
+  }
+  mosquitto_loop_start(m);
+
+  char payload[TELEMETRY_PAYLOAD_LEN];
+  for (long i = 0; i < opt.messages && !stopRequested; ++i) {
+    int len = telemetrySensorPayload(payload, sizeof(payload), 2000 + (int32_t)(i % 11) * 100,
+                                     400 + (int32_t)(i % 201), 5000 + (int32_t)(i % 2100), 0);
+    while (mosquitto_publish(m, nullptr, topic.c_str(), len, payload, opt.qos, false) != MOSQ_ERR_SUCCESS) {
+      if (stopRequested) break;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  mosquitto_disconnect(m);
+  mosquitto_loop_stop(m, false);
+  mosquitto_destroy(m);
+  done++;
+}
+
+static int runBench(Options opt) {
+  std::string prefix = "bench/" + std::to_string(getpid());
+  opt.topics = { prefix + "/#" };
+
+  Session session(&opt);
+  if (!session.ingest.writer.open(opt.outPath.c_str())) {
+    perror(opt.outPath.c_str());
+    return 1;
+  }
+  struct mosquitto* m = connectSubscriber(session);
+  if (!m) return 1;
+
+  // Wait for the SUBACK round trip before publishers start
+  for (int i = 0; i < 20; ++i) mosquitto_loop(m, 25, 1);
+
+  std::atomic<int> done{0};
+  std::vector<std::thread> pubs;
+  double t0 = monoSec();
+  for (int i = 0; i < opt.publishers; ++i) {
+    std::string topic = prefix + "/dev" + std::to_string(i) + "/esp32/sensor/data";
+    pubs.emplace_back(publisherThread, std::cref(opt), topic, i, std::ref(done));
+  }
+
+  const uint64_t expected = (uint64_t)opt.publishers * opt.messages;
+  const Ingest& in = session.ingest;
+  double lastRx = monoSec();
+  uint64_t lastSeen = 0;
+  while (!stopRequested && in.received < expected) {
+    mosquitto_loop(m, 50, 1);
+    if (in.received != lastSeen) {
+      lastSeen = in.received;
+      lastRx = monoSec();
+    } else if (done == opt.publishers && monoSec() - lastRx > 3.0) {
+      break;                                  // remainder was dropped
+    }
+  }
+  double rxEnd = lastRx > t0 ? lastRx : monoSec();
+  session.ingest.writer.flush();
+  double elapsed = rxEnd - t0;
+
+  for (std::thread& t : pubs) t.join();
+  mosquitto_disconnect(m);
+  mosquitto_destroy(m);
+
+  // QoS 1 may redeliver, so more than expected is not negative loss
+  uint64_t lost = in.received < expected ? expected - in.received : 0;
+  printf("{\n"
+         "  \"broker\": \"%s:%d\",\n"
+         "  \"publishers\": %d,\n"
+         "  \"qos\": %d,\n"
+         "  \"expected\": %llu,\n"
+         "  \"received\": %llu,\n"
+         "  \"lost\": %llu,\n"
+         "  \"loss\": %.4f,\n"
+         "  \"parse_errors\": %llu,\n"
+         "  \"rows_written\": %llu,\n"
+         "  \"file_bytes\": %llu,\n"
+         "  \"elapsed_s\": %.3f,\n"
+         "  \"msgs_per_s\": %.0f,\n"
+         "  \"payload_mb_per_s\": %.2f\n"
+         "}\n",
+         opt.host.c_str(), opt.port, opt.publishers, opt.qos,
+         (unsigned long long)expected, (unsigned long long)in.received,
+         (unsigned long long)lost, expected ? (double)lost / expected : 0.0,
+         (unsigned long long)session.router.parseErrors(), (unsigned long long)in.writer.rowsWritten(),
+         (unsigned long long)in.writer.bytesWritten(), elapsed,
+         elapsed > 0 ? in.received / elapsed : 0.0,
+         elapsed > 0 ? in.payloadBytes / elapsed / 1e6 : 0.0);
+  session.ingest.writer.close();
+  return lost == 0 ? 0 : 2;
+}
+
+// ========================= MAIN ===========================
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, opt)) {
+    usage(argv[0]);
+    return 64;
+  }
+  if (!opt.dumpPath.empty()) return runDump(opt);
+  if (opt.topics.empty()) {
+    opt.topics = { "+/+/+/" TELEMETRY_CHANNEL_SENSORS, "+/+/+/" TELEMETRY_CHANNEL_BATCH,
+                   "+/+/+/" TELEMETRY_CHANNEL_STATUS, "esp32/sensor/data" };
+  }
+
+  std::signal(SIGINT, onSignal);
+  std::signal(SIGTERM, onSignal);
+  mosquitto_lib_init();
+  int rc = opt.bench ? runBench(opt) : runSubscriber(opt);
+  mosquitto_lib_cleanup();
+  return rc;
+}
@@ -0,0 +1,295 @@
+/*
+  Fleet swarm simulator (Linux)
+  -----------------------------
+  Runs thousands of virtual ESP32 devices, each with its own MQTT connection,
+  MAC-derived id and site/zone/device/channel topics, publishing through the
+  same telemetry.h code as the firmware. The fleet grows in steps; for each
+  step an in-process monitor subscribed to <site>/+/+/sensors measures the
+  aggregate delivered message rate and end-to-end lag (publish timestamp in
+  the payload vs. receive time). Results are printed as JSON.
+
+  swarm -h localhost --steps 100,500,1000,2000 --rate 1 --step-seconds 15
+*/
+
+#include <mosquitto.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "payload_parser.h"
+#include "telemetry.h"
+
+// ===================== CONFIGURATION =====================
+struct Options {
+  std::string host = "localhost";
+  int         port = 1883;
+  std::string site = MQTT_SITE;
+  int         zones = 4;
+  std::vector<int> steps = { 100, 500, 1000 };
+  double      rate = 1.0;            // messages per device per second
+  double      stepSeconds = 10.0;
+  int         workers = 0;           // 0 = hardware concurrency
+};
+
+// ===================== GLOBALS ============================
+static volatile std::sig_atomic_t stopRequested = 0;
+
+struct VirtualDevice {
+  struct mosquitto* m = nullptr;
+  char id[TELEMETRY_ID_LEN];
+  char topic[TELEMETRY_TOPIC_LEN];
+  char statusTopic[TELEMETRY_TOPIC_LEN];
+  std::atomic<bool> connected{false};
+  double nextPublish = 0;
+  int32_t tempCenti = 2500;
+  int32_t light = 500;
+  int32_t humidityCenti = 6000;
+};
+
+struct Monitor {
+  uint64_t received = 0;
+  std::vector<double> lagMs;
+};
+
+static std::atomic<uint64_t> published{0};
+static std::atomic<uint64_t> publishErrors{0};
+static std::atomic<int>      activeDevices{0};
+static std::atomic<int>      connectedDevices{0};
+
+// =================== Helper Functions ====================
+static int64_t wallMs() {
+  using namespace std::chrono;
+  return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+static double wallMsPrecise() {
+  using namespace std::chrono;
+  return duration<double, std::milli>(system_clock::now().time_since_epoch()).count();
+}
+
+static double monoSec() {
+  using namespace std::chrono;
+  return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+static void onSignal(int) { stopRequested = 1; }
+
+static bool parseArgs(int argc, char** argv, Options& opt) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+    const char* v = nullptr;
+    if      (a == "-h" && (v = next())) opt.host = v;
+    else if (a == "-p" && (v = next())) opt.port = atoi(v);
+    else if (a == "--site" && (v = next())) opt.site = v;
+    else if (a == "--zones" && (v = next())) opt.zones = std::max(1, atoi(v));
+    else if (a == "--rate" && (v = next())) opt.rate = atof(v);
+    else if (a == "--step-seconds" && (v = next())) opt.stepSeconds = atof(v);
+    else if (a == "--workers" && (v = next())) opt.workers = atoi(v);
+    else if (a == "--steps" && (v = next())) {
+      opt.steps.clear();
+      for (const char* p = v; *p; ) {
+        opt.steps.push_back(atoi(p));
+        while (*p && *p != ',') ++p;
+        if (*p == ',') ++p;
+      }
+      std::sort(opt.steps.begin(), opt.steps.end());
+    }
+    else return false;
+  }
+  return !opt.steps.empty() && opt.rate > 0;
+}
+
+static double percentile(std::vector<double>& v, double pct) {
+  if (v.empty()) return 0.0;
+  size_t idx = std::min(v.size() - 1, (size_t)(pct / 100.0 * v.size()));
+  std::nth_element(v.begin(), v.begin() + idx, v.end());
+  return v[idx];
+}
+
+// ================= Virtual devices =======================
+static void onDeviceConnect(struct mosquitto* m, void* obj, int rc) {
+  VirtualDevice* d = static_cast<VirtualDevice*>(obj);
+  if (rc != 0) return;
+  mosquitto_publish(m, nullptr, d->statusTopic, 6, "online", 0, true);
+  if (!d->connected.exchange(true)) connectedDevices++;
+}
+
+static void onDeviceDisconnect(struct mosquitto*, void* obj, int) {
+  VirtualDevice* d = static_cast<VirtualDevice*>(obj);
+  if (d->connected.exchange(false)) connectedDevices--;
+}
+
+static bool startDevice(const Options& opt, VirtualDevice& d, int index, std::mt19937& rng) {
+  // Locally administered MAC so ids never collide with real boards
+  uint8_t mac[6] = { 0x02, 0x00, 0x00, (uint8_t)(index >> 16), (uint8_t)(index >> 8), (uint8_t)index };
+  char zone[16];
+  snprintf(zone, sizeof(zone), "zone%d", index % opt.zones + 1);
+  telemetryDeviceId(mac, d.id, sizeof(d.id));
+  telemetryTopic(d.topic, sizeof(d.topic), opt.site.c_str(), zone, d.id, TELEMETRY_CHANNEL_SENSORS);
+  telemetryTopic(d.statusTopic, sizeof(d.statusTopic), opt.site.c_str(), zone, d.id, TELEMETRY_CHANNEL_STATUS);
+
+  d.m = mosquitto_new(d.id, true, &d);
+  if (!d.m) return false;
+  mosquitto_connect_callback_set(d.m, onDeviceConnect);
+  mosquitto_disconnect_callback_set(d.m, onDeviceDisconnect);
+  mosquitto_will_set(d.m, d.statusTopic, 7, "offline", 0, true);
+  if (mosquitto_connect(d.m, opt.host.c_str(), opt.port, 60) != MOSQ_ERR_SUCCESS) return false;
+
+  // Spread the first publish over one period so devices do not fire in lockstep
+  std::uniform_real_distribution<double> phase(0.0, 1.0 / opt.rate);
+  d.nextPublish = monoSec() + phase(rng);
+  return true;
+}
+
+// Same simulated walk as publishSensorData() in the firmware
+static void publishSample(VirtualDevice& d, std::mt19937& rng) {
+  char payload[TELEMETRY_PAYLOAD_LEN];
+  int len = telemetrySensorPayload(payload, sizeof(payload), d.tempCenti, d.light, d.humidityCenti,
+                                   (uint64_t)wallMs());
+  if (mosquitto_publish(d.m, nullptr, d.topic, len, payload, 0, false) == MOSQ_ERR_SUCCESS) published++;
+  else publishErrors++;
+
+  d.tempCenti     = (20 + rng() % 11) * 100;
+  d.light         = 400 + rng() % 201;
+  d.humidityCenti = (50 + rng() % 21) * 100;
+}
+
+// Each worker owns every Nth device and drives their network loops without
+// a thread per connection.
+static void workerThread(const Options& opt, std::vector<std::unique_ptr<VirtualDevice>>& fleet,
+                         int worker, int workers) {
+  std::mt19937 rng(1234 + worker);
+  std::vector<VirtualDevice*> mine;
+  const double period = 1.0 / opt.rate;
+
+  while (!stopRequested) {
+    int active = activeDevices;
+    for (int i = worker + (int)mine.size() * workers; i < active; i += workers) {
+      VirtualDevice& d = *fleet[i];
+      if (!startDevice(opt, d, i, rng)) fprintf(stderr, "[SWARM] %s could not connect\n", d.id);
+      mine.push_back(&d);
+    }
+
+    double now = monoSec();
+    for (VirtualDevice* d : mine) {
+      if (!d->m) continue;
+      if (d->connected && now >= d->nextPublish) {
+        publishSample(*d, rng);
+        d->nextPublish += period;
+        if (d->nextPublish < now) d->nextPublish = now + period;   // fell behind
+      }
+      int rc = mosquitto_loop(d->m, 0, 1);
+      if (rc == MOSQ_ERR_NO_CONN || rc == MOSQ_ERR_CONN_LOST) mosquitto_reconnect(d->m);
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(mine.empty() ? 10000 : 500));
+  }
+
+  for (VirtualDevice* d : mine) {
+    if (!d->m) continue;
+    mosquitto_disconnect(d->m);
+    mosquitto_destroy(d->m);
+    d->m = nullptr;
+  }
+}
+
+// ===================== Monitor ===========================
+static void onMonitorMessage(struct mosquitto*, void* obj, const struct mosquitto_message* msg) {
+  Monitor* mon = static_cast<Monitor*>(obj);
+  SensorSample s;
+  mon->received++;
+  if (payload::parseSensorPayload(msg->payload, msg->payloadlen, &s) && (s.present & SensorSample::HAS_TS)) {
+    mon->lagMs.push_back(wallMsPrecise() - (double)s.tsMs);
+  }
+}
+
+// ========================= MAIN ===========================
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, opt)) {
+    fprintf(stderr,
+            "usage: %s [-h host] [-p port] [--site name] [--zones N] [--steps 100,500,...]\n"
+            "          [--rate msgs_per_device_per_s] [--step-seconds S] [--workers N]\n",
+            argv[0]);
+    return 64;
+  }
+  std::signal(SIGINT, onSignal);
+  std::signal(SIGTERM, onSignal);
+  mosquitto_lib_init();
+
+  Monitor mon;
+  std::string monId = "swarm-monitor-" + std::to_string(getpid());
+  struct mosquitto* monitor = mosquitto_new(monId.c_str(), true, &mon);
+  mosquitto_message_callback_set(monitor, onMonitorMessage);
+  if (mosquitto_connect(monitor, opt.host.c_str(), opt.port, 60) != MOSQ_ERR_SUCCESS) {
+    fprintf(stderr, "[SWARM] cannot reach broker %s:%d\n", opt.host.c_str(), opt.port);
+    return 1;
+  }
+  std::string sub = opt.site + "/+/+/" TELEMETRY_CHANNEL_SENSORS;
+  mosquitto_subscribe(monitor, nullptr, sub.c_str(), 0);
+
+  const int maxDevices = opt.steps.back();
+  std::vector<std::unique_ptr<VirtualDevice>> fleet;
+  fleet.reserve(maxDevices);
+  for (int i = 0; i < maxDevices; ++i) fleet.emplace_back(new VirtualDevice());
+
+  int workers = opt.workers > 0 ? opt.workers : std::max(1u, std::thread::hardware_concurrency());
+  std::vector<std::thread> threads;
+  for (int w = 0; w < workers; ++w) {
+    threads.emplace_back(workerThread, std::cref(opt), std::ref(fleet), w, workers);
+  }
+
+  printf("{\n  \"broker\": \"%s:%d\",\n  \"rate_per_device\": %.3f,\n  \"workers\": %d,\n  \"steps\": [\n",
+         opt.host.c_str(), opt.port, opt.rate, workers);
+  for (size_t si = 0; si < opt.steps.size() && !stopRequested; ++si) {
+    int target = opt.steps[si];
+    activeDevices = target;
+
+    // Let the new devices connect (bounded), then measure a clean window
+    double waitUntil = monoSec() + 30.0;
+    while (!stopRequested && connectedDevices < target && monoSec() < waitUntil) {
+      mosquitto_loop(monitor, 10, 1);
+    }
+    double settle = monoSec() + 1.0;
+    while (!stopRequested && monoSec() < settle) mosquitto_loop(monitor, 10, 1);
+
+    mon.received = 0;
+    mon.lagMs.clear();
+    uint64_t pub0 = published, err0 = publishErrors;
+    double t0 = monoSec();
+    while (!stopRequested && monoSec() - t0 < opt.stepSeconds) mosquitto_loop(monitor, 10, 1);
+    double elapsed = monoSec() - t0;
+    uint64_t pub = published - pub0;
+
+    double p50 = percentile(mon.lagMs, 50), p99 = percentile(mon.lagMs, 99);
+    double maxLag = mon.lagMs.empty() ? 0.0 : *std::max_element(mon.lagMs.begin(), mon.lagMs.end());
+    printf("    {\"devices\": %d, \"connected\": %d, \"target_msgs_per_s\": %.0f, "
+           "\"published_per_s\": %.1f, \"received_per_s\": %.1f, \"delivery_ratio\": %.4f, "
+           "\"publish_errors\": %llu, \"lag_ms\": {\"p50\": %.2f, \"p99\": %.2f, \"max\": %.2f}}%s\n",
+           target, connectedDevices.load(), target * opt.rate,
+           pub / elapsed, mon.received / elapsed, pub ? (double)mon.received / pub : 0.0,
+           (unsigned long long)(publishErrors - err0), p50, p99, maxLag,
+           si + 1 < opt.steps.size() ? "," : "");
+    fflush(stdout);
+  }
+  printf("  ]\n}\n");
+
+  stopRequested = 1;
+  for (std::thread& t : threads) t.join();
+  mosquitto_disconnect(monitor);
+  mosquitto_destroy(monitor);
+  mosquitto_lib_cleanup();
+  return 0;
+}
@@ -0,0 +1,162 @@
+#include "topic_router.h"
+
+#include <cstring>
+
+static uint32_t levelHash(uint32_t parent, std::string_view level) {
+  uint32_t h = 2166136261u ^ parent;   // FNV-1a, seeded with the parent node
+  for (char c : level) h = (h ^ (uint8_t)c) * 16777619u;
+  return h;
+}
+
+// Splits `topic` at '/' into `out`; returns the level count, or 0 if there
+// are more than `max` levels.
+static size_t splitLevels(std::string_view topic, std::string_view* out, size_t max) {
+  size_t n = 0;
+  size_t start = 0;
+  for (;;) {
+    size_t slash = topic.find('/', start);
+    if (n == max) return 0;
+    if (slash == std::string_view::npos) {
+      out[n++] = topic.substr(start);
+      return n;
+    }
+    out[n++] = topic.substr(start, slash - start);
+    start = slash + 1;
+  }
+}
+
+bool TopicRouter::validFilter(std::string_view filter) {
+  if (filter.empty()) return false;
+  std::string_view levels[MAX_LEVELS];
+  size_t n = splitLevels(filter, levels, MAX_LEVELS);
+  if (n == 0) return false;
+  for (size_t i = 0; i < n; ++i) {
+    std::string_view l = levels[i];
+    if (l == "#") {
+      if (i != n - 1) return false;
+    } else if (l != "+" && l.find_first_of("+#") != std::string_view::npos) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TopicRouter::rawThunk(const Sub& s, const TopicMessage& msg) {
+  reinterpret_cast<Handler>(s.fn)(msg, s.ctx);
+  return true;
+}
+
+bool TopicRouter::add(const char* filter, Handler fn, void* ctx) {
+  return addSub(filter, &rawThunk, reinterpret_cast<void (*)()>(fn), ctx);
+}
+
+bool TopicRouter::addSub(const char* filter, Thunk thunk, void (*fn)(), void* ctx) {
+  std::string_view f(filter);
+  if (!validFilter(f)) return false;
+  std::string_view levels[MAX_LEVELS];
+  size_t n = splitLevels(f, levels, MAX_LEVELS);
+
+  uint32_t node = 0;
+  bool multi = false;
+  for (size_t i = 0; i < n; ++i) {
+    if (levels[i] == "#") {
+      multi = true;
+      break;
+    }
+    if (levels[i] == "+") {
+      if (nodes_[node].plus == NONE) {
+        uint32_t c = (uint32_t)nodes_.size();
+        nodes_.emplace_back();
+        nodes_[node].plus = c;
+      }
+      node = nodes_[node].plus;
+    } else {
+      uint32_t c = child(node, levels[i]);
+      node = c != NONE ? c : addChild(node, levels[i]);
+    }
+  }
+
+  uint32_t id = (uint32_t)subs_.size();
+  subs_.push_back({thunk, fn, ctx});
+  (multi ? nodes_[node].multi : nodes_[node].exact).push_back(id);
+  return true;
+}
+
+uint32_t TopicRouter::child(uint32_t parent, std::string_view level) const {
+  if (edges_.empty()) return NONE;
+  uint32_t h = levelHash(parent, level);
+  size_t mask = edges_.size() - 1;
+  for (size_t i = h & mask;; i = (i + 1) & mask) {
+    const Edge& e = edges_[i];
+    if (e.parent == NONE) return NONE;
+    if (e.hash == h && e.parent == parent && e.keyLen == level.size() &&
+        memcmp(keys_.data() + e.keyOff, level.data(), level.size()) == 0) {
+      return e.child;
+    }
+  }
+}
+
+uint32_t TopicRouter::addChild(uint32_t parent, std::string_view level) {
+  if ((edgeCount_ + 1) * 10 > edges_.size() * 7) grow();
+  uint32_t c = (uint32_t)nodes_.size();
+  nodes_.emplace_back();
+
+  Edge e;
+  e.parent = parent;
+  e.hash   = levelHash(parent, level);
+  e.child  = c;
+  e.keyOff = (uint32_t)keys_.size();
+  e.keyLen = (uint32_t)level.size();
+  keys_.append(level.data(), level.size());
+
+  size_t mask = edges_.size() - 1;
+  size_t i = e.hash & mask;
+  while (edges_[i].parent != NONE) i = (i + 1) & mask;
+  edges_[i] = e;
+  edgeCount_++;
+  return c;
+}
+
+void TopicRouter::grow() {
+  std::vector<Edge> old;
+  old.swap(edges_);
+  edges_.assign(old.empty() ? 64 : old.size() * 2, Edge());
+  size_t mask = edges_.size() - 1;
+  for (const Edge& e : old) {
+    if (e.parent == NONE) continue;
+    size_t i = e.hash & mask;
+    while (edges_[i].parent != NONE) i = (i + 1) & mask;
+    edges_[i] = e;
+  }
+}
+
+size_t TopicRouter::fire(const std::vector<uint32_t>& subs, const TopicMessage& msg) {
+  for (uint32_t id : subs) {
+    const Sub& s = subs_[id];
+    if (!s.thunk(s, msg)) parseErrors_++;
+  }
+  return subs.size();
+}
+
+size_t TopicRouter::match(uint32_t node, const std::string_view* levels, size_t count,
+                          size_t depth, const TopicMessage& msg) {
+  const Node& n = nodes_[node];
+  // '$' topics (broker internals) are not matched by a leading wildcard
+  bool dollar = depth == 0 && !levels[0].empty() && levels[0][0] == '$';
+  size_t hits = 0;
+  if (!n.multi.empty() && !dollar) hits += fire(n.multi, msg);
+  if (depth == count) return hits + fire(n.exact, msg);
+
+  uint32_t c = child(node, levels[depth]);
+  if (c != NONE) hits += match(c, levels, count, depth + 1, msg);
+  if (n.plus != NONE && !dollar) hits += match(n.plus, levels, count, depth + 1, msg);
+  return hits;
+}
+
+size_t TopicRouter::dispatch(const char* topic, size_t topicLen, const void* payload, size_t len) {
+  TopicMessage msg{std::string_view(topic, topicLen), payload, len};
+  std::string_view levels[MAX_LEVELS];
+  size_t count = splitLevels(msg.topic, levels, MAX_LEVELS);
+  if (count == 0) return 0;
+  return match(0, levels, count, 0, msg);
+}
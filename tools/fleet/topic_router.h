@@ -0,0 +1,106 @@
+#ifndef TOPIC_ROUTER_H
+#define TOPIC_ROUTER_H
+
+// MQTT topic router: subscription filters (with `+` and `#` wildcards) are
+// compiled into a trie once, and every incoming message is matched by
+// walking the trie level by level instead of testing each filter.
+//
+//   TopicRouter router;
+//   router.add<SensorSample, payload::parseSensorPayload>("+/+/+/sensors", onSensor, &ingest);
+//   router.add("+/+/+/status", onStatus, &fleet);
+//   router.dispatch(msg->topic, strlen(msg->topic), msg->payload, msg->payloadlen);
+//
+// Nothing is copied on the dispatch path: topic levels are string_views
+// into the caller's topic, trie edges live in one open-addressed hash table
+// keyed by (parent node, level), and typed handlers get a value parsed
+// straight out of the receive buffer. Matching follows MQTT 3.1.1: `+` is
+// exactly one level, `#` is the parent level and everything below it, and
+// wildcards in the first level do not match topics starting with '$'.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct TopicMessage {
+  std::string_view topic;
+  const void*      payload;
+  size_t           len;
+};
+
+class TopicRouter {
+ public:
+  typedef void (*Handler)(const TopicMessage& msg, void* ctx);
+
+  static constexpr size_t MAX_LEVELS = 32;
+
+  // Registers a raw handler. Returns false for an invalid filter (empty,
+  // `#` not last, wildcard mixed into a level, too many levels).
+  bool add(const char* filter, Handler fn, void* ctx);
+
+  // Registers a typed handler: `Parse` decodes the payload in place and
+  // `fn` only sees messages that parsed; failures are counted.
+  template <typename T, bool (*Parse)(const void*, size_t, T*)>
+  bool add(const char* filter, void (*fn)(const TopicMessage&, const T&, void*), void* ctx) {
+    return addSub(filter, &typedThunk<T, Parse>, reinterpret_cast<void (*)()>(fn), ctx);
+  }
+
+  // Calls every handler whose filter matches `topic`; returns how many.
+  size_t dispatch(const char* topic, size_t topicLen, const void* payload, size_t len);
+
+  size_t   subscriptions() const { return subs_.size(); }
+  size_t   nodes() const { return nodes_.size(); }
+  uint64_t parseErrors() const { return parseErrors_; }
+
+  static bool validFilter(std::string_view filter);
+
+ private:
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+  struct Sub;
+  typedef bool (*Thunk)(const Sub& s, const TopicMessage& msg);
+  struct Sub {
+    Thunk   thunk;
+    void  (*fn)();
+    void*   ctx;
+  };
+  struct Node {
+    uint32_t plus = NONE;                 // child for `+`
+    std::vector<uint32_t> exact;          // filters ending here
+    std::vector<uint32_t> multi;          // filters ending in `/#` below here
+  };
+  struct Edge {
+    uint32_t parent = NONE;               // NONE = empty slot
+    uint32_t hash;
+    uint32_t child;
+    uint32_t keyOff;
+    uint32_t keyLen;
+  };
+
+  template <typename T, bool (*Parse)(const void*, size_t, T*)>
+  static bool typedThunk(const Sub& s, const TopicMessage& msg) {
+    T value;
+    if (!Parse(msg.payload, msg.len, &value)) return false;
+    reinterpret_cast<void (*)(const TopicMessage&, const T&, void*)>(s.fn)(msg, value, s.ctx);
+    return true;
+  }
+  static bool rawThunk(const Sub& s, const TopicMessage& msg);
+
+  bool     addSub(const char* filter, Thunk thunk, void (*fn)(), void* ctx);
+  uint32_t child(uint32_t parent, std::string_view level) const;
+  uint32_t addChild(uint32_t parent, std::string_view level);
+  void     grow();
+  size_t   match(uint32_t node, const std::string_view* levels, size_t count, size_t depth,
+                 const TopicMessage& msg);
+  size_t   fire(const std::vector<uint32_t>& subs, const TopicMessage& msg);
+
+  std::vector<Node> nodes_{1};            // [0] = root
+  std::vector<Edge> edges_;
+  size_t            edgeCount_ = 0;
+  std::string       keys_;                // level names, referenced by Edge
+  std::vector<Sub>  subs_;
+  uint64_t          parseErrors_ = 0;
+};
+
+#endif // TOPIC_ROUTER_H
@@ -0,0 +1,284 @@
+#!/usr/bin/env python3
+"""
+HTTP load generator for the ESP32 dashboard/API.
+
+Drives the device with N concurrent workers using a weighted request mix,
+measures client-side latency per route and pulls the device's own
+/api/metrics (server-side latency percentiles and heap deltas) before and
+after the run. Results are written as JSON.
+
+  python tools/http_bench.py --host 192.168.4.1 --scenario api -c 4 -d 30
+  python tools/http_bench.py --scenario captive            # "10 phones"
+  python tools/http_bench.py --mix "/api/sensors:5,/:1" --out result.json
+  python tools/http_bench.py --scenario dashboard --compare-keepalive
+
+--compare-keepalive runs the same load twice, one connection per request
+and then one persistent connection per worker, and reports client latency
+next to the device's per-request CPU time (`http.cpu_us_per_req`).
+"""
+
+import argparse
+import http.client
+import json
+import random
+import sys
+import threading
+import time
+
+# route -> weight. Captive probes are sent with a foreign Host header, the
+# way a phone's connectivity check hits the portal after DNS spoofing.
+SCENARIOS = {
+    "api": {
+        "mix": {
+            "/api/sensors": 4,
+            "/api/wifi/status": 2,
+            "/api/wifi/scan/results": 1,
+            "/": 1,
+        },
+        "concurrency": 4,
+        "host_header": None,
+    },
+    "captive": {
+        "mix": {
+            "/generate_204": 3,
+            "/hotspot-detect.html": 3,
+            "/ncsi.txt": 1,
+            "/connecttest.txt": 1,
+            "/": 1,
+        },
+        "concurrency": 10,
+        "host_header": "connectivitycheck.gstatic.com",
+    },
+    "dashboard": {
+        "mix": {
+            "/api/sensors": 1,
+            "/api/wifi/status": 1,
+        },
+        "concurrency": 2,
+        "host_header": None,
+    },
+}
+
+
+def parse_mix(text):
+    mix = {}
+    for part in text.split(","):
+        route, _, weight = part.strip().partition(":")
+        mix[route] = int(weight or 1)
+    return mix
+
+
+def percentile(sorted_vals, pct):
+    if not sorted_vals:
+        return 0.0
+    idx = min(len(sorted_vals) - 1, max(0, int(round(pct / 100.0 * len(sorted_vals) + 0.5)) - 1))
+    return sorted_vals[idx]
+
+
+def fetch_json(host, port, path, method="GET", timeout=5.0):
+    conn = http.client.HTTPConnection(host, port, timeout=timeout)
+    try:
+        conn.request(method, path)
+        resp = conn.getresponse()
+        body = resp.read()
+        return json.loads(body) if resp.status == 200 else None
+    except (OSError, ValueError):
+        return None
+    finally:
+        conn.close()
+
+
+class Worker(threading.Thread):
+    def __init__(self, args, routes, weights, host_header, deadline, budget):
+        super().__init__(daemon=True)
+        self.args = args
+        self.routes = routes
+        self.weights = weights
+        self.host_header = host_header
+        self.deadline = deadline
+        self.budget = budget
+        self.samples = {r: [] for r in routes}
+        self.errors = {r: 0 for r in routes}
+        self.bytes = 0
+
+    def _connect(self):
+        return http.client.HTTPConnection(self.args.host, self.args.port, timeout=self.args.timeout)
+
+    def run(self):
+        conn = None
+        while time.monotonic() < self.deadline and self.budget.take():
+            route = random.choices(self.routes, self.weights)[0]
+            headers = {"Host": self.host_header} if self.host_header else {}
+            if not self.args.keepalive:
+                headers["Connection"] = "close"
+            if conn is None:
+                conn = self._connect()
+            t0 = time.perf_counter()
+            try:
+                conn.request("GET", route, headers=headers)
+                resp = conn.getresponse()
+                body = resp.read()
+                dt = time.perf_counter() - t0
+                if resp.status >= 500:
+                    self.errors[route] += 1
+                else:
+                    self.samples[route].append(dt * 1000.0)
+                    self.bytes += len(body)
+                if not self.args.keepalive or resp.will_close:
+                    conn.close()
+                    conn = None
+            except (OSError, http.client.HTTPException):
+                self.errors[route] += 1
+                conn.close()
+                conn = None
+        if conn:
+            conn.close()
+
+
+class Budget:
+    """Shared request counter so --requests caps the total across workers."""
+
+    def __init__(self, limit):
+        self.limit = limit
+        self.lock = threading.Lock()
+
+    def take(self):
+        if self.limit is None:
+            return True
+        with self.lock:
+            if self.limit <= 0:
+                return False
+            self.limit -= 1
+            return True
+
+
+def run_pass(args, scenario, routes, weights, concurrency, keepalive):
+    args.keepalive = keepalive
+    fetch_json(args.host, args.port, "/api/metrics/reset", method="POST")
+    before = fetch_json(args.host, args.port, "/api/metrics")
+
+    budget = Budget(args.requests)
+    start = time.monotonic()
+    deadline = start + args.duration
+    workers = [Worker(args, routes, weights, scenario["host_header"], deadline, budget)
+               for _ in range(concurrency)]
+    for w in workers:
+        w.start()
+    for w in workers:
+        w.join()
+    elapsed = time.monotonic() - start
+
+    after = fetch_json(args.host, args.port, "/api/metrics")
+    device = {r["route"]: r for r in (after or {}).get("routes", [])}
+
+    result = {
+        "scenario": args.scenario,
+        "host": args.host,
+        "concurrency": concurrency,
+        "keepalive": keepalive,
+        "elapsed_s": round(elapsed, 3),
+        "routes": {},
+        "heap": {
+            "free_before": (before or {}).get("free_heap"),
+            "free_after": (after or {}).get("free_heap"),
+            "min_free": (after or {}).get("min_free_heap"),
+        },
+    }
+    if after and "http" in after:
+        result["server"] = after["http"]
+
+    total_ok = 0
+    total_err = 0
+    all_lat = []
+    for route in routes:
+        lat = sorted(x for w in workers for x in w.samples[route])
+        all_lat.extend(lat)
+        errs = sum(w.errors[route] for w in workers)
+        total_ok += len(lat)
+        total_err += errs
+        entry = {
+            "requests": len(lat),
+            "errors": errs,
+            "rps": round(len(lat) / elapsed, 2) if elapsed else 0.0,
+            "p50_ms": round(percentile(lat, 50), 2),
+            "p99_ms": round(percentile(lat, 99), 2),
+            "max_ms": round(lat[-1], 2) if lat else 0.0,
+        }
+        dev = device.get(route)
+        if dev is None and args.scenario == "captive" and route == "/":
+            dev = device.get("*")
+        if dev:
+            entry["device"] = dev
+        result["routes"][route] = entry
+    total_bytes = sum(w.bytes for w in workers)
+    all_lat.sort()
+
+    result["total"] = {
+        "requests": total_ok,
+        "errors": total_err,
+        "rps": round(total_ok / elapsed, 2) if elapsed else 0.0,
+        "p50_ms": round(percentile(all_lat, 50), 2),
+        "p99_ms": round(percentile(all_lat, 99), 2),
+        "bytes": total_bytes,
+    }
+    return result
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--host", default="192.168.4.1")
+    ap.add_argument("--port", type=int, default=80)
+    ap.add_argument("--scenario", choices=sorted(SCENARIOS), default="api")
+    ap.add_argument("--mix", help="override request mix, e.g. '/api/sensors:4,/:1'")
+    ap.add_argument("-c", "--concurrency", type=int, help="parallel clients (default from scenario)")
+    ap.add_argument("-d", "--duration", type=float, default=20.0, help="seconds to run")
+    ap.add_argument("-n", "--requests", type=int, help="stop after this many requests in total")
+    ap.add_argument("--timeout", type=float, default=5.0)
+    ap.add_argument("--keepalive", action="store_true", help="reuse one connection per worker")
+    ap.add_argument("--compare-keepalive", action="store_true",
+                    help="run without and then with keep-alive and report both")
+    ap.add_argument("--out", help="write JSON results here (default: stdout)")
+    args = ap.parse_args()
+
+    scenario = SCENARIOS[args.scenario]
+    mix = parse_mix(args.mix) if args.mix else scenario["mix"]
+    concurrency = args.concurrency or scenario["concurrency"]
+    routes, weights = list(mix), list(mix.values())
+
+    if args.compare_keepalive:
+        close = run_pass(args, scenario, routes, weights, concurrency, False)
+        keep = run_pass(args, scenario, routes, weights, concurrency, True)
+
+        def cpu(r):
+            return r.get("server", {}).get("cpu_us_per_req")
+
+        result = {
+            "close": close,
+            "keepalive": keep,
+            "summary": {
+                mode: {
+                    "rps": r["total"]["rps"],
+                    "p50_ms": r["total"]["p50_ms"],
+                    "p99_ms": r["total"]["p99_ms"],
+                    "device_cpu_us_per_req": cpu(r),
+                    "connections": r.get("server", {}).get("accepted"),
+                }
+                for mode, r in (("close", close), ("keepalive", keep))
+            },
+        }
+        total_ok = close["total"]["requests"] + keep["total"]["requests"]
+    else:
+        result = run_pass(args, scenario, routes, weights, concurrency, args.keepalive)
+        total_ok = result["total"]["requests"]
+
+    text = json.dumps(result, indent=2)
+    if args.out:
+        with open(args.out, "w") as f:
+            f.write(text + "\n")
+    else:
+        print(text)
+    return 0 if total_ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
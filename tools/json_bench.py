@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+"""
+Streamed vs materialized JSON: peak heap and time-to-first-byte.
+
+Needs firmware built with -DJSON_STREAM_BENCH. Fills the scan cache with
+--networks synthetic entries (POST /api/wifi/scan/synthetic), then fetches
+the same list --runs times from
+
+  /api/wifi/scan/results            streamed (JsonStream, fixed buffer)
+  /api/wifi/scan/results/document   JsonDocument + String
+
+and reports client TTFB (request sent -> status line and headers received)
+and total time, plus the device's per-route peak heap use from
+/api/metrics (`peak_heap_avg` / `peak_heap_max`).
+
+  python tools/json_bench.py --host 192.168.4.1 --networks 60 --runs 20
+"""
+
+import argparse
+import http.client
+import json
+import statistics
+import sys
+import time
+
+ROUTES = {
+    "stream": "/api/wifi/scan/results",
+    "document": "/api/wifi/scan/results/document",
+}
+
+
+def call(host, port, method, path, timeout):
+    conn = http.client.HTTPConnection(host, port, timeout=timeout)
+    try:
+        conn.request(method, path)
+        resp = conn.getresponse()
+        return resp.status, resp.read()
+    finally:
+        conn.close()
+
+
+def timed_get(conn, path):
+    t0 = time.perf_counter()
+    conn.request("GET", path)
+    resp = conn.getresponse()
+    ttfb = time.perf_counter() - t0
+    body = resp.read()
+    total = time.perf_counter() - t0
+    if resp.status != 200:
+        raise RuntimeError("GET %s -> %d" % (path, resp.status))
+    return ttfb * 1000.0, total * 1000.0, len(body), resp.getheader("Transfer-Encoding") == "chunked"
+
+
+def summarize(vals):
+    return {"p50": round(statistics.median(vals), 2), "min": round(min(vals), 2), "max": round(max(vals), 2)}
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--host", default="192.168.4.1")
+    ap.add_argument("--port", type=int, default=80)
+    ap.add_argument("--networks", type=int, default=60)
+    ap.add_argument("--runs", type=int, default=20)
+    ap.add_argument("--timeout", type=float, default=5.0)
+    ap.add_argument("--out", help="write JSON results here (default: stdout)")
+    args = ap.parse_args()
+
+    try:
+        status, _ = call(args.host, args.port, "POST", "/api/wifi/scan/synthetic?n=%d" % args.networks, args.timeout)
+        if status != 200:
+            print("json_bench: synthetic scan not available (build with -DJSON_STREAM_BENCH)", file=sys.stderr)
+            return 1
+        call(args.host, args.port, "POST", "/api/metrics/reset", args.timeout)
+
+        samples = {name: [] for name in ROUTES}
+        conn = http.client.HTTPConnection(args.host, args.port, timeout=args.timeout)
+        for _ in range(args.runs):
+            for name, path in ROUTES.items():   # interleaved so both see the same conditions
+                samples[name].append(timed_get(conn, path))
+        conn.close()
+
+        _, body = call(args.host, args.port, "GET", "/api/metrics", args.timeout)
+        device = {r["route"]: r for r in json.loads(body).get("routes", [])}
+    except (OSError, http.client.HTTPException, RuntimeError, ValueError) as e:
+        print("json_bench: %s" % e, file=sys.stderr)
+        return 1
+
+    report = {"host": args.host, "networks": args.networks, "runs": args.runs}
+    for name, path in ROUTES.items():
+        s = samples[name]
+        dev = device.get(path, {})
+        report[name] = {
+            "route": path,
+            "bytes": s[0][2],
+            "chunked": s[0][3],
+            "ttfb_ms": summarize([x[0] for x in s]),
+            "total_ms": summarize([x[1] for x in s]),
+            "device_p50_us": dev.get("p50_us"),
+            "peak_heap_avg": dev.get("peak_heap_avg"),
+            "peak_heap_max": dev.get("peak_heap_max"),
+        }
+    text = json.dumps(report, indent=2)
+    if args.out:
+        with open(args.out, "w") as f:
+            f.write(text + "\n")
+    else:
+        print(text)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,218 @@
+#!/usr/bin/env python3
+"""
+Dashboard page-load benchmark: bytes on the wire for a first vs a repeat visit.
+
+Loads "/" like a browser does - fetches the shell, then every stylesheet and
+script it references - over one keep-alive connection, and keeps a cache the
+way the response headers allow:
+
+  first load   empty cache: shell + all assets
+  repeat load  shell revalidated with If-None-Match (304 while unchanged);
+               assets cached as "immutable" are not requested at all, others
+               are revalidated
+
+Header bytes are reconstructed from the parsed response, so they match the
+wire within a few bytes.
+
+With --poll SECONDS it also keeps one tab "open" that long, once with the
+old polling (/api/sensors?since= every 3 s plus /api/wifi/status every
+5 s) and once with the current one (/api/snapshot every 3 s, revalidated
+with its ETag), and reports requests and bytes per minute for each.
+
+  python tools/page_bench.py --host 192.168.4.1 --runs 5 --out page.json
+  python tools/page_bench.py --runs 1 --poll 60
+"""
+
+import argparse
+import http.client
+import json
+import re
+import statistics
+import sys
+import time
+
+REF_RE = re.compile(r'(?:<link[^>]+href|<script[^>]+src)="(/[^"]+)"')
+
+
+def header_bytes(resp):
+    n = len("HTTP/1.1 %d %s\r\n" % (resp.status, resp.reason)) + 2
+    for k, v in resp.getheaders():
+        n += len(k) + 2 + len(v) + 2
+    return n
+
+
+class Browser:
+    def __init__(self, host, port, timeout):
+        self.host = host
+        self.port = port
+        self.timeout = timeout
+        self.conn = None
+        self.cache = {}   # path -> (etag, immutable, body)
+        self.last_body = b""
+
+    def get(self, path):
+        """Returns a dict describing the fetch (None if served from cache)."""
+        cached = self.cache.get(path)
+        if cached and cached[1]:
+            return None
+        headers = {}
+        if cached and cached[0]:
+            headers["If-None-Match"] = cached[0]
+        if self.conn is None:
+            self.conn = http.client.HTTPConnection(self.host, self.port, timeout=self.timeout)
+        t0 = time.perf_counter()
+        self.conn.request("GET", path, headers=headers)
+        resp = self.conn.getresponse()
+        body = resp.read()
+        ms = (time.perf_counter() - t0) * 1000.0
+        if resp.will_close:
+            self.conn.close()
+            self.conn = None
+        if resp.status not in (200, 304):
+            raise RuntimeError("GET %s -> %d" % (path, resp.status))
+        if resp.status == 200:
+            cc = resp.getheader("Cache-Control", "")
+            if "no-store" not in cc:
+                self.cache[path] = (resp.getheader("ETag"), "immutable" in cc, body)
+        elif resp.status == 304:
+            body = b""
+        self.last_body = body
+        return {"path": path, "status": resp.status, "header_bytes": header_bytes(resp),
+                "body_bytes": len(body), "ms": round(ms, 2)}
+
+    def load(self):
+        t0 = time.perf_counter()
+        fetches = [self.get("/")]
+        shell = self.cache["/"][2].decode("utf-8", "replace")
+        for ref in dict.fromkeys(REF_RE.findall(shell)):
+            fetches.append(self.get(ref))
+        total_ms = (time.perf_counter() - t0) * 1000.0
+        sent = [f for f in fetches if f]
+        return {
+            "requests": len(sent),
+            "from_cache": len(fetches) - len(sent),
+            "bytes": sum(f["header_bytes"] + f["body_bytes"] for f in sent),
+            "body_bytes": sum(f["body_bytes"] for f in sent),
+            "ms": round(total_ms, 2),
+            "fetches": sent,
+        }
+
+    def close(self):
+        if self.conn:
+            self.conn.close()
+
+
+# (path or callable -> path, period s) per polling stream of one open tab
+def legacy_streams():
+    state = {"seq": 0}
+
+    def sensors():
+        return "/api/sensors?since=%d" % state["seq"]
+
+    def on_sensors(body):
+        state["seq"] = json.loads(body)["seq"]
+
+    return [(sensors, 3.0, on_sensors), ("/api/wifi/status", 5.0, None)]
+
+
+def snapshot_streams():
+    return [("/api/snapshot", 3.0, None)]
+
+
+def poll(args, streams, seconds):
+    """Runs the tab's polling streams for `seconds`; returns per-minute rates."""
+    browser = Browser(args.host, args.port, args.timeout)
+    start = time.perf_counter()
+    due = [0.0] * len(streams)
+    fetches = []
+    while True:
+        now = time.perf_counter() - start
+        i = min(range(len(streams)), key=lambda k: due[k])
+        if due[i] >= seconds:
+            break
+        if due[i] > now:
+            time.sleep(due[i] - now)
+        path, period, on_body = streams[i]
+        f = browser.get(path() if callable(path) else path)
+        if f["status"] == 200 and on_body:
+            on_body(browser.last_body)
+        fetches.append(f)
+        due[i] += period
+    browser.close()
+    per_min = 60.0 / seconds
+    return {
+        "requests_per_min": round(len(fetches) * per_min, 1),
+        "not_modified_per_min": round(sum(f["status"] == 304 for f in fetches) * per_min, 1),
+        "bytes_per_min": round(sum(f["header_bytes"] + f["body_bytes"] for f in fetches) * per_min),
+        "avg_ms": round(statistics.mean(f["ms"] for f in fetches), 2) if fetches else 0,
+    }
+
+
+def summarize(vals):
+    return {"min": min(vals), "median": statistics.median(vals), "max": max(vals)}
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--host", default="192.168.4.1")
+    ap.add_argument("--port", type=int, default=80)
+    ap.add_argument("--runs", type=int, default=5, help="first+repeat load pairs")
+    ap.add_argument("--timeout", type=float, default=5.0)
+    ap.add_argument("--poll", type=float, default=0, metavar="SECONDS",
+                    help="also measure one open tab's polling, old vs snapshot")
+    ap.add_argument("--out", help="write JSON results here (default: stdout)")
+    args = ap.parse_args()
+
+    first, repeat = [], []
+    try:
+        for _ in range(args.runs):
+            browser = Browser(args.host, args.port, args.timeout)
+            first.append(browser.load())
+            repeat.append(browser.load())
+            browser.close()
+    except (OSError, http.client.HTTPException, RuntimeError) as e:
+        print("page_bench: %s" % e, file=sys.stderr)
+        return 1
+
+    report = {
+        "host": args.host,
+        "runs": args.runs,
+        "first_load": {
+            "requests": first[0]["requests"],
+            "bytes": first[0]["bytes"],
+            "ms": summarize([r["ms"] for r in first]),
+            "fetches": first[0]["fetches"],
+        },
+        "repeat_load": {
+            "requests": repeat[0]["requests"],
+            "from_cache": repeat[0]["from_cache"],
+            "bytes": repeat[0]["bytes"],
+            "ms": summarize([r["ms"] for r in repeat]),
+            "fetches": repeat[0]["fetches"],
+        },
+        "repeat_vs_first_bytes": round(repeat[0]["bytes"] / first[0]["bytes"], 4),
+    }
+    if args.poll > 0:
+        try:
+            legacy = poll(args, legacy_streams(), args.poll)
+            snapshot = poll(args, snapshot_streams(), args.poll)
+        except (OSError, http.client.HTTPException, RuntimeError) as e:
+            print("page_bench: %s" % e, file=sys.stderr)
+            return 1
+        report["polling"] = {
+            "seconds": args.poll,
+            "legacy": legacy,
+            "snapshot": snapshot,
+            "requests_saved_pct": round(100.0 * (1 - snapshot["requests_per_min"] / legacy["requests_per_min"]), 1),
+        }
+    text = json.dumps(report, indent=2)
+    if args.out:
+        with open(args.out, "w") as f:
+            f.write(text + "\n")
+    else:
+        print(text)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,83 @@
+# PlatformIO extra script: host-side custom targets.
+#
+#   pio run -t http_bench                       # default "api" scenario
+#   BENCH_ARGS="--scenario captive" pio run -t http_bench
+#   BENCH_HOST=192.168.1.50 pio run -t http_bench
+#   pio run -t dns_bench                        # captive DNS burst test
+#   pio run -t boot_bench                       # reboot timeline, 5 runs
+#   pio run -t page_bench                       # dashboard first vs repeat load bytes
+#   pio run -t json_bench                       # streamed vs document JSON (-DJSON_STREAM_BENCH)
+#   pio run -t broker_bench                     # local MQTT broker fan-out
+
+import os
+
+Import("env")  # noqa: F821  (injected by PlatformIO/SCons)
+
+bench_host = os.environ.get("BENCH_HOST", "192.168.4.1")
+bench_args = os.environ.get("BENCH_ARGS", "")
+
+env.AddCustomTarget(  # noqa: F821
+    name="http_bench",
+    dependencies=None,
+    actions=[
+        '"$PYTHONEXE" "$PROJECT_DIR/tools/http_bench.py" --host %s %s '
+        '--out "$BUILD_DIR/http_bench.json"' % (bench_host, bench_args),
+    ],
+    title="HTTP benchmark",
+    description="Load-test the device HTTP API and write http_bench.json",
+)
+
+env.AddCustomTarget(  # noqa: F821
+    name="dns_bench",
+    dependencies=None,
+    actions=[
+        '"$PYTHONEXE" "$PROJECT_DIR/tools/dns_bench.py" --server %s '
+        '--out "$BUILD_DIR/dns_bench.json"' % bench_host,
+    ],
+    title="DNS benchmark",
+    description="Burst-query the captive DNS responder and write dns_bench.json",
+)
+
+env.AddCustomTarget(  # noqa: F821
+    name="boot_bench",
+    dependencies=None,
+    actions=[
+        '"$PYTHONEXE" "$PROJECT_DIR/tools/boot_bench.py" --host %s %s '
+        '--out "$BUILD_DIR/boot_bench.json"' % (bench_host, bench_args),
+    ],
+    title="Boot benchmark",
+    description="Reboot the device repeatedly and write boot_bench.json",
+)
+
+env.AddCustomTarget(  # noqa: F821
+    name="page_bench",
+    dependencies=None,
+    actions=[
+        '"$PYTHONEXE" "$PROJECT_DIR/tools/page_bench.py" --host %s '
+        '--out "$BUILD_DIR/page_bench.json"' % bench_host,
+    ],
+    title="Page-load benchmark",
+    description="Measure dashboard first vs repeat load bytes and write page_bench.json",
+)
+
+env.AddCustomTarget(  # noqa: F821
+    name="json_bench",
+    dependencies=None,
+    actions=[
+        '"$PYTHONEXE" "$PROJECT_DIR/tools/json_bench.py" --host %s '
+        '--out "$BUILD_DIR/json_bench.json"' % bench_host,
+    ],
+    title="JSON streaming benchmark",
+    description="Compare streamed and document scan JSON and write json_bench.json",
+)
+
+env.AddCustomTarget(  # noqa: F821
+    name="broker_bench",
+    dependencies=None,
+    actions=[
+        '"$PYTHONEXE" "$PROJECT_DIR/tools/broker_bench.py" --host %s %s '
+        '--out "$BUILD_DIR/broker_bench.json"' % (bench_host, bench_args),
+    ],
+    title="Local broker benchmark",
+    description="Measure MQTT fan-out to local subscribers and write broker_bench.json",
+)
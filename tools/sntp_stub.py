@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+"""
+Stand-in SNTP server for exercising the firmware's time sync without the
+internet. Answers client requests with this machine's clock shifted by
+--offset-ms, after an optional artificial --delay-ms, so the offset and
+delay the device reports under `time` in /api/metrics can be checked
+against known values. --drift-ms adds that much to the offset on every
+request, which the device sees as the correction applied at each resync.
+
+Point the firmware at it with
+  build_flags = -DSNTP_SERVER_OVERRIDE=\\"<host ip>\\"
+and run
+  sudo python tools/sntp_stub.py --offset-ms 1500 --delay-ms 40
+"""
+
+import argparse
+import socket
+import struct
+import time
+
+NTP_UNIX_OFFSET = 2208988800
+
+
+def ntp_timestamp(t):
+    sec = int(t)
+    frac = int((t - sec) * (1 << 32)) & 0xFFFFFFFF
+    return ((sec + NTP_UNIX_OFFSET) & 0xFFFFFFFF) << 32 | frac
+
+
+def reply(req, rx, tx):
+    origin = req[40:48]                      # client's transmit timestamp
+    return struct.pack("!BBbbII4s", (0 << 6) | (4 << 3) | 4, 2, 4, -20, 0, 0, b"STUB") + \
+        struct.pack("!Q", ntp_timestamp(rx)) + origin + \
+        struct.pack("!QQ", ntp_timestamp(rx), ntp_timestamp(tx))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--bind", default="0.0.0.0")
+    ap.add_argument("--port", type=int, default=123)
+    ap.add_argument("--offset-ms", type=float, default=0.0, help="served time minus this host's clock")
+    ap.add_argument("--delay-ms", type=float, default=0.0, help="artificial network latency (split evenly)")
+    ap.add_argument("--drift-ms", type=float, default=0.0, help="added to the offset after every reply")
+    args = ap.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind((args.bind, args.port))
+    offset = args.offset_ms / 1000.0
+    print(f"SNTP stub on {args.bind}:{args.port}, offset {args.offset_ms} ms, delay {args.delay_ms} ms")
+    while True:
+        req, addr = sock.recvfrom(512)
+        if len(req) < 48 or req[0] & 7 != 3:
+            continue
+        time.sleep(args.delay_ms / 2000.0)   # request leg
+        rx = time.time() + offset
+        tx = time.time() + offset
+        time.sleep(args.delay_ms / 2000.0)   # reply leg
+        sock.sendto(reply(req, rx, tx), addr)
+        print(f"{addr[0]}: served {tx:.3f} (offset {offset * 1000:.1f} ms)")
+        offset += args.drift_ms / 1000.0
+
+
+if __name__ == "__main__":
+    main()
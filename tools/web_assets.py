@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+"""Build the dashboard route table (src/web_assets.h) from data/.
+
+data/index.html is the HTML shell; every local stylesheet/script it
+references (href="app.css", src="app.js") is embedded as its own asset under
+/assets/<name>.<hash>.<ext>, and the shell is rewritten to point at the
+hashed names. Asset URLs change whenever their content does, so the firmware
+serves them with an immutable Cache-Control and browsers only re-fetch the
+small shell (revalidated through its ETag).
+
+Runs as a PlatformIO pre-script (see platformio.ini) and rewrites the header
+only when its content changes, so unchanged assets do not trigger a rebuild.
+Can also be run by hand:
+
+  python tools/web_assets.py
+"""
+
+import hashlib
+import os
+import re
+import sys
+
+CONTENT_TYPES = {
+    ".html": "text/html",
+    ".css": "text/css",
+    ".js": "application/javascript",
+}
+
+REF_RE = re.compile(r'(<link[^>]+href|<script[^>]+src)="([^":/]+\.(?:css|js))"')
+DELIM = "asset"
+
+
+def content_hash(data):
+    return hashlib.sha256(data.encode("utf-8")).hexdigest()[:8]
+
+
+def c_ident(name):
+    return "web_" + re.sub(r"[^0-9A-Za-z]", "_", name)
+
+
+def build(data_dir):
+    with open(os.path.join(data_dir, "index.html"), encoding="utf-8") as f:
+        shell = f.read()
+
+    assets = []
+    names = {}
+    for name in dict.fromkeys(m.group(2) for m in REF_RE.finditer(shell)):
+        with open(os.path.join(data_dir, name), encoding="utf-8") as f:
+            body = f.read()
+        stem, ext = os.path.splitext(name)
+        path = "/assets/%s.%s%s" % (stem, content_hash(body), ext)
+        names[name] = path
+        assets.append((path, name, body, True))
+
+    shell = REF_RE.sub(lambda m: '%s="%s"' % (m.group(1), names[m.group(2)]), shell)
+    return [("/", "index.html", shell, False)] + assets
+
+
+def render(assets):
+    out = [
+        "// Generated by tools/web_assets.py from data/ - do not edit.",
+        "#ifndef WEB_ASSETS_H",
+        "#define WEB_ASSETS_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "struct WebAsset {",
+        "  const char* path;",
+        "  const char* contentType;",
+        "  const char* data;",
+        "  size_t      len;",
+        "  const char* etag;        // quoted content hash",
+        "  bool        immutable;   // hashed URL: cache forever",
+        "};",
+        "",
+    ]
+    for _, name, body, _ in assets:
+        if ")%s\"" % DELIM in body:
+            sys.exit("web_assets: %s contains the raw string delimiter" % name)
+        out.append('static const char %s[] PROGMEM = R"%s(%s)%s";'
+                   % (c_ident(name), DELIM, body, DELIM))
+        out.append("")
+
+    out.append("// Route table; WEB_ASSETS[0] is the dashboard shell at \"/\"")
+    out.append("static const WebAsset WEB_ASSETS[] = {")
+    for path, name, body, immutable in assets:
+        ctype = CONTENT_TYPES[os.path.splitext(name)[1]]
+        ident = c_ident(name)
+        out.append('  { "%s", "%s", %s, sizeof(%s) - 1, "\\"%s\\"", %s },'
+                   % (path, ctype, ident, ident, content_hash(body),
+                      "true" if immutable else "false"))
+    out.append("};")
+    out.append("#define WEB_ASSET_COUNT (sizeof(WEB_ASSETS) / sizeof(WEB_ASSETS[0]))")
+    out.append("")
+    out.append("#endif // WEB_ASSETS_H")
+    return "\n".join(out) + "\n"
+
+
+def generate(project_dir):
+    assets = build(os.path.join(project_dir, "data"))
+    text = render(assets)
+    target = os.path.join(project_dir, "src", "web_assets.h")
+    try:
+        with open(target, encoding="utf-8") as f:
+            if f.read() == text:
+                return assets, False
+    except FileNotFoundError:
+        pass
+    with open(target, "w", encoding="utf-8", newline="\n") as f:
+        f.write(text)
+    return assets, True
+
+
+def report(assets, changed):
+    for path, name, body, _ in assets:
+        print("web_assets: %-32s %6d bytes  (%s)" % (path, len(body.encode("utf-8")), name))
+    print("web_assets: src/web_assets.h %s" % ("updated" if changed else "unchanged"))
+
+
+try:
+    Import("env")  # noqa: F821  (injected by PlatformIO/SCons)
+    report(*generate(env.subst("$PROJECT_DIR")))  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        report(*generate(os.path.dirname(os.path.dirname(os.path.abspath(__file__)))))